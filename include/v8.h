@@ -1146,6 +1146,15 @@ class V8_EXPORT ScriptCompiler {
     bool rejected;
     BufferPolicy buffer_policy;
 
+    /**
+     * Whether a VerifyCachedDataTask has checked the payload checksum of the
+     * current data. Consuming the cache then skips that check, as long as the
+     * checksum in the header is still the one that was verified. Changes to
+     * the payload alone are not detected, so the buffer must not be modified
+     * between verification and consumption.
+     */
+    bool checksum_verified() const;
+
    private:
     // Prevent copying. Not implemented.
     CachedData(const CachedData&);
@@ -1171,6 +1180,7 @@ class V8_EXPORT ScriptCompiler {
 
    private:
     friend class ScriptCompiler;
+    friend class SnapshotCreator;
     // Prevent copying. Not implemented.
     Source(const Source&);
     Source& operator=(const Source&);
@@ -1274,6 +1284,17 @@ class V8_EXPORT ScriptCompiler {
     virtual void Run() = 0;
   };
 
+  /**
+   * A task which the embedder may run on a background thread to verify the
+   * integrity of a code cache before it is consumed. Returned by
+   * ScriptCompiler::StartVerifyingCachedData.
+   */
+  class VerifyCachedDataTask {
+   public:
+    virtual ~VerifyCachedDataTask() {}
+    virtual void Run() = 0;
+  };
+
   enum CompileOptions {
     kNoCompileOptions = 0,
     kProduceParserCache,
@@ -1337,6 +1358,17 @@ class V8_EXPORT ScriptCompiler {
       Isolate* isolate, StreamedSource* source,
       CompileOptions options = kNoCompileOptions);
 
+  /**
+   * Returns a task which verifies the checksum of a code cache produced with
+   * kProduceCodeCache. The embedder runs the task on a background thread and
+   * then passes the cached data to Compile with kConsumeCodeCache, which no
+   * longer has to checksum the whole payload on the main thread. The cached
+   * data must stay alive and unmodified until it has been consumed; the
+   * caller owns the returned task.
+   */
+  static VerifyCachedDataTask* StartVerifyingCachedData(
+      CachedData* cached_data);
+
   /**
    * Compiles a streamed script (bound to current context).
    *
@@ -1373,6 +1405,21 @@ class V8_EXPORT ScriptCompiler {
    */
   static uint32_t CachedDataVersionTag();
 
+  /**
+   * Creates a code cache for a script that has already been compiled, and
+   * possibly run. Unlike kProduceCodeCache, the cache also contains functions
+   * that have been compiled lazily since, so it can be regenerated once the
+   * script has warmed up. The result is consumed with kConsumeCodeCache.
+   *
+   * If |max_size| is positive, functions that would push the cache beyond
+   * roughly that many bytes are left to be compiled lazily.
+   *
+   * Returns NULL if the script cannot be serialized, e.g. while it is being
+   * debugged. The caller owns the returned CachedData.
+   */
+  static CachedData* CreateCodeCache(Local<UnboundScript> unbound_script,
+                                     int max_size = 0);
+
   /**
    * Compile an ES6 module.
    *
@@ -6474,6 +6521,16 @@ class V8_EXPORT V8 {
   static void SetNativesDataBlob(StartupData* startup_blob);
   static void SetSnapshotDataBlob(StartupData* startup_blob);
 
+  /**
+   * Returns whether the checksum of the default startup snapshot matches its
+   * contents. The checksum is verified at most once per process, on a
+   * background thread, so that it does not delay isolate creation. With
+   * --verify-snapshot-checksum the verification starts when the first isolate
+   * is created. This call waits for the verification to complete and must be
+   * made after V8::Initialize.
+   */
+  static bool VerifySnapshotChecksum();
+
   /**
    * Bootstrap an isolate and a context from scratch to create a startup
    * snapshot. Include the side-effects of running the optional script.
@@ -6808,7 +6865,17 @@ class V8_EXPORT V8 {
  */
 class SnapshotCreator {
  public:
-  enum class FunctionCodeHandling { kClear, kKeep };
+  /**
+   * kClear drops compiled function code from the snapshot, kKeep includes it.
+   * kKeepWithTypeFeedback additionally preserves the type feedback collected
+   * by functions in the snapshotted contexts (call targets, call counts and
+   * allocation sites), so that code running in a context deserialized from
+   * the snapshot does not have to relearn it. Property access ICs, which
+   * refer to context-specific handler code, are still cleared. Garbage
+   * collections before CreateBlob clear type feedback as with the other
+   * modes.
+   */
+  enum class FunctionCodeHandling { kClear, kKeep, kKeepWithTypeFeedback };
 
   /**
    * Create and enter an isolate, and set it up for serialization.
@@ -6840,11 +6907,26 @@ class SnapshotCreator {
    */
   size_t AddTemplate(Local<Template> template_obj);
 
+  /**
+   * Compile a script for the snapshot with all of its functions compiled
+   * eagerly, rather than on first call. Once the script has been run in a
+   * context added to the snapshot, a blob created with
+   * FunctionCodeHandling::kKeep contains the compiled code of its functions,
+   * so that contexts deserialized from it need no compile work.
+   * \param cold_functions names of functions, e.g. collected by a profile,
+   *        that are left to be compiled lazily on their first call. Anonymous
+   *        functions are always compiled eagerly.
+   * \returns the compiled script, or an empty handle if compilation failed.
+   */
+  MaybeLocal<UnboundScript> CompileEagerly(
+      ScriptCompiler::Source* source, int cold_function_count = 0,
+      const char** cold_functions = nullptr);
+
   /**
    * Created a snapshot data blob.
    * This must not be called from within a handle scope.
    * \param function_code_handling whether to include compiled function code
-   *        in the snapshot.
+   *        and type feedback in the snapshot.
    * \returns { nullptr, 0 } on failure, and a startup snapshot on success. The
    *        caller acquires ownership of the data array in the return value.
    */
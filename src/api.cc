@@ -58,6 +58,7 @@
 #include "src/runtime-profiler.h"
 #include "src/runtime/runtime.h"
 #include "src/simulator.h"
+#include "src/snapshot/code-serializer.h"
 #include "src/snapshot/natives.h"
 #include "src/snapshot/snapshot.h"
 #include "src/startup-data-util.h"
@@ -344,6 +345,11 @@ void V8::SetSnapshotDataBlob(StartupData* snapshot_blob) {
   i::V8::SetSnapshotBlob(snapshot_blob);
 }
 
+
+bool V8::VerifySnapshotChecksum() {
+  return i::Snapshot::DefaultChecksumIsValid();
+}
+
 namespace {
 
 class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
@@ -457,6 +463,47 @@ size_t SnapshotCreator::AddTemplate(Local<Template> template_obj) {
   return index;
 }
 
+MaybeLocal<UnboundScript> SnapshotCreator::CompileEagerly(
+    ScriptCompiler::Source* source, int cold_function_count,
+    const char** cold_functions) {
+  SnapshotCreatorData* data = SnapshotCreatorData::cast(data_);
+  DCHECK(!data->created_);
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(data->isolate_);
+  PREPARE_FOR_EXECUTION_WITH_ISOLATE(isolate, SnapshotCreator, CompileEagerly,
+                                     UnboundScript);
+  i::Handle<i::FixedArray> cold_names =
+      isolate->factory()->NewFixedArray(cold_function_count);
+  for (int i = 0; i < cold_function_count; i++) {
+    cold_names->set(
+        i, *isolate->factory()->InternalizeUtf8String(cold_functions[i]));
+  }
+
+  i::Handle<i::String> str = Utils::OpenHandle(*(source->source_string));
+  i::Handle<i::Object> name_obj;
+  i::Handle<i::Object> source_map_url;
+  int line_offset = 0;
+  int column_offset = 0;
+  if (!source->resource_name.IsEmpty()) {
+    name_obj = Utils::OpenHandle(*(source->resource_name));
+  }
+  if (!source->resource_line_offset.IsEmpty()) {
+    line_offset = static_cast<int>(source->resource_line_offset->Value());
+  }
+  if (!source->resource_column_offset.IsEmpty()) {
+    column_offset = static_cast<int>(source->resource_column_offset->Value());
+  }
+  if (!source->source_map_url.IsEmpty()) {
+    source_map_url = Utils::OpenHandle(*(source->source_map_url));
+  }
+  i::Handle<i::SharedFunctionInfo> result =
+      i::Compiler::GetSharedFunctionInfoForEagerScript(
+          str, name_obj, line_offset, column_offset, source->resource_options,
+          source_map_url, isolate->native_context(), cold_names);
+  has_pending_exception = result.is_null();
+  RETURN_ON_FAILED_EXECUTION(UnboundScript);
+  RETURN_ESCAPED(ToApiHandle<UnboundScript>(result));
+}
+
 StartupData SnapshotCreator::CreateBlob(
     SnapshotCreator::FunctionCodeHandling function_code_handling) {
   SnapshotCreatorData* data = SnapshotCreatorData::cast(data_);
@@ -475,6 +522,10 @@ StartupData SnapshotCreator::CreateBlob(
     data->templates_.Clear();
   }
 
+  isolate->set_serializer_keeps_type_feedback(
+      function_code_handling ==
+      SnapshotCreator::FunctionCodeHandling::kKeepWithTypeFeedback);
+
   // If we don't do this then we end up with a stray root pointing at the
   // context even after we have disposed of the context.
   isolate->heap()->CollectAllAvailableGarbage("mksnapshot");
@@ -1748,12 +1799,18 @@ ScriptCompiler::CachedData::CachedData(const uint8_t* data_, int length_,
 
 
 ScriptCompiler::CachedData::~CachedData() {
+  i::VerifyCachedDataTask::Forget(this);
   if (buffer_policy == BufferOwned) {
     delete[] data;
   }
 }
 
 
+bool ScriptCompiler::CachedData::checksum_verified() const {
+  return i::VerifyCachedDataTask::IsVerified(this);
+}
+
+
 bool ScriptCompiler::ExternalSourceStream::SetBookmark() { return false; }
 
 
@@ -1911,6 +1968,11 @@ MaybeLocal<UnboundScript> ScriptCompiler::CompileUnboundInternal(
     // ScriptData takes care of pointer-aligning the data.
     script_data = new i::ScriptData(source->cached_data->data,
                                     source->cached_data->length);
+    uint32_t checksum1, checksum2;
+    if (i::VerifyCachedDataTask::GetVerifiedChecksum(source->cached_data,
+                                                     &checksum1, &checksum2)) {
+      script_data->MarkChecksumVerified(checksum1, checksum2);
+    }
   }
 
   i::Handle<i::String> str = Utils::OpenHandle(*(source->source_string));
@@ -2167,6 +2229,12 @@ ScriptCompiler::ScriptStreamingTask* ScriptCompiler::StartStreamingScript(
 }
 
 
+ScriptCompiler::VerifyCachedDataTask* ScriptCompiler::StartVerifyingCachedData(
+    CachedData* cached_data) {
+  return new i::VerifyCachedDataTask(cached_data);
+}
+
+
 MaybeLocal<Script> ScriptCompiler::Compile(Local<Context> context,
                                            StreamedSource* v8_source,
                                            Local<String> full_source_string,
@@ -2238,6 +2306,36 @@ uint32_t ScriptCompiler::CachedDataVersionTag() {
 }
 
 
+ScriptCompiler::CachedData* ScriptCompiler::CreateCodeCache(
+    Local<UnboundScript> unbound_script, int max_size) {
+  i::Handle<i::SharedFunctionInfo> shared =
+      i::Handle<i::SharedFunctionInfo>::cast(
+          Utils::OpenHandle(*unbound_script));
+  i::Isolate* isolate = shared->GetIsolate();
+  i::HandleScope scope(isolate);
+  if (!i::FLAG_serialize_toplevel || isolate->debug()->is_active()) {
+    return NULL;
+  }
+  DCHECK(shared->is_toplevel());
+  i::Handle<i::Script> script(i::Script::cast(shared->script()));
+  if (!script->source()->IsString() || !shared->is_compiled()) return NULL;
+  // Full code for the top-level function has to be compiled for serializing.
+  i::Code* code = shared->code();
+  if (code->kind() == i::Code::FUNCTION &&
+      !code->has_reloc_info_for_serialization()) {
+    return NULL;
+  }
+  i::Handle<i::String> source(i::String::cast(script->source()));
+  i::ScriptData* script_data =
+      i::CodeSerializer::Serialize(isolate, shared, source, max_size);
+  CachedData* result = new CachedData(
+      script_data->data(), script_data->length(), CachedData::BufferOwned);
+  script_data->ReleaseDataOwnership();
+  delete script_data;
+  return result;
+}
+
+
 MaybeLocal<Script> Script::Compile(Local<Context> context, Local<String> source,
                                    ScriptOrigin* origin) {
   if (origin) {
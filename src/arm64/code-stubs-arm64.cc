@@ -1461,6 +1461,13 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   __ TailCallRuntime(Runtime::kRegExpExec);
 #else  // V8_INTERPRETED_REGEXP
 
+  // With the exec cache, the runtime looks up the cached result before it
+  // runs the native code.
+  if (use_exec_cache()) {
+    __ TailCallRuntime(Runtime::kRegExpExec);
+    return;
+  }
+
   // Stack frame on entry.
   //  jssp[0]: last_match_info (expected JSArray)
   //  jssp[8]: previous index
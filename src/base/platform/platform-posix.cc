@@ -134,6 +134,17 @@ void OS::Guard(void* address, const size_t size) {
 }
 
 
+void OS::PrefetchPages(const void* address, const size_t size) {
+#if defined(POSIX_MADV_WILLNEED)
+  uintptr_t page_size = static_cast<uintptr_t>(CommitPageSize());
+  uintptr_t start = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+  uintptr_t end = reinterpret_cast<uintptr_t>(address) + size;
+  posix_madvise(reinterpret_cast<void*>(start), end - start,
+                POSIX_MADV_WILLNEED);
+#endif
+}
+
+
 static LazyInstance<RandomNumberGenerator>::type
     platform_random_number_generator = LAZY_INSTANCE_INITIALIZER;
 
@@ -288,14 +299,16 @@ class PosixMemoryMappedFile final : public OS::MemoryMappedFile {
 
 
 // static
-OS::MemoryMappedFile* OS::MemoryMappedFile::open(const char* name) {
-  if (FILE* file = fopen(name, "r+")) {
+OS::MemoryMappedFile* OS::MemoryMappedFile::open(const char* name,
+                                                 FileMode mode) {
+  const bool read_only = mode == FileMode::kReadOnly;
+  if (FILE* file = fopen(name, read_only ? "r" : "r+")) {
     if (fseek(file, 0, SEEK_END) == 0) {
       long size = ftell(file);  // NOLINT(runtime/int)
       if (size >= 0) {
-        void* const memory =
-            mmap(OS::GetRandomMmapAddr(), size, PROT_READ | PROT_WRITE,
-                 MAP_SHARED, fileno(file), 0);
+        int prot = read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* const memory = mmap(OS::GetRandomMmapAddr(), size, prot,
+                                  MAP_SHARED, fileno(file), 0);
         if (memory != MAP_FAILED) {
           return new PosixMemoryMappedFile(file, memory, size);
         }
@@ -187,6 +187,10 @@ class OS {
   // Assign memory as a guard page so that access will cause an exception.
   static void Guard(void* address, const size_t size);
 
+  // Hints that the pages of a memory region will be read soon, so that the
+  // OS can start reading them in from disk. Does not block.
+  static void PrefetchPages(const void* address, const size_t size);
+
   // Generate a random address to be used for hinting mmap().
   static void* GetRandomMmapAddr();
 
@@ -213,11 +217,16 @@ class OS {
 
   class MemoryMappedFile {
    public:
+    // A read-only mapping is backed directly by the page cache and can be
+    // shared by every process that maps the same file.
+    enum class FileMode { kReadOnly, kReadWrite };
+
     virtual ~MemoryMappedFile() {}
     virtual void* memory() const = 0;
     virtual size_t size() const = 0;
 
-    static MemoryMappedFile* open(const char* name);
+    static MemoryMappedFile* open(const char* name,
+                                  FileMode mode = FileMode::kReadWrite);
     static MemoryMappedFile* create(const char* name, size_t size,
                                     void* initial);
   };
@@ -2091,10 +2091,19 @@ class JSEntryStub : public PlatformCodeStub {
 
 class RegExpExecStub: public PlatformCodeStub {
  public:
-  explicit RegExpExecStub(Isolate* isolate) : PlatformCodeStub(isolate) { }
+  explicit RegExpExecStub(Isolate* isolate) : PlatformCodeStub(isolate) {
+    minor_key_ = UseExecCacheBits::encode(FLAG_regexp_exec_cache);
+  }
 
   DEFINE_ON_STACK_CALL_INTERFACE_DESCRIPTOR(4);
   DEFINE_PLATFORM_CODE_STUB(RegExpExec, PlatformCodeStub);
+
+ private:
+  // The exec cache is looked up in the runtime, so with the cache enabled the
+  // stub always calls the runtime.
+  bool use_exec_cache() const { return UseExecCacheBits::decode(minor_key_); }
+
+  class UseExecCacheBits : public BitField<bool, 0, 1> {};
 };
 
 
@@ -4,10 +4,17 @@
 
 #include "src/compilation-cache.h"
 
+#include <list>
+#include <vector>
+
 #include "src/assembler.h"
+#include "src/base/functional.h"
+#include "src/base/lazy-instance.h"
+#include "src/base/platform/mutex.h"
 #include "src/counters.h"
 #include "src/factory.h"
 #include "src/objects-inl.h"
+#include "src/snapshot/code-serializer.h"
 
 namespace v8 {
 namespace internal {
@@ -402,5 +409,282 @@ void CompilationCache::Disable() {
 }
 
 
+namespace {
+
+Vector<const byte> RawCharacters(const String::FlatContent& content) {
+  if (content.IsOneByte()) return content.ToOneByteVector();
+  Vector<const uc16> chars = content.ToUC16Vector();
+  return Vector<const byte>(reinterpret_cast<const byte*>(chars.start()),
+                            chars.length() * sizeof(uc16));
+}
+
+// Unlike String::Hash, which uses the hash seed of the isolate, this hashes
+// the characters with a fixed seed, so that all isolates agree on it.
+uint32_t HashCharacters(String* string) {
+  DisallowHeapAllocation no_gc;
+  String::FlatContent content = string->GetFlatContent();
+  DCHECK(content.IsFlat());
+  if (content.IsOneByte()) {
+    Vector<const uint8_t> chars = content.ToOneByteVector();
+    return StringHasher::HashSequentialString(chars.start(), chars.length(),
+                                              kZeroHashSeed);
+  }
+  Vector<const uc16> chars = content.ToUC16Vector();
+  return StringHasher::HashSequentialString(chars.start(), chars.length(),
+                                            kZeroHashSeed);
+}
+
+// Copy of the characters of a flat string, so that cache entries can be
+// matched without referring to the heap of any isolate.
+class FlatStringCopy {
+ public:
+  FlatStringCopy() : is_one_byte_(true) {}
+
+  explicit FlatStringCopy(String* string) {
+    DisallowHeapAllocation no_gc;
+    String::FlatContent content = string->GetFlatContent();
+    DCHECK(content.IsFlat());
+    is_one_byte_ = content.IsOneByte();
+    Vector<const byte> chars = RawCharacters(content);
+    chars_.assign(chars.start(), chars.end());
+  }
+
+  bool Matches(String* string) const {
+    DisallowHeapAllocation no_gc;
+    String::FlatContent content = string->GetFlatContent();
+    if (!content.IsFlat() || content.IsOneByte() != is_one_byte_) {
+      return false;
+    }
+    Vector<const byte> chars = RawCharacters(content);
+    return static_cast<size_t>(chars.length()) == chars_.size() &&
+           memcmp(chars.start(), chars_.data(), chars_.size()) == 0;
+  }
+
+  size_t size() const { return chars_.size(); }
+
+ private:
+  bool is_one_byte_;
+  std::vector<byte> chars_;
+};
+
+struct SharedScriptEntry {
+  uint32_t hash;
+  FlatStringCopy source;
+  // Scripts without a name match regardless of their offsets and options,
+  // as in CompilationCacheScript::HasOrigin.
+  bool has_name;
+  FlatStringCopy name;
+  bool has_source_map_url;
+  FlatStringCopy source_map_url;
+  int line_offset;
+  int column_offset;
+  int origin_flags;
+  LanguageMode language_mode;
+  std::vector<byte> data;
+
+  size_t Size() const {
+    return sizeof(*this) + source.size() + name.size() +
+           source_map_url.size() + data.size();
+  }
+};
+
+typedef std::list<SharedScriptEntry> SharedScriptList;
+
+base::LazyMutex shared_scripts_mutex = LAZY_MUTEX_INITIALIZER;
+// Most recently used entries come first.
+base::LazyInstance<SharedScriptList>::type shared_scripts =
+    LAZY_INSTANCE_INITIALIZER;
+size_t shared_scripts_size = 0;
+
+// Describes the script to look up or add. Strings are flat.
+class SharedScriptKey {
+ public:
+  SharedScriptKey(String* source, String* name, int line_offset,
+                  int column_offset, ScriptOriginOptions resource_options,
+                  String* source_map_url, LanguageMode language_mode)
+      : source_(source),
+        name_(name),
+        source_map_url_(source_map_url),
+        line_offset_(name == NULL ? 0 : line_offset),
+        column_offset_(name == NULL ? 0 : column_offset),
+        origin_flags_(name == NULL ? 0 : resource_options.Flags()),
+        language_mode_(language_mode) {
+    // Entries produced under different flags would be rejected anyway.
+    hash_ = static_cast<uint32_t>(
+        base::hash_combine(HashCharacters(source), line_offset_,
+                           column_offset_, origin_flags_,
+                           static_cast<int>(language_mode), FlagList::Hash()));
+  }
+
+  bool Matches(const SharedScriptEntry& entry) const {
+    if (entry.hash != hash_ || entry.has_name != (name_ != NULL)) return false;
+    if (entry.has_source_map_url != (source_map_url_ != NULL)) return false;
+    if (entry.line_offset != line_offset_ ||
+        entry.column_offset != column_offset_ ||
+        entry.origin_flags != origin_flags_ ||
+        entry.language_mode != language_mode_) {
+      return false;
+    }
+    if (name_ != NULL && !entry.name.Matches(name_)) return false;
+    if (source_map_url_ != NULL &&
+        !entry.source_map_url.Matches(source_map_url_)) {
+      return false;
+    }
+    return entry.source.Matches(source_);
+  }
+
+  void Initialize(SharedScriptEntry* entry) const {
+    entry->hash = hash_;
+    entry->source = FlatStringCopy(source_);
+    entry->has_name = name_ != NULL;
+    if (name_ != NULL) entry->name = FlatStringCopy(name_);
+    entry->has_source_map_url = source_map_url_ != NULL;
+    if (source_map_url_ != NULL) {
+      entry->source_map_url = FlatStringCopy(source_map_url_);
+    }
+    entry->line_offset = line_offset_;
+    entry->column_offset = column_offset_;
+    entry->origin_flags = origin_flags_;
+    entry->language_mode = language_mode_;
+  }
+
+ private:
+  String* source_;
+  String* name_;
+  String* source_map_url_;
+  int line_offset_;
+  int column_offset_;
+  int origin_flags_;
+  LanguageMode language_mode_;
+  uint32_t hash_;
+};
+
+// Flattens the optional script name and source map URL of a key. Returns
+// false if one of them is not a string, in which case the script is not
+// shared.
+bool FlattenKeyStrings(Handle<Object> name, Handle<Object> source_map_url,
+                       Handle<String>* name_string,
+                       Handle<String>* source_map_url_string) {
+  if (!name.is_null()) {
+    if (!name->IsString()) return false;
+    *name_string = String::Flatten(Handle<String>::cast(name));
+  }
+  if (!source_map_url.is_null()) {
+    if (!source_map_url->IsString()) return false;
+    *source_map_url_string =
+        String::Flatten(Handle<String>::cast(source_map_url));
+  }
+  return true;
+}
+
+}  // namespace
+
+
+MaybeHandle<SharedFunctionInfo> SharedCompilationCache::LookupScript(
+    Isolate* isolate, Handle<String> source, Handle<Object> name,
+    int line_offset, int column_offset, ScriptOriginOptions resource_options,
+    Handle<Object> source_map_url, LanguageMode language_mode) {
+  Handle<String> name_string;
+  Handle<String> source_map_url_string;
+  if (!FlattenKeyStrings(name, source_map_url, &name_string,
+                         &source_map_url_string)) {
+    return MaybeHandle<SharedFunctionInfo>();
+  }
+  source = String::Flatten(source);
+
+  ScriptData* cached_data = NULL;
+  {
+    DisallowHeapAllocation no_gc;
+    SharedScriptKey key(
+        *source, name_string.is_null() ? NULL : *name_string, line_offset,
+        column_offset, resource_options,
+        source_map_url_string.is_null() ? NULL : *source_map_url_string,
+        language_mode);
+    base::LockGuard<base::Mutex> lock_guard(shared_scripts_mutex.Pointer());
+    SharedScriptList* scripts = shared_scripts.Pointer();
+    for (auto it = scripts->begin(); it != scripts->end(); ++it) {
+      if (!key.Matches(*it)) continue;
+      scripts->splice(scripts->begin(), *scripts, it);
+      int length = static_cast<int>(it->data.size());
+      byte* data = NewArray<byte>(length);
+      CopyBytes(data, it->data.data(), it->data.size());
+      cached_data = new ScriptData(data, length);
+      cached_data->AcquireDataOwnership();
+      break;
+    }
+  }
+
+  if (cached_data == NULL) {
+    isolate->counters()->shared_compilation_cache_misses()->Increment();
+    return MaybeHandle<SharedFunctionInfo>();
+  }
+  MaybeHandle<SharedFunctionInfo> result =
+      CodeSerializer::Deserialize(isolate, cached_data, source);
+  delete cached_data;
+  if (result.is_null()) {
+    isolate->counters()->shared_compilation_cache_misses()->Increment();
+  } else {
+    isolate->counters()->shared_compilation_cache_hits()->Increment();
+  }
+  return result;
+}
+
+
+void SharedCompilationCache::PutScript(
+    Handle<String> source, Handle<Object> name, int line_offset,
+    int column_offset, ScriptOriginOptions resource_options,
+    Handle<Object> source_map_url, LanguageMode language_mode,
+    const ScriptData* cached_data) {
+  Handle<String> name_string;
+  Handle<String> source_map_url_string;
+  if (!FlattenKeyStrings(name, source_map_url, &name_string,
+                         &source_map_url_string)) {
+    return;
+  }
+  source = String::Flatten(source);
+
+  DisallowHeapAllocation no_gc;
+  SharedScriptKey key(
+      *source, name_string.is_null() ? NULL : *name_string, line_offset,
+      column_offset, resource_options,
+      source_map_url_string.is_null() ? NULL : *source_map_url_string,
+      language_mode);
+  SharedScriptEntry entry;
+  key.Initialize(&entry);
+  entry.data.assign(cached_data->data(),
+                    cached_data->data() + cached_data->length());
+  size_t budget = static_cast<size_t>(FLAG_shared_compilation_cache_size) * KB;
+  size_t size = entry.Size();
+  if (size > budget) return;
+
+  base::LockGuard<base::Mutex> lock_guard(shared_scripts_mutex.Pointer());
+  SharedScriptList* scripts = shared_scripts.Pointer();
+  for (auto it = scripts->begin(); it != scripts->end(); ++it) {
+    if (!key.Matches(*it)) continue;
+    shared_scripts_size -= it->Size();
+    scripts->erase(it);
+    break;
+  }
+  scripts->push_front(std::move(entry));
+  shared_scripts_size += size;
+  while (shared_scripts_size > budget) {
+    shared_scripts_size -= scripts->back().Size();
+    scripts->pop_back();
+  }
+}
+
+
+size_t SharedCompilationCache::Size() {
+  base::LockGuard<base::Mutex> lock_guard(shared_scripts_mutex.Pointer());
+  return shared_scripts_size;
+}
+
+
+void SharedCompilationCache::Clear() {
+  base::LockGuard<base::Mutex> lock_guard(shared_scripts_mutex.Pointer());
+  shared_scripts.Pointer()->clear();
+  shared_scripts_size = 0;
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -12,6 +12,8 @@
 namespace v8 {
 namespace internal {
 
+class ScriptData;
+
 // The compilation cache consists of several generational sub-caches which uses
 // this class as a base class. A sub-cache contains a compilation cache tables
 // for each generation of the sub-cache. Since the same source code string has
@@ -236,6 +238,42 @@ class CompilationCache {
 };
 
 
+// Process-wide cache of serialized top-level script code, shared by all
+// isolates. A hit is materialized in the requesting isolate by the code
+// deserializer, so that the script is neither parsed nor compiled again.
+// Entries are kept in least recently used order and the oldest are evicted
+// once the total size exceeds --shared-compilation-cache-size.
+class SharedCompilationCache : public AllStatic {
+ public:
+  static bool IsEnabled() {
+    return FLAG_compilation_cache && FLAG_serialize_toplevel &&
+           FLAG_shared_compilation_cache_size > 0;
+  }
+
+  // Finds the script for the given source and origin and deserializes it
+  // into |isolate|.
+  static MaybeHandle<SharedFunctionInfo> LookupScript(
+      Isolate* isolate, Handle<String> source, Handle<Object> name,
+      int line_offset, int column_offset, ScriptOriginOptions resource_options,
+      Handle<Object> source_map_url, LanguageMode language_mode);
+
+  // Adds a copy of |cached_data|, which the code serializer produced for the
+  // given source and origin. This may overwrite an existing entry.
+  static void PutScript(Handle<String> source, Handle<Object> name,
+                        int line_offset, int column_offset,
+                        ScriptOriginOptions resource_options,
+                        Handle<Object> source_map_url,
+                        LanguageMode language_mode,
+                        const ScriptData* cached_data);
+
+  // Total size in bytes accounted to the cache entries, including the copies
+  // of source strings and script names needed to match them.
+  static size_t Size();
+
+  static void Clear();
+};
+
+
 }  // namespace internal
 }  // namespace v8
 
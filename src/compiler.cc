@@ -226,6 +226,17 @@ bool CompilationInfo::ExpectsJSReceiverAsReceiver() {
   return is_sloppy(parse_info()->language_mode()) && !parse_info()->is_native();
 }
 
+bool CompilationInfo::IsColdFunction(Handle<String> name) const {
+  DCHECK(is_eager_compile());
+  // Anonymous functions cannot be told apart by name, so they are never cold.
+  if (name->length() == 0) return false;
+  // Both the function names and the cold function names are internalized.
+  for (int i = 0; i < cold_functions_->length(); i++) {
+    if (cold_functions_->get(i) == *name) return true;
+  }
+  return false;
+}
+
 #if DEBUG
 void CompilationInfo::PrintAstForTesting() {
   PrintF("--- Source from AST ---\n%s\n",
@@ -993,6 +1004,12 @@ MaybeHandle<Code> GetLazyCode(Handle<JSFunction> function) {
   Zone zone(isolate->allocator());
   ParseInfo parse_info(&zone, function);
   CompilationInfo info(&parse_info, function);
+  // Keep functions compiled after the script itself eligible for a code cache
+  // that is regenerated later, see ScriptCompiler::CreateCodeCache.
+  Object* script = function->shared()->script();
+  if (script->IsScript() && Script::cast(script)->compiled_for_code_cache()) {
+    info.PrepareForSerializing();
+  }
   Handle<Code> result;
   ASSIGN_RETURN_ON_EXCEPTION(isolate, result, GetUnoptimizedCode(&info), Code);
 
@@ -1057,6 +1074,9 @@ Handle<SharedFunctionInfo> CompileToplevel(CompilationInfo* info) {
       // Consider parsing eagerly when targeting the code cache.
       parse_allow_lazy &= !(FLAG_serialize_eager && info->will_serialize());
 
+      // Inner functions are compiled eagerly, so they need a full parse.
+      parse_allow_lazy &= !info->is_eager_compile();
+
       // Consider parsing eagerly when targeting Ignition.
       parse_allow_lazy &= !(FLAG_ignition && FLAG_ignition_eager &&
                             !isolate->serializer_enabled());
@@ -1503,6 +1523,28 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForScript(
     }
   }
 
+  // Scripts compiled by other isolates are shared as serialized code.
+  bool use_shared_cache =
+      SharedCompilationCache::IsEnabled() && extension == NULL &&
+      natives == NOT_NATIVES_CODE && !is_module &&
+      !isolate->debug()->is_loaded() &&
+      compile_options != ScriptCompiler::kProduceParserCache &&
+      compile_options != ScriptCompiler::kProduceCodeCache;
+  if (use_shared_cache && maybe_result.is_null()) {
+    HistogramTimerScope timer(isolate->counters()->compile_deserialize());
+    RuntimeCallTimerScope runtimeTimer(isolate,
+                                       &RuntimeCallStats::CompileDeserialize);
+    TRACE_EVENT0("v8", "V8.CompileDeserialize");
+    if (SharedCompilationCache::LookupScript(
+            isolate, source, script_name, line_offset, column_offset,
+            resource_options, source_map_url, language_mode)
+            .ToHandle(&result)) {
+      // Promote to per-isolate compilation cache.
+      compilation_cache->PutScript(source, context, language_mode, result);
+      return result;
+    }
+  }
+
   base::ElapsedTimer timer;
   if (FLAG_profile_deserialization && FLAG_serialize_toplevel &&
       compile_options == ScriptCompiler::kProduceCodeCache) {
@@ -1548,9 +1590,11 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForScript(
     parse_info.set_compile_options(compile_options);
     parse_info.set_extension(extension);
     parse_info.set_context(context);
-    if (FLAG_serialize_toplevel &&
-        compile_options == ScriptCompiler::kProduceCodeCache) {
+    if ((FLAG_serialize_toplevel &&
+         compile_options == ScriptCompiler::kProduceCodeCache) ||
+        use_shared_cache) {
       info.PrepareForSerializing();
+      script->set_compiled_for_code_cache(true);
     }
 
     parse_info.set_language_mode(
@@ -1570,6 +1614,18 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForScript(
           PrintF("[Compiling and serializing took %0.3f ms]\n",
                  timer.Elapsed().InMillisecondsF());
         }
+      } else if (use_shared_cache) {
+        HistogramTimerScope histogram_timer(
+            isolate->counters()->compile_serialize());
+        RuntimeCallTimerScope runtimeTimer(isolate,
+                                           &RuntimeCallStats::CompileSerialize);
+        TRACE_EVENT0("v8", "V8.CompileSerialize");
+        ScriptData* shared_data =
+            CodeSerializer::Serialize(isolate, result, source);
+        SharedCompilationCache::PutScript(
+            source, script_name, line_offset, column_offset, resource_options,
+            source_map_url, language_mode, shared_data);
+        delete shared_data;
       }
     }
 
@@ -1584,6 +1640,49 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForScript(
   return result;
 }
 
+Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForEagerScript(
+    Handle<String> source, Handle<Object> script_name, int line_offset,
+    int column_offset, ScriptOriginOptions resource_options,
+    Handle<Object> source_map_url, Handle<Context> context,
+    Handle<FixedArray> cold_functions) {
+  Isolate* isolate = source->GetIsolate();
+  int source_length = source->length();
+  isolate->counters()->total_load_size()->Increment(source_length);
+  isolate->counters()->total_compile_size()->Increment(source_length);
+
+  // Create a script object describing the script to be compiled.
+  Handle<Script> script = isolate->factory()->NewScript(source);
+  if (!script_name.is_null()) {
+    script->set_name(*script_name);
+    script->set_line_offset(line_offset);
+    script->set_column_offset(column_offset);
+  }
+  script->set_origin_options(resource_options);
+  if (!source_map_url.is_null()) {
+    script->set_source_mapping_url(*source_map_url);
+  }
+
+  // The result is not put into the compilation cache, so that a later compile
+  // of the same source is not affected by the eager compile.
+  Zone zone(isolate->allocator());
+  ParseInfo parse_info(&zone, script);
+  CompilationInfo info(&parse_info, Handle<JSFunction>::null());
+  parse_info.set_global();
+  parse_info.set_context(context);
+  parse_info.set_language_mode(
+      static_cast<LanguageMode>(parse_info.language_mode() |
+                                construct_language_mode(FLAG_use_strict)));
+  info.MarkAsEagerCompile(cold_functions);
+
+  Handle<SharedFunctionInfo> result = CompileToplevel(&info);
+  if (result.is_null()) {
+    isolate->ReportPendingMessages();
+  } else {
+    isolate->debug()->OnAfterCompile(script);
+  }
+  return result;
+}
+
 Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfoForStreamedScript(
     Handle<Script> script, ParseInfo* parse_info, int source_length) {
   Isolate* isolate = script->GetIsolate();
@@ -1658,6 +1757,9 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfo(
   parse_info.set_language_mode(literal->scope()->language_mode());
   if (outer_info->will_serialize()) info.PrepareForSerializing();
   if (outer_info->is_debug()) info.MarkAsDebug();
+  if (outer_info->is_eager_compile()) {
+    info.MarkAsEagerCompile(outer_info->cold_functions());
+  }
 
   // Determine if the function can be lazily compiled. This is necessary to
   // allow some of our builtin JS files to be lazily compiled. These
@@ -1678,6 +1780,9 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfo(
   lazy &=
       !(FLAG_ignition && FLAG_ignition_eager && !isolate->serializer_enabled());
 
+  // Compile eagerly for an embedder snapshot, unless the function is cold.
+  lazy &= !info.is_eager_compile() || info.IsColdFunction(literal->name());
+
   // Generate code
   TimerEventScope<TimerEventCompileCode> timer(isolate);
   RuntimeCallTimerScope runtimeTimer(isolate, &RuntimeCallStats::CompileCode);
@@ -92,6 +92,15 @@ class Compiler : public AllStatic {
       ScriptCompiler::CompileOptions compile_options,
       NativesFlag is_natives_code, bool is_module);
 
+  // Create a shared function info object for a String source, compiling all
+  // inner functions eagerly except for the ones named in {cold_functions}.
+  // Used to put compiled code for a whole script into a startup snapshot.
+  static Handle<SharedFunctionInfo> GetSharedFunctionInfoForEagerScript(
+      Handle<String> source, Handle<Object> script_name, int line_offset,
+      int column_offset, ScriptOriginOptions resource_options,
+      Handle<Object> source_map_url, Handle<Context> context,
+      Handle<FixedArray> cold_functions);
+
   // Create a shared function info object for a Script that has already been
   // parsed while the script was being loaded from a streamed source.
   static Handle<SharedFunctionInfo> GetSharedFunctionInfoForStreamedScript(
@@ -147,6 +156,8 @@ class CompilationInfo final {
     kBailoutOnUninitialized = 1 << 16,
     kOptimizeFromBytecode = 1 << 17,
     kTypeFeedbackEnabled = 1 << 18,
+    kEagerCompile = 1 << 19,
+    kProtectedMemoryAccesses = 1 << 20,
   };
 
   CompilationInfo(ParseInfo* parse_info, Handle<JSFunction> closure);
@@ -231,6 +242,19 @@ class CompilationInfo final {
 
   bool will_serialize() const { return GetFlag(kSerializing); }
 
+  // Compiles marked as eager compile all inner functions eagerly, except for
+  // the ones named in {cold_functions}, which keep the lazy compile stub.
+  void MarkAsEagerCompile(Handle<FixedArray> cold_functions) {
+    SetFlag(kEagerCompile);
+    cold_functions_ = cold_functions;
+  }
+
+  bool is_eager_compile() const { return GetFlag(kEagerCompile); }
+
+  Handle<FixedArray> cold_functions() const { return cold_functions_; }
+
+  bool IsColdFunction(Handle<String> name) const;
+
   void MarkAsFunctionContextSpecializing() {
     SetFlag(kFunctionContextSpecializing);
   }
@@ -269,6 +293,14 @@ class CompilationInfo final {
     return GetFlag(kSourcePositionsEnabled);
   }
 
+  // Wasm code whose memory accesses fault out of bounds instead of being
+  // checked, see wasm::GuardRegions.
+  void MarkAsProtectingMemoryAccesses() { SetFlag(kProtectedMemoryAccesses); }
+
+  bool is_protecting_memory_accesses() const {
+    return GetFlag(kProtectedMemoryAccesses);
+  }
+
   void MarkAsInliningEnabled() { SetFlag(kInliningEnabled); }
 
   bool is_inlining_enabled() const { return GetFlag(kInliningEnabled); }
@@ -493,6 +525,9 @@ class CompilationInfo final {
   // The compiled code.
   Handle<Code> code_;
 
+  // Names of inner functions that an eager compile leaves lazy.
+  Handle<FixedArray> cold_functions_;
+
   // Compilation mode flag and whether deoptimization is allowed.
   Mode mode_;
   BailoutId osr_ast_id_;
@@ -184,11 +184,18 @@ class OutOfLineCode : public ZoneObject {
   MacroAssembler* masm() const { return masm_; }
   OutOfLineCode* next() const { return next_; }
 
+ protected:
+  // Record a safepoint for a call made from the out-of-line code.
+  void RecordSafepoint(ReferenceMap* references, Safepoint::Kind kind,
+                       int arguments, Safepoint::DeoptMode deopt_mode);
+  Zone* zone() const;
+
  private:
   Label entry_;
   Label exit_;
   const Frame* const frame_;
   MacroAssembler* const masm_;
+  CodeGenerator* const gen_;
   OutOfLineCode* const next_;
 };
 
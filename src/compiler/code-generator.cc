@@ -44,6 +44,7 @@ CodeGenerator::CodeGenerator(Frame* frame, Linkage* linkage,
       resolver_(this),
       safepoints_(code->zone()),
       handlers_(code->zone()),
+      protected_instructions_(code->zone()),
       deoptimization_exits_(code->zone()),
       deoptimization_states_(code->zone()),
       deoptimization_literals_(code->zone()),
@@ -227,6 +228,23 @@ Handle<Code> CodeGenerator::GenerateCode() {
     result->set_handler_table(*table);
   }
 
+  // Emit the landing pads of protected instructions.
+  if (!protected_instructions_.empty()) {
+    int length = static_cast<int>(protected_instructions_.size()) *
+                 Code::kProtectedInstructionEntrySize;
+    Handle<ByteArray> table =
+        isolate()->factory()->NewByteArray(length * kIntSize, TENURED);
+    int index = 0;
+    for (const ProtectedInstruction& entry : protected_instructions_) {
+      table->set_int(index + Code::kProtectedInstructionStart, entry.start);
+      table->set_int(index + Code::kProtectedInstructionEnd, entry.end);
+      table->set_int(index + Code::kProtectedInstructionLanding,
+                     entry.landing->pos());
+      index += Code::kProtectedInstructionEntrySize;
+    }
+    result->set_protected_instructions(*table);
+  }
+
   PopulateDeoptimizationData(result);
 
   // Ensure there is space for lazy deoptimization in the relocation info.
@@ -243,6 +261,13 @@ Handle<Code> CodeGenerator::GenerateCode() {
 }
 
 
+void CodeGenerator::RecordProtectedInstruction(int start, int end,
+                                               Label* landing) {
+  DCHECK(info()->is_protecting_memory_accesses());
+  protected_instructions_.push_back({start, end, landing});
+}
+
+
 bool CodeGenerator::IsNextInAssemblyOrder(RpoNumber block) const {
   return code()
       ->InstructionBlockAt(current_block_)
@@ -812,13 +837,26 @@ int CodeGenerator::TailCallFrameStackSlotDelta(int stack_param_delta) {
 
 
 OutOfLineCode::OutOfLineCode(CodeGenerator* gen)
-    : frame_(gen->frame()), masm_(gen->masm()), next_(gen->ools_) {
+    : frame_(gen->frame()),
+      masm_(gen->masm()),
+      gen_(gen),
+      next_(gen->ools_) {
   gen->ools_ = this;
 }
 
 
 OutOfLineCode::~OutOfLineCode() {}
 
+
+void OutOfLineCode::RecordSafepoint(ReferenceMap* references,
+                                    Safepoint::Kind kind, int arguments,
+                                    Safepoint::DeoptMode deopt_mode) {
+  gen_->RecordSafepoint(references, kind, arguments, deopt_mode);
+}
+
+
+Zone* OutOfLineCode::zone() const { return gen_->zone(); }
+
 }  // namespace compiler
 }  // namespace internal
 }  // namespace v8
@@ -81,6 +81,10 @@ class CodeGenerator final : public GapResolver::Assembler {
   void RecordSafepoint(ReferenceMap* references, Safepoint::Kind kind,
                        int arguments, Safepoint::DeoptMode deopt_mode);
 
+  // Record that a memory fault in the code between {start} and {end} resumes
+  // at {landing}, see Code::protected_instructions.
+  void RecordProtectedInstruction(int start, int end, Label* landing);
+
   // Check if a heap object can be materialized by loading from the frame, which
   // is usually way cheaper than materializing the actual heap object constant.
   bool IsMaterializableFromFrame(Handle<HeapObject> object, int* slot_return);
@@ -218,6 +222,12 @@ class CodeGenerator final : public GapResolver::Assembler {
     int pc_offset;
   };
 
+  struct ProtectedInstruction {
+    int start;
+    int end;
+    Label* landing;
+  };
+
   friend class OutOfLineCode;
 
   FrameAccessState* frame_access_state_;
@@ -232,6 +242,7 @@ class CodeGenerator final : public GapResolver::Assembler {
   GapResolver resolver_;
   SafepointTableBuilder safepoints_;
   ZoneVector<HandlerInfo> handlers_;
+  ZoneVector<ProtectedInstruction> protected_instructions_;
   ZoneDeque<DeoptimizationExit*> deoptimization_exits_;
   ZoneDeque<DeoptimizationState*> deoptimization_states_;
   ZoneDeque<Handle<Object>> deoptimization_literals_;
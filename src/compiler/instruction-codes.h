@@ -181,6 +181,10 @@ FlagsCondition CommuteFlagsCondition(FlagsCondition condition);
 
 std::ostream& operator<<(std::ostream& os, const FlagsCondition& fc);
 
+// Encoded in the MiscField of loads and stores. Protected accesses are wasm
+// memory accesses that may fault in a guard region, see wasm::GuardRegions.
+enum MemoryAccessMode { kMemoryAccessDirect = 0, kMemoryAccessProtected = 1 };
+
 // The InstructionCode is an opaque, target-specific integer that encodes
 // what code to emit for an instruction in the code generator. It is not
 // interesting to the register allocator, as the inputs and flags on the
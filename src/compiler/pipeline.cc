@@ -1297,6 +1297,13 @@ struct FrameElisionPhase {
   static const char* phase_name() { return "frame elision"; }
 
   void Run(PipelineData* data, Zone* temp_zone) {
+    if (data->info()->is_protecting_memory_accesses()) {
+      // Faulting memory accesses continue in an out-of-line trap that calls
+      // the runtime, so every block has to run within the frame.
+      for (InstructionBlock* block : data->sequence()->instruction_blocks()) {
+        block->mark_needs_frame();
+      }
+    }
     FrameElider(data->sequence()).Run();
   }
 };
@@ -32,6 +32,7 @@
 #include "src/log-inl.h"
 
 #include "src/wasm/ast-decoder.h"
+#include "src/wasm/signature-map.h"
 #include "src/wasm/wasm-module.h"
 #include "src/wasm/wasm-opcodes.h"
 
@@ -62,6 +63,12 @@ void MergeControlToEnd(JSGraph* jsgraph, Node* node) {
   }
 }
 
+// Whether the memory of the module is allocated with guard regions, so that
+// out-of-bounds accesses fault instead of being checked explicitly.
+bool UseGuardRegions(wasm::ModuleEnv* module) {
+  return module && module->instance && module->instance->mem_has_guard_regions;
+}
+
 }  // namespace
 
 // A helper that handles building graph fragments for trapping.
@@ -1908,37 +1915,43 @@ Node* WasmGraphBuilder::CallIndirect(uint32_t index, Node** args,
   }
   Node* table = FunctionTable();
 
-  // Load signature from the table and check.
-  // The table is a FixedArray; signatures are encoded as SMIs.
-  // [sig1, sig2, sig3, ...., code1, code2, code3 ...]
+  // Each entry of the table holds the signature id of a function, encoded as
+  // a SMI, followed by its code object:
+  // [sig_id1, code1, sig_id2, code2, ...]
+  // Structurally equal signatures of the module share an id, so the signature
+  // check compares the tagged id with a constant.
+  STATIC_ASSERT(wasm::WasmModule::kFunctionTableEntrySize == 2);
   ElementAccess access = AccessBuilder::ForFixedArrayElement();
   const int fixed_offset = access.header_size - access.tag();
+  Node* entry_offset = graph()->NewNode(machine->Word32Shl(), key,
+                                        Int32Constant(kPointerSizeLog2 + 1));
+  wasm::FunctionSig* sig = module_->GetSignature(index);
   {
+    int offset = fixed_offset +
+                 kPointerSize * wasm::WasmModule::kFunctionTableSignatureOffset;
     Node* load_sig = graph()->NewNode(
         machine->Load(MachineType::AnyTagged()), table,
-        graph()->NewNode(machine->Int32Add(),
-                         graph()->NewNode(machine->Word32Shl(), key,
-                                          Int32Constant(kPointerSizeLog2)),
-                         Int32Constant(fixed_offset)),
+        graph()->NewNode(machine->Int32Add(), entry_offset,
+                         Int32Constant(offset)),
         *effect_, *control_);
-    Node* sig_match =
-        graph()->NewNode(machine->Word32Equal(),
-                         BuildChangeSmiToInt32(load_sig), Int32Constant(index));
+    int32_t sig_id = module_->module->signature_map.Find(sig);
+    Node* sig_match = graph()->NewNode(
+        machine->WordEqual(), load_sig,
+        jsgraph()->IntPtrConstant(
+            reinterpret_cast<intptr_t>(Smi::FromInt(sig_id))));
     trap_->AddTrapIfFalse(wasm::kTrapFuncSigMismatch, sig_match, position);
   }
 
   // Load code object from the table.
-  int offset = fixed_offset + kPointerSize * table_size;
+  int offset =
+      fixed_offset + kPointerSize * wasm::WasmModule::kFunctionTableCodeOffset;
   Node* load_code = graph()->NewNode(
       machine->Load(MachineType::AnyTagged()), table,
-      graph()->NewNode(machine->Int32Add(),
-                       graph()->NewNode(machine->Word32Shl(), key,
-                                        Int32Constant(kPointerSizeLog2)),
+      graph()->NewNode(machine->Int32Add(), entry_offset,
                        Int32Constant(offset)),
       *effect_, *control_);
 
   args[0] = load_code;
-  wasm::FunctionSig* sig = module_->GetSignature(index);
   return BuildWasmCall(sig, args, position);
 }
 
@@ -2224,25 +2237,69 @@ Node* WasmGraphBuilder::BuildChangeTaggedToFloat64(Node* value) {
   return phi;
 }
 
+Node* WasmGraphBuilder::BuildJavaScriptToNumberValue(Node* node,
+                                                     Node* context,
+                                                     bool truncate_to_int32) {
+  MachineOperatorBuilder* machine = jsgraph()->machine();
+  CommonOperatorBuilder* common = jsgraph()->common();
+  Node* effect = *effect_;
+  Node* control = *control_;
+
+  // Smis and HeapNumbers are converted inline. Only other values call the
+  // ToNumber stub, which may call back into JavaScript.
+  Node* check_smi = BuildTestNotSmi(node);
+  Node* branch_smi = graph()->NewNode(common->Branch(), check_smi, control);
+
+  Node* if_smi = graph()->NewNode(common->IfFalse(), branch_smi);
+  Node* vsmi = truncate_to_int32 ? BuildChangeSmiToInt32(node)
+                                 : BuildChangeSmiToFloat64(node);
+
+  Node* if_not_smi = graph()->NewNode(common->IfTrue(), branch_smi);
+  Node* map = graph()->NewNode(
+      machine->Load(MachineType::AnyTagged()), node,
+      jsgraph()->IntPtrConstant(HeapObject::kMapOffset - kHeapObjectTag),
+      effect, if_not_smi);
+  Node* check_heap_number = graph()->NewNode(
+      machine->WordEqual(), map, jsgraph()->HeapNumberMapConstant());
+  Node* branch_heap_number =
+      graph()->NewNode(common->Branch(BranchHint::kTrue), check_heap_number,
+                       if_not_smi);
+
+  Node* if_heap_number = graph()->NewNode(common->IfTrue(), branch_heap_number);
+  Node* vheap_number = BuildLoadHeapNumberValue(node, if_heap_number);
+
+  Node* if_other = graph()->NewNode(common->IfFalse(), branch_heap_number);
+  Node* number = BuildJavaScriptToNumber(node, context, map, if_other);
+  Node* vother = BuildChangeTaggedToFloat64(number);
+
+  if (truncate_to_int32) {
+    vheap_number =
+        graph()->NewNode(machine->TruncateFloat64ToWord32(), vheap_number);
+    vother = graph()->NewNode(machine->TruncateFloat64ToWord32(), vother);
+  }
+
+  Node* merge =
+      graph()->NewNode(common->Merge(3), if_smi, if_heap_number, number);
+  *control_ = merge;
+  *effect_ =
+      graph()->NewNode(common->EffectPhi(3), effect, map, number, merge);
+  return graph()->NewNode(
+      common->Phi(truncate_to_int32 ? MachineRepresentation::kWord32
+                                    : MachineRepresentation::kFloat64,
+                  3),
+      vsmi, vheap_number, vother, merge);
+}
+
 Node* WasmGraphBuilder::FromJS(Node* node, Node* context,
                                wasm::LocalType type) {
-  // Do a JavaScript ToNumber.
-  Node* num = BuildJavaScriptToNumber(node, context, *effect_, *control_);
-
-  // Change representation.
-  SimplifiedOperatorBuilder simplified(jsgraph()->zone());
-  num = BuildChangeTaggedToFloat64(num);
-
+  Node* num = nullptr;
   switch (type) {
-    case wasm::kAstI32: {
-      num = graph()->NewNode(jsgraph()->machine()->TruncateFloat64ToWord32(),
-                             num);
+    case wasm::kAstI32:
+      num = BuildJavaScriptToNumberValue(node, context, true);
       break;
-    }
     case wasm::kAstI64:
       // TODO(titzer): JS->i64 has no good solution right now. Using 32 bits.
-      num = graph()->NewNode(jsgraph()->machine()->TruncateFloat64ToWord32(),
-                             num);
+      num = BuildJavaScriptToNumberValue(node, context, true);
       if (jsgraph()->machine()->Is64()) {
         // We cannot change an int32 to an int64 on a 32 bit platform. Instead
         // we will split the parameter node later.
@@ -2250,12 +2307,15 @@ Node* WasmGraphBuilder::FromJS(Node* node, Node* context,
       }
       break;
     case wasm::kAstF32:
+      num = BuildJavaScriptToNumberValue(node, context, false);
       num = graph()->NewNode(jsgraph()->machine()->TruncateFloat64ToFloat32(),
                              num);
       break;
     case wasm::kAstF64:
+      num = BuildJavaScriptToNumberValue(node, context, false);
       break;
     case wasm::kAstStmt:
+      // The value is dropped, so it is not converted.
       num = jsgraph()->Int32Constant(0);
       break;
     default:
@@ -2474,6 +2534,8 @@ void WasmGraphBuilder::BuildWasmToJSWrapper(Handle<JSFunction> function,
   args[pos++] = *control_;
 
   Node* call = graph()->NewNode(jsgraph()->common()->Call(desc), pos, args);
+  *effect_ = call;
+  *control_ = call;
 
   // Convert the return value back.
   Node* ret;
@@ -2485,14 +2547,58 @@ void WasmGraphBuilder::BuildWasmToJSWrapper(Handle<JSFunction> function,
     ret = graph()->NewNode(jsgraph()->common()->Return(), val,
                            graph()->NewNode(jsgraph()->machine()->Word32Sar(),
                                             val, jsgraph()->Int32Constant(31)),
-                           call, start);
+                           *effect_, *control_);
   } else {
-    ret = graph()->NewNode(jsgraph()->common()->Return(), val, call, start);
+    ret = graph()->NewNode(jsgraph()->common()->Return(), val, *effect_,
+                           *control_);
   }
 
   MergeControlToEnd(jsgraph(), ret);
 }
 
+void WasmGraphBuilder::BuildWasmLazyCompileStub(Handle<Context> context,
+                                                wasm::FunctionSig* sig) {
+  int wasm_count = static_cast<int>(sig->parameter_count());
+  Node* start = Start(wasm_count + 1);
+  *effect_ = start;
+  *control_ = start;
+
+  // Call the runtime to compile the function. It finds the function index
+  // in the deoptimization data of this stub and returns the compiled code.
+  Runtime::FunctionId f = Runtime::kWasmCompileLazy;
+  const Runtime::Function* fun = Runtime::FunctionForId(f);
+  CallDescriptor* desc = Linkage::GetRuntimeCallDescriptor(
+      jsgraph()->zone(), f, fun->nargs, Operator::kNoProperties,
+      CallDescriptor::kNoFlags);
+  DCHECK_EQ(1, fun->result_size);
+  Node* inputs[] = {
+      jsgraph()->CEntryStubConstant(fun->result_size),               // C entry
+      jsgraph()->ExternalConstant(ExternalReference(f, jsgraph()->isolate())),
+      jsgraph()->Int32Constant(fun->nargs),                          // arity
+      HeapConstant(context),                                         // context
+      *effect_,
+      *control_};
+  Node* code = graph()->NewNode(jsgraph()->common()->Call(desc),
+                                static_cast<int>(arraysize(inputs)), inputs);
+  *effect_ = code;
+  *control_ = code;
+
+  // Forward the parameters to the compiled code.
+  Node** args = Buffer(wasm_count + 1);
+  args[0] = code;
+  for (int i = 0; i < wasm_count; ++i) {
+    args[i + 1] = Param(i, sig->GetParam(i));
+  }
+  Node* call = BuildWasmCall(sig, args, 0);
+  if (sig->return_count() == 0) {
+    ReturnVoid();
+  } else {
+    Node** vals = Buffer(1);
+    vals[0] = call;
+    Return(1, vals);
+  }
+}
+
 Node* WasmGraphBuilder::MemBuffer(uint32_t offset) {
   DCHECK(module_ && module_->instance);
   if (offset == 0) {
@@ -2559,10 +2665,20 @@ Node* WasmGraphBuilder::StoreGlobal(uint32_t index, Node* val) {
   return node;
 }
 
+Node* WasmGraphBuilder::GuardRegionIndex(Node* index) {
+  if (!UseGuardRegions(module_) || jsgraph()->machine()->Is32()) return index;
+  // The index is used as a 64-bit register in the address; its upper half
+  // must be zero so that the access stays within the guard region.
+  return graph()->NewNode(jsgraph()->machine()->ChangeUint32ToUint64(), index);
+}
+
 void WasmGraphBuilder::BoundsCheckMem(MachineType memtype, Node* index,
                                       uint32_t offset,
                                       wasm::WasmCodePosition position) {
   DCHECK(module_ && module_->instance);
+  // Out-of-bounds accesses fault in the guard region and are turned into
+  // traps by the signal handler.
+  if (UseGuardRegions(module_)) return;
   uint32_t size = module_->instance->mem_size;
   byte memsize = wasm::WasmOpcodes::MemSize(memtype);
 
@@ -2723,6 +2839,7 @@ Node* WasmGraphBuilder::LoadMem(wasm::LocalType type, MachineType memtype,
 
   // WASM semantics throw on OOB. Introduce explicit bounds check.
   BoundsCheckMem(memtype, index, offset, position);
+  index = GuardRegionIndex(index);
   bool aligned = static_cast<int>(alignment) >=
                  ElementSizeLog2Of(memtype.representation());
 
@@ -2734,6 +2851,7 @@ Node* WasmGraphBuilder::LoadMem(wasm::LocalType type, MachineType memtype,
   } else {
     load = BuildUnalignedLoad(type, memtype, index, offset, alignment);
   }
+  if (UseGuardRegions(module_)) SetSourcePosition(*effect_, position);
 
   if (type == wasm::kAstI64 &&
       ElementSizeLog2Of(memtype.representation()) < 3) {
@@ -2850,6 +2968,7 @@ Node* WasmGraphBuilder::StoreMem(MachineType memtype, Node* index,
 
   // WASM semantics throw on OOB. Introduce explicit bounds check.
   BoundsCheckMem(memtype, index, offset, position);
+  index = GuardRegionIndex(index);
   StoreRepresentation rep(memtype.representation(), kNoWriteBarrier);
   bool aligned = static_cast<int>(alignment) >=
                  ElementSizeLog2Of(memtype.representation());
@@ -2864,6 +2983,7 @@ Node* WasmGraphBuilder::StoreMem(MachineType memtype, Node* index,
   } else {
     store = BuildUnalignedStore(memtype, index, offset, alignment, val);
   }
+  if (UseGuardRegions(module_)) SetSourcePosition(*effect_, position);
 
   return store;
 }
@@ -2954,7 +3074,10 @@ Handle<JSFunction> CompileJSToWasmWrapper(
   shared->set_internal_formal_parameter_count(params);
   Handle<JSFunction> function = isolate->factory()->NewFunction(
       isolate->wasm_function_map(), name, MaybeHandle<Code>());
-  function->SetInternalField(0, *module_object);
+  function->SetInternalField(wasm::kWasmExportModuleObject, *module_object);
+  function->SetInternalField(
+      wasm::kWasmExportSignatureId,
+      Smi::FromInt(wasm::SignatureMap::FindOrInsertCanonical(func->sig)));
   function->set_shared(*shared);
 
   //----------------------------------------------------------------------------
@@ -3099,6 +3222,50 @@ Handle<Code> CompileWasmToJSWrapper(Isolate* isolate,
   return code;
 }
 
+Handle<Code> CompileWasmLazyCompileStub(Isolate* isolate,
+                                        Handle<Context> context,
+                                        wasm::FunctionSig* sig) {
+  //----------------------------------------------------------------------------
+  // Create the Graph
+  //----------------------------------------------------------------------------
+  Zone zone(isolate->allocator());
+  Graph graph(&zone);
+  CommonOperatorBuilder common(&zone);
+  MachineOperatorBuilder machine(&zone);
+  JSGraph jsgraph(isolate, &graph, &common, nullptr, nullptr, &machine);
+
+  Node* control = nullptr;
+  Node* effect = nullptr;
+
+  WasmGraphBuilder builder(&zone, &jsgraph, sig);
+  builder.set_control_ptr(&control);
+  builder.set_effect_ptr(&effect);
+  builder.BuildWasmLazyCompileStub(context, sig);
+
+  if (machine.Is32()) {
+    Int64Lowering r(&graph, &machine, &common, &zone, sig);
+    r.LowerGraph();
+  }
+
+  // Schedule and compile to machine code. The stub is a wasm function so
+  // that the runtime finds the function to compile in its frame.
+  CallDescriptor* incoming = wasm::ModuleEnv::GetWasmCallDescriptor(&zone, sig);
+  if (machine.Is32()) {
+    incoming = wasm::ModuleEnv::GetI32WasmCallDescriptor(&zone, incoming);
+  }
+  Code::Flags flags = Code::ComputeFlags(Code::WASM_FUNCTION);
+  CompilationInfo info(ArrayVector("wasm-lazy-compile"), isolate, &zone, flags);
+  Handle<Code> code =
+      Pipeline::GenerateCodeForTesting(&info, incoming, &graph, nullptr);
+#ifdef ENABLE_DISASSEMBLER
+  if (FLAG_print_opt_code && !code.is_null()) {
+    OFStream os(stdout);
+    code->Disassemble("wasm-lazy-compile", os);
+  }
+#endif
+  return code;
+}
+
 SourcePositionTable* WasmCompilationUnit::BuildGraphForWasmFunction(
     double* decode_ms) {
   base::ElapsedTimer decode_timer;
@@ -3173,6 +3340,11 @@ WasmCompilationUnit::WasmCompilationUnit(wasm::ErrorThrower* thrower,
       ok_(true) {
   // Create and cache this node in the main thread.
   jsgraph_->CEntryStubConstant(1);
+  if (UseGuardRegions(module_env)) {
+    // The landing pads of faulting accesses need their source positions.
+    info_.MarkAsProtectingMemoryAccesses();
+    info_.MarkAsSourcePositionsEnabled();
+  }
 }
 
 void WasmCompilationUnit::ExecuteCompilation() {
@@ -83,6 +83,13 @@ Handle<Code> CompileWasmToJSWrapper(Isolate* isolate,
                                     wasm::WasmName module_name,
                                     wasm::WasmName function_name);
 
+// Creates a stub with the wasm calling convention for {sig} that compiles the
+// function it stands in for on its first call and then forwards the
+// arguments to the compiled code (see wasm::CompileLazy).
+Handle<Code> CompileWasmLazyCompileStub(Isolate* isolate,
+                                        Handle<Context> context,
+                                        wasm::FunctionSig* sig);
+
 // Wraps a given wasm code object, producing a JSFunction that can be called
 // from JavaScript.
 Handle<JSFunction> CompileJSToWasmWrapper(
@@ -154,6 +161,8 @@ class WasmGraphBuilder {
   void BuildJSToWasmWrapper(Handle<Code> wasm_code, wasm::FunctionSig* sig);
   void BuildWasmToJSWrapper(Handle<JSFunction> function,
                             wasm::FunctionSig* sig);
+  void BuildWasmLazyCompileStub(Handle<Context> context,
+                                wasm::FunctionSig* sig);
 
   Node* ToJS(Node* node, Node* context, wasm::LocalType type);
   Node* FromJS(Node* node, Node* context, wasm::LocalType type);
@@ -218,6 +227,7 @@ class WasmGraphBuilder {
 
   Node* String(const char* string);
   Node* MemBuffer(uint32_t offset);
+  Node* GuardRegionIndex(Node* index);
   void BoundsCheckMem(MachineType memtype, Node* index, uint32_t offset,
                       wasm::WasmCodePosition position);
 
@@ -311,6 +321,8 @@ class WasmGraphBuilder {
 
   Node* BuildJavaScriptToNumber(Node* node, Node* context, Node* effect,
                                 Node* control);
+  Node* BuildJavaScriptToNumberValue(Node* node, Node* context,
+                                     bool truncate_to_int32);
   Node* BuildChangeInt32ToTagged(Node* value);
   Node* BuildChangeFloat64ToTagged(Node* value);
   Node* BuildChangeTaggedToFloat64(Node* value);
@@ -9,6 +9,7 @@
 #include "src/compiler/gap-resolver.h"
 #include "src/compiler/node-matchers.h"
 #include "src/compiler/osr.h"
+#include "src/wasm/wasm-opcodes.h"
 #include "src/x64/assembler-x64.h"
 #include "src/x64/macro-assembler-x64.h"
 
@@ -236,6 +237,49 @@ class OutOfLineRecordWrite final : public OutOfLineCode {
   RecordWriteMode const mode_;
 };
 
+// Landing pad of a wasm memory access that faulted in a guard region, see
+// wasm::GuardRegions. Throws the out-of-bounds trap.
+class OutOfLineWasmTrap final : public OutOfLineCode {
+ public:
+  OutOfLineWasmTrap(CodeGenerator* gen, int position)
+      : OutOfLineCode(gen), position_(position) {}
+
+  void Generate() final {
+    __ Push(Smi::FromInt(
+        wasm::WasmOpcodes::TrapReasonToMessageId(wasm::kTrapMemOutOfBounds)));
+    __ Push(Smi::FromInt(position_));
+    __ Move(rsi, isolate()->native_context());
+    __ CallRuntime(Runtime::kThrowWasmError);
+    // Wasm frames hold no tagged values.
+    RecordSafepoint(new (zone()) ReferenceMap(zone()), Safepoint::kSimple, 0,
+                    Safepoint::kNoLazyDeopt);
+  }
+
+ private:
+  int const position_;
+};
+
+// Whether {instr} is a load or store that the instruction selector tagged as
+// a wasm memory access, which can fault in a guard region.
+bool IsProtectedMemoryAccess(Instruction* instr) {
+  switch (ArchOpcodeField::decode(instr->opcode())) {
+    case kX64Movsxbl:
+    case kX64Movzxbl:
+    case kX64Movb:
+    case kX64Movsxwl:
+    case kX64Movzxwl:
+    case kX64Movw:
+    case kX64Movl:
+    case kX64Movq:
+    case kX64Movsd:
+    case kX64Movss:
+      return AddressingModeField::decode(instr->opcode()) != kMode_None &&
+             MiscField::decode(instr->opcode()) == kMemoryAccessProtected;
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 
@@ -678,6 +722,12 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
   X64OperandConverter i(this, instr);
   InstructionCode opcode = instr->opcode();
   ArchOpcode arch_opcode = ArchOpcodeField::decode(opcode);
+  int protected_start = -1;
+  if (info()->is_protecting_memory_accesses() &&
+      IsProtectedMemoryAccess(instr)) {
+    DCHECK(frame_access_state()->has_frame());
+    protected_start = __ pc_offset();
+  }
   switch (arch_opcode) {
     case kArchCallCodeObject: {
       EnsureSpaceForLazyDeopt();
@@ -1867,6 +1917,11 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
       UNREACHABLE();  // Won't be generated by instruction selector.
       break;
   }
+  if (protected_start >= 0) {
+    OutOfLineCode* ool =
+        new (zone()) OutOfLineWasmTrap(this, current_source_position_.raw());
+    RecordProtectedInstruction(protected_start, __ pc_offset(), ool->entry());
+  }
   return kSuccess;
 }  // NOLINT(readability/fn_size)
 
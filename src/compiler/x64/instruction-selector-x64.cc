@@ -37,12 +37,30 @@ class X64OperandGenerator final : public OperandGenerator {
     }
   }
 
+  // Whether the load or store {node} accesses wasm memory, i.e. its base is
+  // the relocatable start address of the memory.
+  bool IsWasmMemoryAccess(Node* node) {
+    Node* base = node->InputAt(0);
+    return base->opcode() == IrOpcode::kRelocatableInt64Constant &&
+           OpParameter<RelocatablePtrConstantInfo>(base).rmode() ==
+               RelocInfo::WASM_MEMORY_REFERENCE;
+  }
+
+  // The access mode for the load or store {node}.
+  MemoryAccessMode GetMemoryAccessMode(Node* node) {
+    return IsWasmMemoryAccess(node) ? kMemoryAccessProtected
+                                    : kMemoryAccessDirect;
+  }
+
   bool CanBeMemoryOperand(InstructionCode opcode, Node* node, Node* input,
                           int effect_level) {
     if (input->opcode() != IrOpcode::kLoad ||
         !selector()->CanCover(node, input)) {
       return false;
     }
+    // Wasm memory loads stay separate instructions, so that every access that
+    // can fault in a guard region is tagged as protected.
+    if (IsWasmMemoryAccess(input)) return false;
     if (effect_level != selector()->GetEffectLevel(input)) {
       return false;
     }
@@ -177,7 +195,8 @@ void InstructionSelector::VisitLoad(Node* node) {
   size_t input_count = 0;
   AddressingMode mode =
       g.GetEffectiveAddressMemoryOperand(node, inputs, &input_count);
-  InstructionCode code = opcode | AddressingModeField::encode(mode);
+  InstructionCode code = opcode | AddressingModeField::encode(mode) |
+                         MiscField::encode(g.GetMemoryAccessMode(node));
   Emit(code, 1, outputs, input_count, inputs);
 }
 
@@ -259,8 +278,9 @@ void InstructionSelector::VisitStore(Node* node) {
     size_t input_count = 0;
     AddressingMode addressing_mode =
         g.GetEffectiveAddressMemoryOperand(node, inputs, &input_count);
-    InstructionCode code =
-        opcode | AddressingModeField::encode(addressing_mode);
+    InstructionCode code = opcode |
+                           AddressingModeField::encode(addressing_mode) |
+                           MiscField::encode(g.GetMemoryAccessMode(node));
     InstructionOperand value_operand =
         g.CanBeImmediate(value) ? g.UseImmediate(value) : g.UseRegister(value);
     inputs[input_count++] = value_operand;
@@ -626,7 +646,7 @@ void InstructionSelector::VisitWord64Sar(Node* node) {
   X64OperandGenerator g(this);
   Int64BinopMatcher m(node);
   if (CanCover(m.node(), m.left().node()) && m.left().IsLoad() &&
-      m.right().Is(32)) {
+      m.right().Is(32) && !g.IsWasmMemoryAccess(m.left().node())) {
     // Just load and sign-extend the interesting 4 bytes instead. This happens,
     // for example, when we're loading and untagging SMIs.
     BaseWithIndexAndDisplacement64Matcher mleft(m.left().node(), true);
@@ -2377,6 +2377,11 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpCaptureCountIndex,
              Smi::FromInt(capture_count));
   store->set(JSRegExp::kIrregexpCaptureNameMapIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpLatin1BytecodeIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+             Smi::FromInt(FLAG_regexp_tier_up_ticks));
+  store->set(JSRegExp::kIrregexpNfaProgramIndex, uninitialized);
   regexp->set_data(*store);
 }
 
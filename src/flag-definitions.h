@@ -496,8 +496,20 @@ DEFINE_BOOL(wasm_break_on_decoder_error, false,
             "debug break when wasm decoder encounters an error")
 DEFINE_BOOL(wasm_loop_assignment_analysis, true,
             "perform loop assignment analysis for WASM")
+DEFINE_BOOL(wasm_guard_pages, false,
+            "use guard regions instead of explicit bounds checks for WASM "
+            "memory (x64 Linux only)")
+DEFINE_BOOL(wasm_parallel_verification, true,
+            "verify wasm function bodies on background threads")
+DEFINE_BOOL(wasm_lazy_compilation, false,
+            "compile WASM functions on their first call instead of at "
+            "instantiation")
+DEFINE_BOOL(trace_wasm_lazy_compilation, false,
+            "trace lazy compilation of WASM functions")
 
 DEFINE_BOOL(validate_asm, false, "validate asm.js modules before compiling")
+DEFINE_BOOL(trace_asm_time, false,
+            "trace the time of asm.js to wasm translation")
 DEFINE_BOOL(enable_simd_asmjs, false, "enable SIMD.js in asm.js stdlib")
 
 DEFINE_BOOL(dump_wasm_module, false, "dump WASM module bytes")
@@ -621,6 +633,9 @@ DEFINE_INT(max_opt_count, 10,
 
 // compilation-cache.cc
 DEFINE_BOOL(compilation_cache, true, "enable compilation cache")
+DEFINE_INT(shared_compilation_cache_size, 0,
+           "size in KB of the script code cache shared by all isolates "
+           "(0 disables it)")
 
 DEFINE_BOOL(cache_prototype_transitions, true, "cache prototype transitions")
 
@@ -853,9 +868,29 @@ DEFINE_BOOL(profile_deserialization, false,
             "Print the time it takes to deserialize the snapshot.")
 DEFINE_BOOL(serialization_statistics, false,
             "Collect statistics on serialized objects.")
+DEFINE_BOOL(verify_snapshot_checksum, DEBUG_BOOL,
+            "Verify the checksum of the startup snapshot. The default "
+            "snapshot is verified once per process on a background thread, "
+            "and V8::VerifySnapshotChecksum reports the result.")
+DEFINE_BOOL(compress_snapshot, false,
+            "Compress the startup and context snapshot data (mksnapshot).")
 
 // Regexp
 DEFINE_BOOL(regexp_optimization, true, "generate optimized regexp code")
+DEFINE_BOOL(regexp_tier_up, true,
+            "interpret regexps as bytecode until they are executed often")
+DEFINE_INT(regexp_tier_up_ticks, 1,
+           "number of interpreted executions before a regexp is compiled to "
+           "native code")
+DEFINE_BOOL(regexp_linear, false,
+            "match regexps without back references and lookarounds with the "
+            "linear-time NFA engine")
+DEFINE_INT(regexp_backtracks_before_fallback, 0,
+           "number of backtracks after which an interpreted regexp falls back "
+           "to the linear-time NFA engine (0 means never)")
+DEFINE_BOOL(regexp_exec_cache, false,
+            "cache the results of regexp executions on short subjects "
+            "(executions always enter the runtime)")
 
 // Testing flags test/cctest/test-{flags,api,serialization}.cc
 DEFINE_BOOL(testing_bool_flag, true, "testing_bool_flag")
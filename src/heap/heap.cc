@@ -1459,6 +1459,7 @@ void Heap::MarkCompactPrologue() {
   isolate_->descriptor_lookup_cache()->Clear();
   RegExpResultsCache::Clear(string_split_cache());
   RegExpResultsCache::Clear(regexp_multiple_cache());
+  RegExpExecCache::Clear(regexp_exec_cache());
 
   isolate_->compilation_cache()->MarkCompactPrologue();
 
@@ -2773,6 +2774,11 @@ void Heap::CreateInitialObjects() {
   set_regexp_multiple_cache(*factory->NewFixedArray(
       RegExpResultsCache::kRegExpResultsCacheSize, TENURED));
 
+  // Allocate cache for regexp executions.
+  set_regexp_exec_cache(
+      *factory->NewFixedArray(RegExpExecCache::kRegExpExecCacheSize, TENURED));
+  RegExpExecCache::Clear(regexp_exec_cache());
+
   // Allocate cache for external strings pointing to native source code.
   set_natives_source_cache(
       *factory->NewFixedArray(Natives::GetBuiltinsCount()));
@@ -27,6 +27,7 @@
 #include "src/ic/stub-cache.h"
 #include "src/utils-inl.h"
 #include "src/v8.h"
+#include "src/wasm/wasm-trap-handler.h"
 
 namespace v8 {
 namespace internal {
@@ -348,6 +349,9 @@ void MarkCompactCollector::CollectGarbage() {
 
   EvacuateNewSpaceAndCandidates();
 
+  // Wasm code may have moved during evacuation.
+  wasm::ProtectedCode::Publish();
+
   Finish();
 }
 
@@ -1696,6 +1700,9 @@ class MarkCompactCollector::EvacuateVisitorBase
       }
       heap_->CopyBlock(dst_addr, src_addr, size);
       Code::cast(dst)->Relocate(dst_addr - src_addr);
+      if (Code::cast(dst)->kind() == Code::WASM_FUNCTION) {
+        wasm::ProtectedCode::Move(Code::cast(dst), dst_addr - src_addr);
+      }
       RecordMigratedSlotVisitor visitor(heap_->mark_compact_collector());
       dst->IterateBodyFast(dst->map()->instance_type(), size, &visitor);
     } else {
@@ -652,6 +652,13 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   __ TailCallRuntime(Runtime::kRegExpExec);
 #else  // V8_INTERPRETED_REGEXP
 
+  // With the exec cache, the runtime looks up the cached result before it
+  // runs the native code.
+  if (use_exec_cache()) {
+    __ TailCallRuntime(Runtime::kRegExpExec);
+    return;
+  }
+
   // Stack frame on entry.
   //  esp[0]: return address
   //  esp[4]: last_match_info (expected JSArray)
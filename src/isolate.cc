@@ -1841,6 +1841,7 @@ Isolate::Isolate(bool enable_serializer)
       random_number_generator_(NULL),
       rail_mode_(PERFORMANCE_DEFAULT),
       serializer_enabled_(enable_serializer),
+      serializer_keeps_type_feedback_(false),
       has_fatal_error_(false),
       initialized_from_snapshot_(false),
       is_tail_call_elimination_enabled_(true),
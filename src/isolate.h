@@ -391,6 +391,7 @@ class ThreadLocalTop BASE_EMBEDDED {
   V(int, bad_char_shift_table, kUC16AlphabetSize)                              \
   V(int, good_suffix_shift_table, (kBMMaxShift + 1))                           \
   V(int, suffix_table, (kBMMaxShift + 1))                                      \
+  V(uc16, string_search_table_pattern, kBMMaxShift)                            \
   V(uint32_t, private_random_seed, 2)                                          \
   ISOLATE_INIT_DEBUG_ARRAY_LIST(V)
 
@@ -422,6 +423,10 @@ typedef List<HeapObject*> DebugObjectCache;
   V(const v8::StartupData*, snapshot_blob, nullptr)                           \
   V(int, code_and_metadata_size, 0)                                           \
   V(int, bytecode_and_metadata_size, 0)                                       \
+  /* Pattern the shared StringSearch tables were last built for. */           \
+  V(int, string_search_table_pattern_length, 0)                               \
+  V(bool, bad_char_shift_table_valid, false)                                  \
+  V(bool, good_suffix_shift_table_valid, false)                               \
   /* true if being profiled. Causes collection of extra compile info. */      \
   V(bool, is_profiling, false)                                                \
   ISOLATE_INIT_SIMULATOR_LIST(V)
@@ -951,6 +956,12 @@ class Isolate {
   }
 
   bool serializer_enabled() const { return serializer_enabled_; }
+  bool serializer_keeps_type_feedback() const {
+    return serializer_keeps_type_feedback_;
+  }
+  void set_serializer_keeps_type_feedback(bool value) {
+    serializer_keeps_type_feedback_ = value;
+  }
   bool snapshot_available() const {
     return snapshot_blob_ != NULL && snapshot_blob_->raw_size != 0;
   }
@@ -1320,6 +1331,10 @@ class Isolate {
   // Whether the isolate has been created for snapshotting.
   bool serializer_enabled_;
 
+  // Whether the snapshot being created keeps type feedback, so that GC only
+  // clears property access ICs.
+  bool serializer_keeps_type_feedback_;
+
   // True if fatal error has been signaled for this isolate.
   bool has_fatal_error_;
 
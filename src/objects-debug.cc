@@ -816,8 +816,25 @@ void JSRegExp::JSRegExpVerify() {
       CHECK(uc16_saved->IsSmi() || uc16_saved->IsString() ||
              uc16_saved->IsCode());
 
+      // Smi : No bytecode, or the regexp has been tiered up.
+      // ByteArray: Bytecode used until the regexp is tiered up.
+      Object* one_byte_bytecode =
+          arr->get(JSRegExp::kIrregexpLatin1BytecodeIndex);
+      CHECK(one_byte_bytecode->IsSmi() || one_byte_bytecode->IsByteArray());
+      Object* uc16_bytecode = arr->get(JSRegExp::kIrregexpUC16BytecodeIndex);
+      CHECK(uc16_bytecode->IsSmi() || uc16_bytecode->IsByteArray());
+
       CHECK(arr->get(JSRegExp::kIrregexpCaptureCountIndex)->IsSmi());
       CHECK(arr->get(JSRegExp::kIrregexpMaxRegisterCountIndex)->IsSmi());
+      CHECK(arr->get(JSRegExp::kIrregexpTicksUntilTierUpIndex)->IsSmi());
+      Object* program = arr->get(JSRegExp::kIrregexpNfaProgramIndex);
+      CHECK(program->IsSmi() || program->IsByteArray());
+      break;
+    }
+    case JSRegExp::LINEAR: {
+      FixedArray* arr = FixedArray::cast(data());
+      CHECK(arr->get(JSRegExp::kIrregexpNfaProgramIndex)->IsByteArray());
+      CHECK(arr->get(JSRegExp::kIrregexpCaptureCountIndex)->IsSmi());
       break;
     }
     default:
@@ -5630,6 +5630,12 @@ bool Script::hide_source() { return BooleanBit::get(flags(), kHideSourceBit); }
 void Script::set_hide_source(bool value) {
   set_flags(BooleanBit::set(flags(), kHideSourceBit, value));
 }
+bool Script::compiled_for_code_cache() {
+  return BooleanBit::get(flags(), kCompiledForCodeCacheBit);
+}
+void Script::set_compiled_for_code_cache(bool value) {
+  set_flags(BooleanBit::set(flags(), kCompiledForCodeCacheBit, value));
+}
 Script::CompilationState Script::compilation_state() {
   return BooleanBit::get(flags(), kCompilationStateBit) ?
       COMPILATION_STATE_COMPILED : COMPILATION_STATE_INITIAL;
@@ -6492,6 +6498,25 @@ void Code::set_stub_key(uint32_t key) {
 }
 
 
+bool Code::has_protected_instructions() {
+  DCHECK(kind() == WASM_FUNCTION);
+  return raw_type_feedback_info()->IsByteArray();
+}
+
+
+ByteArray* Code::protected_instructions() {
+  DCHECK(has_protected_instructions());
+  return ByteArray::cast(raw_type_feedback_info());
+}
+
+
+void Code::set_protected_instructions(ByteArray* value) {
+  DCHECK(kind() == WASM_FUNCTION);
+  set_raw_type_feedback_info(value);
+  WRITE_BARRIER(GetHeap(), this, kTypeFeedbackInfoOffset, value);
+}
+
+
 ACCESSORS(Code, gc_metadata, Object, kGCMetadataOffset)
 INT_ACCESSORS(Code, ic_age, kICAgeOffset)
 
@@ -6731,6 +6756,7 @@ int JSRegExp::CaptureCount() {
     case ATOM:
       return 0;
     case IRREGEXP:
+    case LINEAR:
       return Smi::cast(DataAt(kIrregexpCaptureCountIndex))->value();
     default:
       UNREACHABLE();
@@ -4965,6 +4965,7 @@ class Code: public HeapObject {
   // the kind of the code object.
   //   FUNCTION           => type feedback information.
   //   STUB and ICs       => major/minor key as Smi.
+  //   WASM_FUNCTION      => protected instructions, see below.
   DECL_ACCESSORS(raw_type_feedback_info, Object)
   inline Object* type_feedback_info();
   inline void set_type_feedback_info(
@@ -4972,6 +4973,18 @@ class Code: public HeapObject {
   inline uint32_t stub_key();
   inline void set_stub_key(uint32_t key);
 
+  // [protected_instructions]: For wasm functions using guard regions, a table
+  // of (start, end, landing) instruction offsets. A memory fault at a pc in
+  // [start, end) resumes execution at the landing pad, which throws the
+  // out-of-bounds trap.
+  inline bool has_protected_instructions();
+  inline ByteArray* protected_instructions();
+  inline void set_protected_instructions(ByteArray* value);
+  static const int kProtectedInstructionStart = 0;
+  static const int kProtectedInstructionEnd = 1;
+  static const int kProtectedInstructionLanding = 2;
+  static const int kProtectedInstructionEntrySize = 3;
+
   // [next_code_link]: Link for lists of optimized or deoptimized code.
   // Note that storage for this field is overlapped with typefeedback_info.
   DECL_ACCESSORS(next_code_link, Object)
@@ -6548,6 +6561,11 @@ class Script: public Struct {
   inline bool hide_source();
   inline void set_hide_source(bool value);
 
+  // [compiled_for_code_cache]: determines whether lazily compiled functions
+  // of the script are generated so that they can be added to a code cache.
+  inline bool compiled_for_code_cache();
+  inline void set_compiled_for_code_cache(bool value);
+
   // [origin_options]: optional attributes set by the embedder via ScriptOrigin,
   // and used by the embedder to make decisions about the script. V8 just passes
   // this through. Encoded in the 'flags' field.
@@ -6651,6 +6669,8 @@ class Script: public Struct {
   static const int kOriginOptionsSize = 3;
   static const int kOriginOptionsMask = ((1 << kOriginOptionsSize) - 1)
                                         << kOriginOptionsShift;
+  static const int kCompiledForCodeCacheBit =
+      kOriginOptionsShift + kOriginOptionsSize;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Script);
 };
@@ -8273,7 +8293,9 @@ class JSRegExp: public JSObject {
   // NOT_COMPILED: Initial value. No data has been stored in the JSRegExp yet.
   // ATOM: A simple string to match against using an indexOf operation.
   // IRREGEXP: Compiled with Irregexp.
-  enum Type { NOT_COMPILED, ATOM, IRREGEXP };
+  // LINEAR regexps share the IRREGEXP data layout but are matched by the
+  // linear-time NFA engine.
+  enum Type { NOT_COMPILED, ATOM, IRREGEXP, LINEAR };
   enum Flag {
     kNone = 0,
     kGlobal = 1 << 0,
@@ -8321,6 +8343,14 @@ class JSRegExp: public JSObject {
     }
   }
 
+  static int bytecode_index(bool is_latin1) {
+    if (is_latin1) {
+      return kIrregexpLatin1BytecodeIndex;
+    } else {
+      return kIrregexpUC16BytecodeIndex;
+    }
+  }
+
   DECLARE_CAST(JSRegExp)
 
   // Dispatched behavior.
@@ -8369,7 +8399,17 @@ class JSRegExp: public JSObject {
   // capture group indices (at indices 2i + 1).
   static const int kIrregexpCaptureNameMapIndex = kDataIndex + 6;
 
-  static const int kIrregexpDataSize = kIrregexpCaptureNameMapIndex + 1;
+  // Irregexp bytecode for Latin1 and UC16 used by native regexp builds
+  // until the regexp is tiered up to native code.
+  static const int kIrregexpLatin1BytecodeIndex = kDataIndex + 7;
+  static const int kIrregexpUC16BytecodeIndex = kDataIndex + 8;
+  // Number of executions left before the regexp is compiled to native code.
+  static const int kIrregexpTicksUntilTierUpIndex = kDataIndex + 9;
+  // Program of the linear-time NFA engine, or a Smi if the regexp is not
+  // matched by it and can't fall back to it.
+  static const int kIrregexpNfaProgramIndex = kDataIndex + 10;
+
+  static const int kIrregexpDataSize = kIrregexpNfaProgramIndex + 1;
 
   // Offsets directly into the data fixed array.
   static const int kDataTagOffset =
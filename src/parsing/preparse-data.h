@@ -24,8 +24,16 @@ class ScriptData {
   const byte* data() const { return data_; }
   int length() const { return length_; }
   bool rejected() const { return rejected_; }
+  bool checksum_verified() const { return checksum_verified_; }
+  uint32_t verified_checksum1() const { return verified_checksum1_; }
+  uint32_t verified_checksum2() const { return verified_checksum2_; }
 
   void Reject() { rejected_ = true; }
+  void MarkChecksumVerified(uint32_t checksum1, uint32_t checksum2) {
+    checksum_verified_ = true;
+    verified_checksum1_ = checksum1;
+    verified_checksum2_ = checksum2;
+  }
 
   void AcquireDataOwnership() {
     DCHECK(!owns_data_);
@@ -40,6 +48,9 @@ class ScriptData {
  private:
   bool owns_data_ : 1;
   bool rejected_ : 1;
+  bool checksum_verified_ : 1;
+  uint32_t verified_checksum1_;
+  uint32_t verified_checksum2_;
   const byte* data_;
   int length_;
 
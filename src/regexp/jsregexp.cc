@@ -18,6 +18,7 @@
 #include "src/regexp/regexp-macro-assembler.h"
 #include "src/regexp/regexp-macro-assembler-irregexp.h"
 #include "src/regexp/regexp-macro-assembler-tracer.h"
+#include "src/regexp/regexp-nfa.h"
 #include "src/regexp/regexp-parser.h"
 #include "src/regexp/regexp-stack.h"
 #include "src/runtime/runtime.h"
@@ -181,6 +182,22 @@ MaybeHandle<Object> RegExpImpl::Compile(Handle<JSRegExp> re,
   }
   if (!has_been_compiled) {
     IrregexpInitialize(re, pattern, flags, parse_result.capture_count);
+    // Regexps the NFA engine can handle either use it right away or keep its
+    // program to fall back to once they backtrack too much.
+    if ((FLAG_regexp_linear || FLAG_regexp_backtracks_before_fallback > 0) &&
+        RegExpNfa::CanBeHandled(parse_result.tree, flags)) {
+      Handle<ByteArray> program;
+      if (RegExpNfa::Compile(isolate, &zone, parse_result.tree, flags,
+                             parse_result.capture_count)
+              .ToHandle(&program)) {
+        re->SetDataAt(JSRegExp::kIrregexpNfaProgramIndex, *program);
+        if (FLAG_regexp_linear) {
+          re->SetDataAt(JSRegExp::kTagIndex, Smi::FromInt(JSRegExp::LINEAR));
+          SetIrregexpCaptureNameMap(FixedArray::cast(re->data()),
+                                    parse_result.capture_name_map);
+        }
+      }
+    }
   }
   DCHECK(re->data()->IsFixedArray());
   // Compilation succeeded so the data is set on the regexp
@@ -199,7 +216,8 @@ MaybeHandle<Object> RegExpImpl::Exec(Handle<JSRegExp> regexp,
   switch (regexp->TypeTag()) {
     case JSRegExp::ATOM:
       return AtomExec(regexp, subject, index, last_match_info);
-    case JSRegExp::IRREGEXP: {
+    case JSRegExp::IRREGEXP:
+    case JSRegExp::LINEAR: {
       return IrregexpExec(regexp, subject, index, last_match_info);
     }
     default:
@@ -337,13 +355,39 @@ bool RegExpImpl::EnsureCompiledIrregexp(Handle<JSRegExp> re,
     DCHECK(compiled_code->IsSmi());
     return true;
   }
-  return CompileIrregexp(re, sample_subject, is_one_byte);
+#ifndef V8_INTERPRETED_REGEXP
+  // Regexps are interpreted as bytecode until they have been executed often
+  // enough, or on a long enough subject, to be worth compiling to native code.
+  // Regexps with a backtrack budget stay in the interpreter, which enforces it.
+  if ((FLAG_regexp_tier_up && !IrregexpShouldTierUp(re, sample_subject)) ||
+      IrregexpHasNfaFallback(FixedArray::cast(re->data()))) {
+    Object* bytecode = re->DataAt(JSRegExp::bytecode_index(is_one_byte));
+    if (bytecode->IsByteArray()) return true;
+    return CompileIrregexp(re, sample_subject, is_one_byte, true);
+  }
+#endif  // V8_INTERPRETED_REGEXP
+  return CompileIrregexp(re, sample_subject, is_one_byte,
+                         !UsesNativeRegExp());
+}
+
+
+bool RegExpImpl::IrregexpShouldTierUp(Handle<JSRegExp> re,
+                                      Handle<String> subject) {
+  if (subject->length() >= kRegExpTierUpSubjectLength) return true;
+  Object* ticks = re->DataAt(JSRegExp::kIrregexpTicksUntilTierUpIndex);
+  return Smi::cast(ticks)->value() <= 0;
+}
+
+
+bool RegExpImpl::IrregexpHasNfaFallback(FixedArray* re) {
+  return FLAG_regexp_backtracks_before_fallback > 0 &&
+         re->get(JSRegExp::kIrregexpNfaProgramIndex)->IsByteArray();
 }
 
 
 bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
                                  Handle<String> sample_subject,
-                                 bool is_one_byte) {
+                                 bool is_one_byte, bool use_bytecode) {
   // Compile the RegExp.
   Isolate* isolate = re->GetIsolate();
   Zone zone(isolate->allocator());
@@ -386,7 +430,7 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
   }
   RegExpEngine::CompilationResult result =
       RegExpEngine::Compile(isolate, &zone, &compile_data, flags, pattern,
-                            sample_subject, is_one_byte);
+                            sample_subject, is_one_byte, use_bytecode);
   if (result.error_message != NULL) {
     // Unable to compile regexp.
     Handle<String> error_message = isolate->factory()->NewStringFromUtf8(
@@ -396,7 +440,20 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
   }
 
   Handle<FixedArray> data = Handle<FixedArray>(FixedArray::cast(re->data()));
+#ifdef V8_INTERPRETED_REGEXP
   data->set(JSRegExp::code_index(is_one_byte), result.code);
+#else  // V8_INTERPRETED_REGEXP
+  if (use_bytecode) {
+    data->set(JSRegExp::bytecode_index(is_one_byte), result.code);
+  } else {
+    data->set(JSRegExp::code_index(is_one_byte), result.code);
+    // Native code replaces the bytecode, and once the regexp has been tiered
+    // up both subject representations stay on native code.
+    data->set(JSRegExp::bytecode_index(is_one_byte),
+              Smi::FromInt(JSRegExp::kUninitializedValue));
+    data->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, Smi::FromInt(0));
+  }
+#endif  // V8_INTERPRETED_REGEXP
   SetIrregexpCaptureNameMap(*data, compile_data.capture_name_map);
   int register_max = IrregexpMaxRegisterCount(*data);
   if (result.num_registers > register_max) {
@@ -437,7 +494,20 @@ int RegExpImpl::IrregexpNumberOfRegisters(FixedArray* re) {
 
 
 ByteArray* RegExpImpl::IrregexpByteCode(FixedArray* re, bool is_one_byte) {
+#ifdef V8_INTERPRETED_REGEXP
   return ByteArray::cast(re->get(JSRegExp::code_index(is_one_byte)));
+#else  // V8_INTERPRETED_REGEXP
+  return ByteArray::cast(re->get(JSRegExp::bytecode_index(is_one_byte)));
+#endif  // V8_INTERPRETED_REGEXP
+}
+
+
+bool RegExpImpl::IrregexpUsesByteCode(FixedArray* re, bool is_one_byte) {
+#ifdef V8_INTERPRETED_REGEXP
+  return true;
+#else  // V8_INTERPRETED_REGEXP
+  return re->get(JSRegExp::bytecode_index(is_one_byte))->IsByteArray();
+#endif  // V8_INTERPRETED_REGEXP
 }
 
 
@@ -463,22 +533,35 @@ int RegExpImpl::IrregexpPrepare(Handle<JSRegExp> regexp,
                                 Handle<String> subject) {
   subject = String::Flatten(subject);
 
+  if (regexp->TypeTag() == JSRegExp::LINEAR) {
+    // The NFA engine only needs room to output captures.
+    return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) *
+           2;
+  }
+
   // Check representation of the underlying storage.
   bool is_one_byte = subject->IsOneByteRepresentationUnderneath();
   if (!EnsureCompiledIrregexp(regexp, subject, is_one_byte)) return -1;
 
-#ifdef V8_INTERPRETED_REGEXP
-  // Byte-code regexp needs space allocated for all its registers.
-  // The result captures are copied to the start of the registers array
-  // if the match succeeds.  This way those registers are not clobbered
-  // when we set the last match info from last successful match.
-  return IrregexpNumberOfRegisters(FixedArray::cast(regexp->data())) +
-         (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#else  // V8_INTERPRETED_REGEXP
+  FixedArray* data = FixedArray::cast(regexp->data());
+  if (IrregexpUsesByteCode(data, is_one_byte)) {
+    // Count down towards compiling the regexp to native code.
+    int ticks =
+        Smi::cast(data->get(JSRegExp::kIrregexpTicksUntilTierUpIndex))->value();
+    if (ticks > 0) {
+      data->set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+                Smi::FromInt(ticks - 1));
+    }
+    // Byte-code regexp needs space allocated for all its registers.
+    // The result captures are copied to the start of the registers array
+    // if the match succeeds.  This way those registers are not clobbered
+    // when we set the last match info from last successful match.
+    return IrregexpNumberOfRegisters(data) +
+           (IrregexpNumberOfCaptures(data) + 1) * 2;
+  }
   // Native regexp only needs room to output captures. Registers are handled
   // internally.
-  return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#endif  // V8_INTERPRETED_REGEXP
+  return (IrregexpNumberOfCaptures(data) + 1) * 2;
 }
 
 
@@ -495,47 +578,50 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
   DCHECK(index <= subject->length());
   DCHECK(subject->IsFlat());
 
+  if (regexp->TypeTag() == JSRegExp::LINEAR) {
+    return LinearExecRaw(regexp, subject, index, output, output_size);
+  }
+
   bool is_one_byte = subject->IsOneByteRepresentationUnderneath();
 
 #ifndef V8_INTERPRETED_REGEXP
-  DCHECK(output_size >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
-  do {
-    EnsureCompiledIrregexp(regexp, subject, is_one_byte);
-    Handle<Code> code(IrregexpNativeCode(*irregexp, is_one_byte), isolate);
-    // The stack is used to allocate registers for the compiled regexp code.
-    // This means that in case of failure, the output registers array is left
-    // untouched and contains the capture results from the previous successful
-    // match.  We can use that to set the last match info lazily.
-    NativeRegExpMacroAssembler::Result res =
-        NativeRegExpMacroAssembler::Match(code,
-                                          subject,
-                                          output,
-                                          output_size,
-                                          index,
-                                          isolate);
-    if (res != NativeRegExpMacroAssembler::RETRY) {
-      DCHECK(res != NativeRegExpMacroAssembler::EXCEPTION ||
-             isolate->has_pending_exception());
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::SUCCESS) == RE_SUCCESS);
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::FAILURE) == RE_FAILURE);
-      STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION)
-                    == RE_EXCEPTION);
-      return static_cast<IrregexpResult>(res);
-    }
-    // If result is RETRY, the string has changed representation, and we
-    // must restart from scratch.
-    // In this case, it means we must make sure we are prepared to handle
-    // the, potentially, different subject (the string can switch between
-    // being internal and external, and even between being Latin1 and UC16,
-    // but the characters are always the same).
-    IrregexpPrepare(regexp, subject);
-    is_one_byte = subject->IsOneByteRepresentationUnderneath();
-  } while (true);
-  UNREACHABLE();
-  return RE_EXCEPTION;
-#else  // V8_INTERPRETED_REGEXP
+  if (!IrregexpUsesByteCode(*irregexp, is_one_byte)) {
+    DCHECK(output_size >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
+    do {
+      EnsureCompiledIrregexp(regexp, subject, is_one_byte);
+      Handle<Code> code(IrregexpNativeCode(*irregexp, is_one_byte), isolate);
+      // The stack is used to allocate registers for the compiled regexp
+      // code. This means that in case of failure, the output registers array
+      // is left untouched and contains the capture results from the previous
+      // successful match.  We can use that to set the last match info lazily.
+      NativeRegExpMacroAssembler::Result res =
+          NativeRegExpMacroAssembler::Match(code, subject, output, output_size,
+                                            index, isolate);
+      if (res != NativeRegExpMacroAssembler::RETRY) {
+        DCHECK(res != NativeRegExpMacroAssembler::EXCEPTION ||
+               isolate->has_pending_exception());
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::SUCCESS) ==
+                      RE_SUCCESS);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::FAILURE) ==
+                      RE_FAILURE);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION) ==
+                      RE_EXCEPTION);
+        return static_cast<IrregexpResult>(res);
+      }
+      // If result is RETRY, the string has changed representation, and we
+      // must restart from scratch.
+      // In this case, it means we must make sure we are prepared to handle
+      // the, potentially, different subject (the string can switch between
+      // being internal and external, and even between being Latin1 and
+      // UC16, but the characters are always the same). The regexp has been
+      // tiered up, so this compiles native code for the new representation.
+      IrregexpPrepare(regexp, subject);
+      is_one_byte = subject->IsOneByteRepresentationUnderneath();
+    } while (true);
+    UNREACHABLE();
+    return RE_EXCEPTION;
+  }
+#endif  // V8_INTERPRETED_REGEXP
 
   DCHECK(output_size >= IrregexpNumberOfRegisters(*irregexp));
   // We must have done EnsureCompiledIrregexp, so we can get the number of
@@ -552,11 +638,17 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
   Handle<ByteArray> byte_codes(IrregexpByteCode(*irregexp, is_one_byte),
                                isolate);
 
-  IrregexpResult result = IrregexpInterpreter::Match(isolate,
-                                                     byte_codes,
-                                                     subject,
-                                                     raw_output,
-                                                     index);
+  int backtrack_limit = IrregexpHasNfaFallback(*irregexp)
+                            ? FLAG_regexp_backtracks_before_fallback
+                            : 0;
+  IrregexpResult result = IrregexpInterpreter::Match(
+      isolate, byte_codes, subject, raw_output, index, backtrack_limit);
+  if (result == RE_FALLBACK_TO_LINEAR) {
+    // The regexp backtracks too much. It is matched by the NFA engine from
+    // now on, which guarantees time linear in the length of the subject.
+    irregexp->set(JSRegExp::kTagIndex, Smi::FromInt(JSRegExp::LINEAR));
+    return LinearExecRaw(regexp, subject, index, output, output_size);
+  }
   if (result == RE_SUCCESS) {
     // Copy capture results to the start of the registers array.
     MemCopy(output, raw_output, number_of_capture_registers * sizeof(int32_t));
@@ -566,7 +658,23 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
     isolate->StackOverflow();
   }
   return result;
-#endif  // V8_INTERPRETED_REGEXP
+}
+
+
+int RegExpImpl::LinearExecRaw(Handle<JSRegExp> regexp, Handle<String> subject,
+                              int index, int32_t* output, int output_size) {
+  Isolate* isolate = regexp->GetIsolate();
+  Handle<FixedArray> data(FixedArray::cast(regexp->data()), isolate);
+  DCHECK_EQ(JSRegExp::LINEAR, regexp->TypeTag());
+  DCHECK(subject->IsFlat());
+
+  int register_count = (IrregexpNumberOfCaptures(*data) + 1) * 2;
+  DCHECK(output_size >= register_count);
+  Handle<ByteArray> program(
+      ByteArray::cast(data->get(JSRegExp::kIrregexpNfaProgramIndex)), isolate);
+  bool sticky = (regexp->GetFlags() & JSRegExp::kSticky) != 0;
+  return RegExpNfa::Match(isolate, program, subject, output, register_count,
+                          index, sticky);
 }
 
 
@@ -575,7 +683,8 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> regexp,
                                              int previous_index,
                                              Handle<JSArray> last_match_info) {
   Isolate* isolate = regexp->GetIsolate();
-  DCHECK_EQ(regexp->TypeTag(), JSRegExp::IRREGEXP);
+  DCHECK(regexp->TypeTag() == JSRegExp::IRREGEXP ||
+         regexp->TypeTag() == JSRegExp::LINEAR);
 
   // Prepare space for the return values.
 #if defined(V8_INTERPRETED_REGEXP) && defined(DEBUG)
@@ -585,6 +694,29 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> regexp,
     PrintF("\n\nSubject string: '%s'\n\n", subject->ToCString().get());
   }
 #endif
+  Handle<FixedArray> data(FixedArray::cast(regexp->data()), isolate);
+  int capture_count = IrregexpNumberOfCaptures(*data);
+  int capture_register_count = (capture_count + 1) * 2;
+  bool use_exec_cache =
+      FLAG_regexp_exec_cache &&
+      capture_register_count <= Isolate::kJSRegexpStaticOffsetsVectorSize;
+  if (use_exec_cache) {
+    Object* cached = RegExpExecCache::Lookup(isolate->heap(), *subject, *data,
+                                             previous_index);
+    if (cached->IsNull(isolate)) {
+      isolate->counters()->regexp_exec_cache_hits()->Increment();
+      return isolate->factory()->null_value();
+    }
+    if (cached->IsByteArray()) {
+      isolate->counters()->regexp_exec_cache_hits()->Increment();
+      ByteArray* registers = ByteArray::cast(cached);
+      DCHECK_EQ(capture_register_count * kIntSize, registers->length());
+      int32_t* match = isolate->jsregexp_static_offsets_vector();
+      MemCopy(match, registers->GetDataStartAddress(), registers->length());
+      return SetLastMatchInfo(last_match_info, subject, capture_count, match);
+    }
+  }
+
   int required_registers = RegExpImpl::IrregexpPrepare(regexp, subject);
   if (required_registers < 0) {
     // Compiling failed with an exception.
@@ -604,8 +736,10 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> regexp,
   int res = RegExpImpl::IrregexpExecRaw(
       regexp, subject, previous_index, output_registers, required_registers);
   if (res == RE_SUCCESS) {
-    int capture_count =
-        IrregexpNumberOfCaptures(FixedArray::cast(regexp->data()));
+    if (use_exec_cache) {
+      RegExpExecCache::Enter(isolate, subject, data, previous_index,
+                             output_registers, capture_register_count);
+    }
     return SetLastMatchInfo(
         last_match_info, subject, capture_count, output_registers);
   }
@@ -614,6 +748,9 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(Handle<JSRegExp> regexp,
     return MaybeHandle<Object>();
   }
   DCHECK(res == RE_FAILURE);
+  if (use_exec_cache) {
+    RegExpExecCache::Enter(isolate, subject, data, previous_index, NULL, 0);
+  }
   return isolate->factory()->null_value();
 }
 
@@ -654,23 +791,23 @@ RegExpImpl::GlobalCache::GlobalCache(Handle<JSRegExp> regexp,
     register_array_size_(0),
     regexp_(regexp),
     subject_(subject) {
-#ifdef V8_INTERPRETED_REGEXP
-  bool interpreted = true;
-#else
   bool interpreted = false;
-#endif  // V8_INTERPRETED_REGEXP
 
   if (regexp_->TypeTag() == JSRegExp::ATOM) {
     static const int kAtomRegistersPerMatch = 2;
     registers_per_match_ = kAtomRegistersPerMatch;
     // There is no distinction between interpreted and native for atom regexps.
-    interpreted = false;
   } else {
     registers_per_match_ = RegExpImpl::IrregexpPrepare(regexp_, subject_);
     if (registers_per_match_ < 0) {
       num_matches_ = -1;  // Signal exception.
       return;
     }
+    // The interpreter and the NFA engine find one match per call.
+    interpreted = regexp_->TypeTag() == JSRegExp::LINEAR ||
+                  RegExpImpl::IrregexpUsesByteCode(
+                      FixedArray::cast(regexp_->data()),
+                      subject_->IsOneByteRepresentationUnderneath());
   }
 
   DCHECK_NE(0, regexp->GetFlags() & JSRegExp::kGlobal);
@@ -1141,7 +1278,7 @@ RegExpEngine::CompilationResult RegExpCompiler::Assemble(
   heap->IncreaseTotalRegexpCodeGenerated(code->Size());
   work_list_ = NULL;
 #ifdef ENABLE_DISASSEMBLER
-  if (FLAG_print_code) {
+  if (FLAG_print_code && code->IsCode()) {
     CodeTracer::Scope trace_scope(heap->isolate()->GetCodeTracer());
     OFStream os(trace_scope.file());
     Handle<Code>::cast(code)->Disassemble(pattern->ToCString().get(), os);
@@ -3792,9 +3929,43 @@ int BoyerMooreLookahead::GetSkipTable(int min_lookahead,
 
 
 // See comment above on the implementation of GetSkipTable.
+// Finds the lookahead position that admits the fewest characters and, if
+// there are few enough, lets the macro assembler scan for them directly.
+// Where that is supported it looks at many characters per iteration, while
+// the skip loops below look at one.
+bool BoyerMooreLookahead::EmitSkipUntilCharacter(RegExpMacroAssembler* masm) {
+  const int kSize = RegExpMacroAssembler::kTableSize;
+  const int kMaxChars = RegExpMacroAssembler::kMaxSkipCharacters;
+
+  int position = -1;
+  int count = kMaxChars + 1;
+  for (int i = 0; i < length_; i++) {
+    int map_count = Count(i);
+    if (map_count > 0 && map_count < count) {
+      position = i;
+      count = map_count;
+    }
+  }
+  if (position == -1) return false;
+
+  uc16 chars[kMaxChars];
+  int found = 0;
+  BoyerMoorePositionInfo* map = bitmaps_->at(position);
+  for (int j = 0; j < kSize && found < count; j++) {
+    if (map->at(j)) chars[found++] = j;
+  }
+  DCHECK_EQ(count, found);
+  uc16 mask = max_char_ > kSize ? RegExpMacroAssembler::kTableMask
+                                : String::kMaxUtf16CodeUnit;
+  return masm->SkipUntilCharacter(position, chars, count, mask);
+}
+
+
 void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
   const int kSize = RegExpMacroAssembler::kTableSize;
 
+  if (EmitSkipUntilCharacter(masm)) return;
+
   int min_lookahead = 0;
   int max_lookahead = 0;
 
@@ -6624,7 +6795,7 @@ RegExpNode* OptionallyStepBackToLeadSurrogate(RegExpCompiler* compiler,
 RegExpEngine::CompilationResult RegExpEngine::Compile(
     Isolate* isolate, Zone* zone, RegExpCompileData* data,
     JSRegExp::Flags flags, Handle<String> pattern,
-    Handle<String> sample_subject, bool is_one_byte) {
+    Handle<String> sample_subject, bool is_one_byte, bool use_bytecode) {
   if ((data->capture_count + 1) * 2 - 1 > RegExpMacroAssembler::kMaxRegister) {
     return IrregexpRegExpTooBig(isolate);
   }
@@ -6697,52 +6868,57 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
     return CompilationResult(isolate, error_message);
   }
 
-  // Create the correct assembler for the architecture.
+  // Create the correct assembler for the architecture, or the bytecode
+  // assembler if the regexp is going to be interpreted.
+  EmbeddedVector<byte, 1024> codes;
+  base::SmartPointer<RegExpMacroAssembler> macro_assembler;
 #ifndef V8_INTERPRETED_REGEXP
-  // Native regexp implementation.
-
-  NativeRegExpMacroAssembler::Mode mode =
-      is_one_byte ? NativeRegExpMacroAssembler::LATIN1
-                  : NativeRegExpMacroAssembler::UC16;
+  if (!use_bytecode) {
+    // Native regexp implementation.
+    NativeRegExpMacroAssembler::Mode mode =
+        is_one_byte ? NativeRegExpMacroAssembler::LATIN1
+                    : NativeRegExpMacroAssembler::UC16;
+    int registers = (data->capture_count + 1) * 2;
 
 #if V8_TARGET_ARCH_IA32
-  RegExpMacroAssemblerIA32 macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerIA32(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_X64
-  RegExpMacroAssemblerX64 macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerX64(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_ARM
-  RegExpMacroAssemblerARM macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerARM(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_ARM64
-  RegExpMacroAssemblerARM64 macro_assembler(isolate, zone, mode,
-                                            (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerARM64(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_S390
-  RegExpMacroAssemblerS390 macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerS390(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_PPC
-  RegExpMacroAssemblerPPC macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerPPC(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_MIPS
-  RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerMIPS(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_MIPS64
-  RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerMIPS(isolate, zone, mode, registers));
 #elif V8_TARGET_ARCH_X87
-  RegExpMacroAssemblerX87 macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerX87(isolate, zone, mode, registers));
 #else
 #error "Unsupported architecture"
 #endif
-
-#else  // V8_INTERPRETED_REGEXP
-  // Interpreted regexp implementation.
-  EmbeddedVector<byte, 1024> codes;
-  RegExpMacroAssemblerIrregexp macro_assembler(isolate, codes, zone);
+  }
 #endif  // V8_INTERPRETED_REGEXP
+  if (macro_assembler.is_empty()) {
+    // Interpreted regexp implementation.
+    macro_assembler.Reset(
+        new RegExpMacroAssemblerIrregexp(isolate, codes, zone));
+  }
 
-  macro_assembler.set_slow_safe(TooMuchRegExpCode(pattern));
+  macro_assembler->set_slow_safe(TooMuchRegExpCode(pattern));
 
   // Inserted here, instead of in Assembler, because it depends on information
   // in the AST that isn't replicated in the Node structure.
@@ -6750,7 +6926,7 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
   if (is_end_anchored &&
       !is_start_anchored &&
       max_length < kMaxBacksearchLimit) {
-    macro_assembler.SetCurrentPositionFromEnd(max_length);
+    macro_assembler->SetCurrentPositionFromEnd(max_length);
   }
 
   if (is_global) {
@@ -6760,10 +6936,10 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
     } else if (is_unicode) {
       mode = RegExpMacroAssembler::GLOBAL_UNICODE;
     }
-    macro_assembler.set_global_mode(mode);
+    macro_assembler->set_global_mode(mode);
   }
 
-  return compiler.Assemble(&macro_assembler,
+  return compiler.Assemble(macro_assembler.get(),
                            node,
                            data->capture_count,
                            pattern);
@@ -6881,5 +7057,135 @@ void RegExpResultsCache::Clear(FixedArray* cache) {
   }
 }
 
+
+uint32_t RegExpExecCache::KeyHash(String* subject, FixedArray* data,
+                                  int index) {
+  // Object addresses change in scavenges, so only hash stable values.
+  String* pattern = String::cast(data->get(JSRegExp::kSourceIndex));
+  return subject->Hash() ^ pattern->Hash() ^
+         ComputeIntegerHash(index, kZeroHashSeed);
+}
+
+
+int RegExpExecCache::EntryOffset(uint32_t hash, int probe) {
+  return ((hash + probe) & (kEntryCount - 1)) * kArrayEntriesPerCacheEntry;
+}
+
+
+int RegExpExecCache::EntryBytes(FixedArray* cache, int offset) {
+  Object* subject = cache->get(offset + kStringOffset);
+  if (!subject->IsString()) return 0;
+  String* string = String::cast(subject);
+  int bytes = string->length() * (string->IsOneByteRepresentation()
+                                      ? kCharSize
+                                      : kUC16Size);
+  Object* result = cache->get(offset + kResultOffset);
+  if (result->IsByteArray()) bytes += ByteArray::cast(result)->Size();
+  return bytes;
+}
+
+
+Object* RegExpExecCache::Lookup(Heap* heap, String* subject, FixedArray* data,
+                                int index) {
+  if (subject->length() > kMaxSubjectLength) return Smi::FromInt(0);
+  FixedArray* cache = heap->regexp_exec_cache();
+  uint32_t hash = KeyHash(subject, data, index);
+  for (int probe = 0; probe < 2; probe++) {
+    int offset = EntryOffset(hash, probe);
+    if (cache->get(offset + kPatternOffset) != data ||
+        cache->get(offset + kIndexOffset) != Smi::FromInt(index)) {
+      continue;
+    }
+    if (String::cast(cache->get(offset + kStringOffset))->Equals(subject)) {
+      return cache->get(offset + kResultOffset);
+    }
+  }
+  return Smi::FromInt(0);
+}
+
+
+void RegExpExecCache::Enter(Isolate* isolate, Handle<String> subject,
+                            Handle<FixedArray> data, int index,
+                            int32_t* registers, int register_count) {
+  if (subject->length() > kMaxSubjectLength) return;
+  uint32_t hash = KeyHash(*subject, *data, index);
+  if (!subject->IsInternalizedString()) {
+    // Most subjects are only matched once. Remember the key the first time
+    // and only enter it when it comes back.
+    FixedArray* cache = isolate->heap()->regexp_exec_cache();
+    int seen_index = kSeenKeysIndex + (hash & (kEntryCount - 1));
+    Smi* seen_hash = Smi::FromInt(hash & Smi::kMaxValue);
+    if (cache->get(seen_index) != seen_hash) {
+      cache->set(seen_index, seen_hash);
+      return;
+    }
+  }
+
+  Factory* factory = isolate->factory();
+  Handle<String> key = subject;
+  if (!key->IsSeqString() && !key->IsExternalString()) {
+    // A sliced or cons string keeps other strings alive, which the budget
+    // below does not account for. Keep a sequential copy instead.
+    key = String::Flatten(key);
+    int length = key->length();
+    if (key->IsOneByteRepresentation()) {
+      Handle<SeqOneByteString> copy =
+          factory->NewRawOneByteString(length).ToHandleChecked();
+      DisallowHeapAllocation no_gc;
+      String::WriteToFlat(*key, copy->GetChars(), 0, length);
+      key = copy;
+    } else {
+      Handle<SeqTwoByteString> copy =
+          factory->NewRawTwoByteString(length).ToHandleChecked();
+      DisallowHeapAllocation no_gc;
+      String::WriteToFlat(*key, copy->GetChars(), 0, length);
+      key = copy;
+    }
+  }
+  Handle<Object> result = factory->null_value();
+  if (registers != NULL) {
+    Handle<ByteArray> array =
+        factory->NewByteArray(register_count * kIntSize, TENURED);
+    MemCopy(array->GetDataStartAddress(), registers,
+            register_count * kIntSize);
+    result = array;
+  }
+
+  DisallowHeapAllocation no_allocation;
+  FixedArray* cache = isolate->heap()->regexp_exec_cache();
+  int offset = EntryOffset(hash, 0);
+  // Take a free slot if there is one, otherwise evict the entry that keeps
+  // more bytes alive.
+  if (cache->get(offset + kPatternOffset)->IsFixedArray()) {
+    int other = EntryOffset(hash, 1);
+    if (!cache->get(other + kPatternOffset)->IsFixedArray() ||
+        EntryBytes(cache, other) > EntryBytes(cache, offset)) {
+      offset = other;
+    }
+  }
+  int bytes = Smi::cast(cache->get(kBytesIndex))->value() -
+              EntryBytes(cache, offset);
+  cache->set(offset + kStringOffset, *key);
+  cache->set(offset + kPatternOffset, *data);
+  cache->set(offset + kIndexOffset, Smi::FromInt(index));
+  cache->set(offset + kResultOffset, *result);
+  bytes += EntryBytes(cache, offset);
+  if (bytes > kMaxBytes) {
+    // Start over rather than keep too many subjects alive until the next
+    // mark-compact.
+    Clear(cache);
+    return;
+  }
+  cache->set(kBytesIndex, Smi::FromInt(bytes));
+}
+
+
+void RegExpExecCache::Clear(FixedArray* cache) {
+  STATIC_ASSERT(kRegExpExecCacheSize == kSeenKeysIndex + kEntryCount);
+  for (int i = 0; i < kRegExpExecCacheSize; i++) {
+    cache->set(i, Smi::FromInt(0));
+  }
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -77,7 +77,13 @@ class RegExpImpl {
                                  int index,
                                  Handle<JSArray> lastMatchInfo);
 
-  enum IrregexpResult { RE_FAILURE = 0, RE_SUCCESS = 1, RE_EXCEPTION = -1 };
+  enum IrregexpResult {
+    RE_FAILURE = 0,
+    RE_SUCCESS = 1,
+    RE_EXCEPTION = -1,
+    // The interpreter exceeded the backtrack budget of the regexp.
+    RE_FALLBACK_TO_LINEAR = -2
+  };
 
   // Prepare a RegExp for being executed one or more times (using
   // IrregexpExecOnce) on the subject.
@@ -202,6 +208,9 @@ class RegExpImpl {
   static int IrregexpNumberOfRegisters(FixedArray* re);
   static ByteArray* IrregexpByteCode(FixedArray* re, bool is_one_byte);
   static Code* IrregexpNativeCode(FixedArray* re, bool is_one_byte);
+  // Whether subjects of the given representation are matched by the
+  // bytecode interpreter rather than by native code.
+  static bool IrregexpUsesByteCode(FixedArray* re, bool is_one_byte);
 
   // Limit the space regexps take up on the heap.  In order to limit this we
   // would like to keep track of the amount of regexp code on the heap.  This
@@ -212,12 +221,24 @@ class RegExpImpl {
   static const int kRegExpCompiledLimit = 1 * MB;
   static const int kRegExpTooLargeToOptimize = 20 * KB;
 
+  // Regexps executed on subjects at least this long are compiled to native
+  // code right away instead of being interpreted first.
+  static const int kRegExpTierUpSubjectLength = 1000;
+
  private:
   static bool CompileIrregexp(Handle<JSRegExp> re,
-                              Handle<String> sample_subject, bool is_one_byte);
+                              Handle<String> sample_subject, bool is_one_byte,
+                              bool use_bytecode);
   static inline bool EnsureCompiledIrregexp(Handle<JSRegExp> re,
                                             Handle<String> sample_subject,
                                             bool is_one_byte);
+  static bool IrregexpShouldTierUp(Handle<JSRegExp> re,
+                                   Handle<String> subject);
+  // Whether the interpreter enforces a backtrack budget on the regexp, after
+  // which it switches to the linear-time NFA engine.
+  static bool IrregexpHasNfaFallback(FixedArray* re);
+  static int LinearExecRaw(Handle<JSRegExp> regexp, Handle<String> subject,
+                           int index, int32_t* output, int output_size);
 };
 
 
@@ -1225,6 +1246,7 @@ class BoyerMooreLookahead : public ZoneObject {
                    int max_lookahead,
                    Handle<ByteArray> boolean_skip_table);
   bool FindWorthwhileInterval(int* from, int* to);
+  bool EmitSkipUntilCharacter(RegExpMacroAssembler* masm);
   int FindBestInterval(
     int max_number_of_chars, int old_biggest_points, int* from, int* to);
 };
@@ -1557,7 +1579,7 @@ class RegExpEngine: public AllStatic {
                                    JSRegExp::Flags flags,
                                    Handle<String> pattern,
                                    Handle<String> sample_subject,
-                                   bool is_one_byte);
+                                   bool is_one_byte, bool use_bytecode);
 
   static bool TooMuchRegExpCode(Handle<String> pattern);
 
@@ -1589,6 +1611,47 @@ class RegExpResultsCache : public AllStatic {
   static const int kLastMatchOffset = 3;
 };
 
+
+// Caches the result of executing a regexp on a short subject from a given
+// index, so that matching the same strings against the same regexps over
+// and over (e.g. in a routing table) does not run the matcher again. Subjects
+// are compared by content. Only internalized subjects and subjects that were
+// seen before are entered. Entries survive scavenges and are dropped at the
+// next mark-compact, or earlier when they keep too many bytes alive.
+class RegExpExecCache : public AllStatic {
+ public:
+  // Returns the capture registers of a successful match as a ByteArray, the
+  // null value for a failed match, or Smi 0 if there is no entry.
+  static Object* Lookup(Heap* heap, String* subject, FixedArray* data,
+                        int index);
+  // Adds the result of a match. Registers is NULL if the match failed.
+  static void Enter(Isolate* isolate, Handle<String> subject,
+                    Handle<FixedArray> data, int index, int32_t* registers,
+                    int register_count);
+  static void Clear(FixedArray* cache);
+
+  static const int kMaxSubjectLength = 1024;
+  // Bound on the bytes of subjects and registers kept alive by the cache.
+  static const int kMaxBytes = 256 * KB;
+  static const int kEntryCount = 0x100;
+  // Four slots per entry, one for the number of bytes in use and one per
+  // entry for the hashes of recently seen keys.
+  static const int kRegExpExecCacheSize = kEntryCount * 4 + 1 + kEntryCount;
+
+ private:
+  static const int kArrayEntriesPerCacheEntry = 4;
+  static const int kStringOffset = 0;
+  static const int kPatternOffset = 1;
+  static const int kIndexOffset = 2;
+  static const int kResultOffset = 3;
+  static const int kBytesIndex = kEntryCount * kArrayEntriesPerCacheEntry;
+  static const int kSeenKeysIndex = kBytesIndex + 1;
+
+  static uint32_t KeyHash(String* subject, FixedArray* data, int index);
+  static int EntryOffset(uint32_t hash, int probe);
+  static int EntryBytes(FixedArray* cache, int offset);
+};
+
 }  // namespace internal
 }  // namespace v8
 
@@ -132,6 +132,20 @@ void RegExpMacroAssemblerTracer::SetRegister(int register_index, int to) {
 }
 
 
+bool RegExpMacroAssemblerTracer::SkipUntilCharacter(int cp_offset,
+                                                    const uc16* chars,
+                                                    int count, uc16 mask) {
+  bool supported =
+      assembler_->SkipUntilCharacter(cp_offset, chars, count, mask);
+  PrintF(" SkipUntilCharacter(cp_offset=%d, chars=", cp_offset);
+  for (int i = 0; i < count; i++) {
+    PrintF("%s0x%04x", i == 0 ? "" : "|", chars[i]);
+  }
+  PrintF(", mask=0x%04x): %s;\n", mask, supported ? "true" : "false");
+  return supported;
+}
+
+
 void RegExpMacroAssemblerTracer::WriteCurrentPositionToRegister(int reg,
                                                                 int cp_offset) {
   PrintF(" WriteCurrentPositionToRegister(register=%d,cp_offset=%d);\n",
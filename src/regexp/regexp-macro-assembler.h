@@ -34,6 +34,8 @@ class RegExpMacroAssembler {
   static const int kTableSizeBits = 7;
   static const int kTableSize = 1 << kTableSizeBits;
   static const int kTableMask = kTableSize - 1;
+  // The largest character set SkipUntilCharacter is asked to search for.
+  static const int kMaxSkipCharacters = 2;
 
   enum IrregexpImplementation {
     kIA32Implementation,
@@ -148,6 +150,14 @@ class RegExpMacroAssembler {
   virtual void ReadStackPointerFromRegister(int reg) = 0;
   virtual void SetCurrentPositionFromEnd(int by) = 0;
   virtual void SetRegister(int register_index, int to) = 0;
+  // Advances the current position to the first position at or after it where
+  // the character cp_offset characters ahead, and-ed with mask, is one of the
+  // count characters in chars. If there is none, the position is advanced
+  // until that character would be past the end of the input. Clobbers the
+  // current character. Returns false, without emitting any code, if there is
+  // no faster way to do this than loading one character at a time.
+  virtual bool SkipUntilCharacter(int cp_offset, const uc16* chars, int count,
+                                  uc16 mask);
   // Return whether the matching (with a global regexp) will be restarted.
   virtual bool Succeed() = 0;
   virtual void WriteCurrentPositionToRegister(int reg, int cp_offset) = 0;
@@ -0,0 +1,590 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/regexp-nfa.h"
+
+#include "src/char-predicates-inl.h"
+#include "src/factory.h"
+#include "src/regexp/regexp-ast.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Instructions of an NFA program. Operands follow the opcode as 32-bit words.
+enum NfaOpcode {
+  NFA_CHAR,    // c: Consume the code unit c.
+  NFA_CLASS,   // n, from_1, to_1, ..., from_n, to_n: Consume a code unit in
+               // one of the n sorted, disjoint ranges.
+  NFA_ASSERT,  // type: Continue if the RegExpAssertion of that type holds.
+  NFA_SPLIT,   // x, y: Continue at x, and with lower priority at y.
+  NFA_JUMP,    // x: Continue at x.
+  NFA_SAVE,    // r: Store the current position in register r.
+  NFA_CLEAR,   // from, to: Reset registers from to to (inclusive) to -1.
+  NFA_MATCH    // Report a match.
+};
+
+// The program starts with the number of threads and the number of pending
+// split branches the matcher needs room for.
+const int kThreadCountIndex = 0;
+const int kSplitCountIndex = 1;
+const int kProgramStart = 2;
+
+// Bounds the memory the matcher allocates for thread registers.
+const int kMaxMatcherRegisters = 4 * MB;
+
+
+class NfaCanBeHandledVisitor final : public RegExpVisitor {
+ public:
+  static bool Check(RegExpTree* tree) {
+    NfaCanBeHandledVisitor visitor;
+    tree->Accept(&visitor, NULL);
+    return visitor.result_;
+  }
+
+  void* VisitDisjunction(RegExpDisjunction* node, void*) override {
+    ZoneList<RegExpTree*>* alternatives = node->alternatives();
+    for (int i = 0; result_ && i < alternatives->length(); i++) {
+      alternatives->at(i)->Accept(this, NULL);
+    }
+    return NULL;
+  }
+
+  void* VisitAlternative(RegExpAlternative* node, void*) override {
+    ZoneList<RegExpTree*>* nodes = node->nodes();
+    for (int i = 0; result_ && i < nodes->length(); i++) {
+      nodes->at(i)->Accept(this, NULL);
+    }
+    return NULL;
+  }
+
+  void* VisitAssertion(RegExpAssertion* node, void*) override { return NULL; }
+
+  void* VisitCharacterClass(RegExpCharacterClass* node, void*) override {
+    return NULL;
+  }
+
+  void* VisitAtom(RegExpAtom* node, void*) override { return NULL; }
+
+  void* VisitText(RegExpText* node, void*) override { return NULL; }
+
+  void* VisitQuantifier(RegExpQuantifier* node, void*) override {
+    // An iteration that matches the empty string fails in a backtracking
+    // engine, which an NFA can't express.
+    if (node->is_possessive() ||
+        (node->body()->min_match() == 0 && node->max() > node->min())) {
+      result_ = false;
+      return NULL;
+    }
+    return node->body()->Accept(this, NULL);
+  }
+
+  void* VisitCapture(RegExpCapture* node, void*) override {
+    return node->body()->Accept(this, NULL);
+  }
+
+  void* VisitLookaround(RegExpLookaround* node, void*) override {
+    result_ = false;
+    return NULL;
+  }
+
+  void* VisitBackReference(RegExpBackReference* node, void*) override {
+    result_ = false;
+    return NULL;
+  }
+
+  void* VisitEmpty(RegExpEmpty* node, void*) override { return NULL; }
+
+ private:
+  NfaCanBeHandledVisitor() : result_(true) {}
+
+  bool result_;
+};
+
+
+class NfaCompiler final : public RegExpVisitor {
+ public:
+  NfaCompiler(Isolate* isolate, Zone* zone, JSRegExp::Flags flags)
+      : isolate_(isolate),
+        zone_(zone),
+        ignore_case_((flags & JSRegExp::kIgnoreCase) != 0),
+        code_(64, zone),
+        thread_count_(0),
+        split_count_(0),
+        too_big_(false) {}
+
+  // Returns false if the program got too large.
+  bool Compile(RegExpTree* tree) {
+    Emit(0);  // Thread count, patched below.
+    Emit(0);  // Split count, patched below.
+    DCHECK_EQ(kProgramStart, code_.length());
+    // Capture 0 spans the whole match.
+    Emit(NFA_SAVE);
+    Emit(0);
+    tree->Accept(this, NULL);
+    Emit(NFA_SAVE);
+    Emit(1);
+    Emit(NFA_MATCH);
+    thread_count_++;
+    code_[kThreadCountIndex] = thread_count_;
+    code_[kSplitCountIndex] = split_count_;
+    return !too_big_;
+  }
+
+  ZoneList<int32_t>* code() { return &code_; }
+  int thread_count() const { return thread_count_; }
+  int split_count() const { return split_count_; }
+
+  void* VisitDisjunction(RegExpDisjunction* node, void*) override {
+    ZoneList<RegExpTree*>* alternatives = node->alternatives();
+    ZoneList<int> jumps(alternatives->length(), zone_);
+    for (int i = 0; i < alternatives->length() - 1; i++) {
+      int split = EmitSplit();
+      alternatives->at(i)->Accept(this, NULL);
+      jumps.Add(EmitJump(), zone_);
+      PatchSplit(split, split + kSplitLength, pc());
+    }
+    alternatives->last()->Accept(this, NULL);
+    for (int i = 0; i < jumps.length(); i++) PatchJump(jumps[i], pc());
+    return NULL;
+  }
+
+  void* VisitAlternative(RegExpAlternative* node, void*) override {
+    ZoneList<RegExpTree*>* nodes = node->nodes();
+    for (int i = 0; i < nodes->length(); i++) nodes->at(i)->Accept(this, NULL);
+    return NULL;
+  }
+
+  void* VisitAssertion(RegExpAssertion* node, void*) override {
+    Emit(NFA_ASSERT);
+    Emit(node->assertion_type());
+    return NULL;
+  }
+
+  void* VisitCharacterClass(RegExpCharacterClass* node, void*) override {
+    EmitClass(node->ranges(zone_), node->is_negated());
+    return NULL;
+  }
+
+  void* VisitAtom(RegExpAtom* node, void*) override {
+    Vector<const uc16> data = node->data();
+    for (int i = 0; i < data.length(); i++) {
+      if (ignore_case_) {
+        EmitClass(CharacterRange::List(zone_,
+                                       CharacterRange::Singleton(data[i])),
+                  false);
+      } else {
+        EmitChar(data[i]);
+      }
+    }
+    return NULL;
+  }
+
+  void* VisitText(RegExpText* node, void*) override {
+    ZoneList<TextElement>* elements = node->elements();
+    for (int i = 0; i < elements->length(); i++) {
+      elements->at(i).tree()->Accept(this, NULL);
+    }
+    return NULL;
+  }
+
+  void* VisitQuantifier(RegExpQuantifier* node, void*) override {
+    RegExpTree* body = node->body();
+    Interval registers = body->CaptureRegisters();
+    bool is_greedy = node->is_greedy();
+    for (int i = 0; i < node->min() && !too_big_; i++) {
+      EmitIteration(body, registers);
+    }
+    if (node->max() == RegExpTree::kInfinity) {
+      int split = EmitSplit();
+      EmitIteration(body, registers);
+      PatchJump(EmitJump(), split);
+      PatchQuantifierSplit(split, pc(), is_greedy);
+    } else {
+      // Each optional iteration may be skipped to the end of the quantifier.
+      ZoneList<int> splits(4, zone_);
+      for (int i = node->min(); i < node->max() && !too_big_; i++) {
+        splits.Add(EmitSplit(), zone_);
+        EmitIteration(body, registers);
+      }
+      for (int i = 0; i < splits.length(); i++) {
+        PatchQuantifierSplit(splits[i], pc(), is_greedy);
+      }
+    }
+    return NULL;
+  }
+
+  void* VisitCapture(RegExpCapture* node, void*) override {
+    Emit(NFA_SAVE);
+    Emit(RegExpCapture::StartRegister(node->index()));
+    node->body()->Accept(this, NULL);
+    Emit(NFA_SAVE);
+    Emit(RegExpCapture::EndRegister(node->index()));
+    return NULL;
+  }
+
+  void* VisitLookaround(RegExpLookaround* node, void*) override {
+    UNREACHABLE();
+    return NULL;
+  }
+
+  void* VisitBackReference(RegExpBackReference* node, void*) override {
+    UNREACHABLE();
+    return NULL;
+  }
+
+  void* VisitEmpty(RegExpEmpty* node, void*) override { return NULL; }
+
+ private:
+  static const int kSplitLength = 3;
+
+  int pc() const { return code_.length(); }
+
+  void Emit(int32_t word) {
+    code_.Add(word, zone_);
+    if (code_.length() > RegExpNfa::kMaxProgramLength) too_big_ = true;
+  }
+
+  void EmitChar(uc16 c) {
+    Emit(NFA_CHAR);
+    Emit(c);
+    thread_count_++;
+  }
+
+  void EmitClass(ZoneList<CharacterRange>* ranges, bool is_negated) {
+    ZoneList<CharacterRange>* set =
+        new (zone_) ZoneList<CharacterRange>(ranges->length(), zone_);
+    set->AddAll(*ranges, zone_);
+    if (ignore_case_) {
+      CharacterRange::AddCaseEquivalents(isolate_, zone_, set, false);
+    }
+    CharacterRange::Canonicalize(set);
+    if (is_negated) {
+      ZoneList<CharacterRange>* negated =
+          new (zone_) ZoneList<CharacterRange>(set->length() + 1, zone_);
+      CharacterRange::Negate(set, negated, zone_);
+      set = negated;
+    }
+    if (set->length() == 1 && set->at(0).IsSingleton() &&
+        set->at(0).from() <= String::kMaxUtf16CodeUnit) {
+      EmitChar(set->at(0).from());
+      return;
+    }
+    Emit(NFA_CLASS);
+    Emit(set->length());
+    for (int i = 0; i < set->length(); i++) {
+      Emit(set->at(i).from());
+      Emit(set->at(i).to());
+    }
+    thread_count_++;
+  }
+
+  // Captures inside a quantified body are reset on every iteration.
+  void EmitIteration(RegExpTree* body, Interval registers) {
+    if (!registers.is_empty()) {
+      Emit(NFA_CLEAR);
+      Emit(registers.from());
+      Emit(registers.to());
+    }
+    body->Accept(this, NULL);
+  }
+
+  int EmitSplit() {
+    int split = pc();
+    Emit(NFA_SPLIT);
+    Emit(0);
+    Emit(0);
+    split_count_++;
+    return split;
+  }
+
+  int EmitJump() {
+    int jump = pc();
+    Emit(NFA_JUMP);
+    Emit(0);
+    return jump;
+  }
+
+  void PatchSplit(int split, int first, int second) {
+    DCHECK_EQ(NFA_SPLIT, code_[split]);
+    code_[split + 1] = first;
+    code_[split + 2] = second;
+  }
+
+  // The body of a quantifier follows its split.
+  void PatchQuantifierSplit(int split, int exit, bool is_greedy) {
+    int body = split + kSplitLength;
+    if (is_greedy) {
+      PatchSplit(split, body, exit);
+    } else {
+      PatchSplit(split, exit, body);
+    }
+  }
+
+  void PatchJump(int jump, int target) {
+    DCHECK_EQ(NFA_JUMP, code_[jump]);
+    code_[jump + 1] = target;
+  }
+
+  Isolate* isolate_;
+  Zone* zone_;
+  bool ignore_case_;
+  ZoneList<int32_t> code_;
+  int thread_count_;
+  int split_count_;
+  bool too_big_;
+};
+
+
+bool IsLineTerminatorChar(uc16 c) {
+  return c == '\n' || c == '\r' || c == 0x2028 || c == 0x2029;
+}
+
+
+template <typename Char>
+class NfaMatcher {
+ public:
+  NfaMatcher(Zone* zone, const int32_t* code, int code_length,
+             int register_count)
+      : code_(code), register_count_(register_count) {
+    int thread_count = code[kThreadCountIndex];
+    int split_count = code[kSplitCountIndex];
+    visited_ = zone->NewArray<int>(code_length);
+    for (int i = 0; i < code_length; i++) visited_[i] = 0;
+    InitializeList(zone, &current_, thread_count);
+    InitializeList(zone, &next_, thread_count);
+    stack_pcs_ = zone->NewArray<int>(split_count + 1);
+    stack_registers_ =
+        zone->NewArray<int>((split_count + 1) * register_count);
+    scratch_registers_ = zone->NewArray<int>(register_count);
+    initial_registers_ = zone->NewArray<int>(register_count);
+    for (int i = 0; i < register_count; i++) initial_registers_[i] = -1;
+  }
+
+  RegExpImpl::IrregexpResult Match(Vector<const Char> subject,
+                                   int start_position, bool sticky,
+                                   int* output) {
+    subject_ = subject;
+    ThreadList* current = &current_;
+    ThreadList* next = &next_;
+    bool matched = false;
+    current->length = 0;
+    AddThread(current, kProgramStart, initial_registers_, start_position);
+    for (int position = start_position;; position++) {
+      next->length = 0;
+      for (int i = 0; i < current->length; i++) {
+        int pc = current->pcs[i];
+        int* registers = ThreadRegisters(current, i);
+        if (code_[pc] == NFA_MATCH) {
+          CopyRegisters(output, registers);
+          matched = true;
+          // Threads of lower priority can't produce a preferred match.
+          break;
+        }
+        if (position == subject.length()) continue;
+        uc16 c = subject[position];
+        if (code_[pc] == NFA_CHAR) {
+          if (code_[pc + 1] == c) {
+            AddThread(next, pc + 2, registers, position + 1);
+          }
+        } else {
+          DCHECK_EQ(NFA_CLASS, code_[pc]);
+          if (InClass(pc, c)) {
+            AddThread(next, pc + 2 + 2 * code_[pc + 1], registers,
+                      position + 1);
+          }
+        }
+      }
+      if (position == subject.length()) break;
+      if (!matched && !sticky) {
+        // Start a new attempt at the next position, with the lowest priority.
+        AddThread(next, kProgramStart, initial_registers_, position + 1);
+      } else if (next->length == 0) {
+        break;
+      }
+      std::swap(current, next);
+    }
+    return matched ? RegExpImpl::RE_SUCCESS : RegExpImpl::RE_FAILURE;
+  }
+
+ private:
+  struct ThreadList {
+    int* pcs;
+    int* registers;
+    int length;
+  };
+
+  void InitializeList(Zone* zone, ThreadList* list, int capacity) {
+    list->pcs = zone->NewArray<int>(capacity);
+    list->registers = zone->NewArray<int>(capacity * register_count_);
+    list->length = 0;
+  }
+
+  int* ThreadRegisters(ThreadList* list, int index) {
+    return &list->registers[index * register_count_];
+  }
+
+  void CopyRegisters(int* to, const int* from) {
+    MemCopy(to, from, register_count_ * sizeof(int));
+  }
+
+  // Adds the threads reachable from pc without consuming a character, in
+  // priority order. Each instruction is visited at most once per position,
+  // by the thread of highest priority that reaches it.
+  void AddThread(ThreadList* list, int pc, const int* registers,
+                 int position) {
+    int stamp = position + 1;
+    int* current = scratch_registers_;
+    int stack_length = 0;
+    Push(&stack_length, pc, registers);
+    while (stack_length > 0) {
+      stack_length--;
+      pc = stack_pcs_[stack_length];
+      CopyRegisters(current, &stack_registers_[stack_length * register_count_]);
+      while (visited_[pc] != stamp) {
+        visited_[pc] = stamp;
+        int opcode = code_[pc];
+        if (opcode == NFA_JUMP) {
+          pc = code_[pc + 1];
+        } else if (opcode == NFA_SPLIT) {
+          Push(&stack_length, code_[pc + 2], current);
+          pc = code_[pc + 1];
+        } else if (opcode == NFA_SAVE) {
+          current[code_[pc + 1]] = position;
+          pc += 2;
+        } else if (opcode == NFA_CLEAR) {
+          for (int r = code_[pc + 1]; r <= code_[pc + 2]; r++) current[r] = -1;
+          pc += 3;
+        } else if (opcode == NFA_ASSERT) {
+          if (!CheckAssertion(code_[pc + 1], position)) break;
+          pc += 2;
+        } else {
+          int index = list->length++;
+          list->pcs[index] = pc;
+          CopyRegisters(ThreadRegisters(list, index), current);
+          break;
+        }
+      }
+    }
+  }
+
+  void Push(int* stack_length, int pc, const int* registers) {
+    stack_pcs_[*stack_length] = pc;
+    CopyRegisters(&stack_registers_[*stack_length * register_count_],
+                  registers);
+    (*stack_length)++;
+  }
+
+  bool InClass(int pc, uc16 c) {
+    const int32_t* ranges = &code_[pc + 2];
+    int low = 0;
+    int high = code_[pc + 1] - 1;
+    while (low <= high) {
+      int mid = low + (high - low) / 2;
+      if (c < ranges[2 * mid]) {
+        high = mid - 1;
+      } else if (c > ranges[2 * mid + 1]) {
+        low = mid + 1;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool CheckAssertion(int type, int position) {
+    int length = subject_.length();
+    switch (type) {
+      case RegExpAssertion::START_OF_INPUT:
+        return position == 0;
+      case RegExpAssertion::END_OF_INPUT:
+        return position == length;
+      case RegExpAssertion::START_OF_LINE:
+        return position == 0 || IsLineTerminatorChar(subject_[position - 1]);
+      case RegExpAssertion::END_OF_LINE:
+        return position == length || IsLineTerminatorChar(subject_[position]);
+      case RegExpAssertion::BOUNDARY:
+      case RegExpAssertion::NON_BOUNDARY: {
+        bool word_before = position > 0 && IsRegExpWord(subject_[position - 1]);
+        bool word_after =
+            position < length && IsRegExpWord(subject_[position]);
+        return (word_before != word_after) ==
+               (type == RegExpAssertion::BOUNDARY);
+      }
+    }
+    UNREACHABLE();
+    return false;
+  }
+
+  const int32_t* code_;
+  int register_count_;
+  Vector<const Char> subject_;
+  int* visited_;
+  ThreadList current_;
+  ThreadList next_;
+  int* stack_pcs_;
+  int* stack_registers_;
+  int* scratch_registers_;
+  int* initial_registers_;
+};
+
+}  // namespace
+
+
+bool RegExpNfa::CanBeHandled(RegExpTree* tree, JSRegExp::Flags flags) {
+  if (flags & JSRegExp::kUnicode) return false;
+  return NfaCanBeHandledVisitor::Check(tree);
+}
+
+
+MaybeHandle<ByteArray> RegExpNfa::Compile(Isolate* isolate, Zone* zone,
+                                          RegExpTree* tree,
+                                          JSRegExp::Flags flags,
+                                          int capture_count) {
+  DCHECK(CanBeHandled(tree, flags));
+  NfaCompiler compiler(isolate, zone, flags);
+  if (!compiler.Compile(tree)) return MaybeHandle<ByteArray>();
+  int register_count = (capture_count + 1) * 2;
+  int64_t matcher_registers =
+      static_cast<int64_t>(2 * compiler.thread_count() +
+                           compiler.split_count() + 3) *
+      register_count;
+  if (matcher_registers > kMaxMatcherRegisters) return MaybeHandle<ByteArray>();
+
+  ZoneList<int32_t>* code = compiler.code();
+  Handle<ByteArray> program =
+      isolate->factory()->NewByteArray(code->length() * kInt32Size, TENURED);
+  for (int i = 0; i < code->length(); i++) program->set_int(i, code->at(i));
+  return program;
+}
+
+
+RegExpImpl::IrregexpResult RegExpNfa::Match(Isolate* isolate,
+                                            Handle<ByteArray> program,
+                                            Handle<String> subject,
+                                            int* registers,
+                                            int register_count,
+                                            int start_position, bool sticky) {
+  DCHECK(subject->IsFlat());
+  Zone zone(isolate->allocator());
+  DisallowHeapAllocation no_gc;
+  const int32_t* code =
+      reinterpret_cast<const int32_t*>(program->GetDataStartAddress());
+  int code_length = program->length() / kInt32Size;
+  String::FlatContent subject_content = subject->GetFlatContent();
+  if (subject_content.IsOneByte()) {
+    NfaMatcher<uint8_t> matcher(&zone, code, code_length, register_count);
+    return matcher.Match(subject_content.ToOneByteVector(), start_position,
+                         sticky, registers);
+  } else {
+    DCHECK(subject_content.IsTwoByte());
+    NfaMatcher<uc16> matcher(&zone, code, code_length, register_count);
+    return matcher.Match(subject_content.ToUC16Vector(), start_position,
+                         sticky, registers);
+  }
+}
+
+}  // namespace internal
+}  // namespace v8
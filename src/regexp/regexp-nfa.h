@@ -0,0 +1,52 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A linear-time matcher for regexps without back references and lookarounds.
+
+#ifndef V8_REGEXP_REGEXP_NFA_H_
+#define V8_REGEXP_REGEXP_NFA_H_
+
+#include "src/regexp/jsregexp.h"
+
+namespace v8 {
+namespace internal {
+
+class RegExpTree;
+
+// Compiles a parsed regexp to a Thompson NFA and simulates it on the subject
+// with all threads in lock step (a Pike VM). Threads are kept in priority
+// order, so the match found is the one a backtracking engine would find, but
+// every character of the subject is looked at a bounded number of times.
+class RegExpNfa : public AllStatic {
+ public:
+  // Whether the regexp can be matched by the NFA. Back references,
+  // lookarounds, unicode regexps and quantifiers whose body can match the
+  // empty string cannot.
+  static bool CanBeHandled(RegExpTree* tree, JSRegExp::Flags flags);
+
+  // Compiles the regexp to an NFA program. Returns an empty handle if the
+  // program would be too large.
+  static MaybeHandle<ByteArray> Compile(Isolate* isolate, Zone* zone,
+                                        RegExpTree* tree,
+                                        JSRegExp::Flags flags,
+                                        int capture_count);
+
+  // Finds the first match at or after start_position, or exactly at
+  // start_position if the regexp is sticky. The captures are written to
+  // registers, which has room for (capture_count + 1) * 2 values.
+  static RegExpImpl::IrregexpResult Match(Isolate* isolate,
+                                          Handle<ByteArray> program,
+                                          Handle<String> subject,
+                                          int* registers, int register_count,
+                                          int start_position, bool sticky);
+
+  // Limits the size of the program, which also bounds the work done per
+  // subject character.
+  static const int kMaxProgramLength = 64 * KB;
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_REGEXP_NFA_H_
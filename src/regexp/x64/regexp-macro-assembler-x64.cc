@@ -1140,6 +1140,81 @@ void RegExpMacroAssemblerX64::SetRegister(int register_index, int to) {
 }
 
 
+bool RegExpMacroAssemblerX64::SkipUntilCharacter(int cp_offset,
+                                                 const uc16* chars, int count,
+                                                 uc16 mask) {
+  DCHECK(cp_offset >= 0);
+  DCHECK(count >= 1 && count <= kMaxSkipCharacters);
+  // Compares a whole XMM register of characters at a time, then handles the
+  // last partial vector one character at a time. Only xmm0 to xmm5 are used,
+  // since the others are callee saved on Windows.
+  static const int kVectorSize = 16;
+  XMMRegister mask_vector = xmm0;
+  XMMRegister char_vectors[] = {xmm1, xmm2};
+  XMMRegister input = xmm3;
+  XMMRegister matches = xmm4;
+  STATIC_ASSERT(arraysize(char_vectors) == kMaxSkipCharacters);
+
+  uc16 char_mask = mode_ == LATIN1 ? String::kMaxOneByteCharCode
+                                   : String::kMaxUtf16CodeUnit;
+  bool use_mask = (mask & char_mask) != char_mask;
+  if (use_mask) BroadcastCharacter(mask_vector, mask & char_mask);
+  for (int i = 0; i < count; i++) {
+    DCHECK(chars[i] <= char_mask);
+    BroadcastCharacter(char_vectors[i], chars[i]);
+  }
+
+  int byte_offset = cp_offset * char_size();
+  Label vector_loop, scalar_loop, found, done;
+  __ bind(&vector_loop);
+  __ cmpl(rdi, Immediate(-byte_offset - kVectorSize));
+  __ j(greater, &scalar_loop);
+  __ movdqu(input, Operand(rsi, rdi, times_1, byte_offset));
+  if (use_mask) __ andps(input, mask_vector);
+  for (int i = 0; i < count; i++) {
+    // The last comparison may overwrite the input.
+    XMMRegister result = i == count - 1 ? input : matches;
+    if (!result.is(input)) __ movaps(result, input);
+    if (mode_ == LATIN1) {
+      __ pcmpeqb(result, char_vectors[i]);
+    } else {
+      __ pcmpeqw(result, char_vectors[i]);
+    }
+    if (i > 0) __ orps(input, matches);
+  }
+  __ pmovmskb(rax, input);
+  __ testl(rax, rax);
+  __ j(not_zero, &found);
+  __ addq(rdi, Immediate(kVectorSize));
+  __ jmp(&vector_loop);
+
+  __ bind(&found);
+  // The lowest set bit is the byte offset of the first matching character.
+  __ bsfl(rax, rax);
+  __ addq(rdi, rax);
+  __ jmp(&done);
+
+  __ bind(&scalar_loop);
+  __ cmpl(rdi, Immediate(-byte_offset));
+  __ j(greater_equal, &done);
+  if (mode_ == LATIN1) {
+    __ movzxbl(rax, Operand(rsi, rdi, times_1, byte_offset));
+  } else {
+    __ movzxwl(rax, Operand(rsi, rdi, times_1, byte_offset));
+  }
+  if (use_mask) __ andl(rax, Immediate(mask));
+  for (int i = 0; i < count; i++) {
+    __ cmpl(rax, Immediate(chars[i]));
+    __ j(equal, &done);
+  }
+  __ addq(rdi, Immediate(char_size()));
+  __ jmp(&scalar_loop);
+
+  __ bind(&done);
+  return true;
+}
+
+
 bool RegExpMacroAssemblerX64::Succeed() {
   __ jmp(&success_label_);
   return global();
@@ -1368,6 +1443,14 @@ void RegExpMacroAssemblerX64::CheckStackLimit() {
 }
 
 
+void RegExpMacroAssemblerX64::BroadcastCharacter(XMMRegister dst, uc16 c) {
+  uint32_t pattern = mode_ == LATIN1 ? c * 0x01010101u : c * 0x00010001u;
+  __ movl(rax, Immediate(static_cast<int32_t>(pattern)));
+  __ movd(dst, rax);
+  __ pshufd(dst, dst, 0);
+}
+
+
 void RegExpMacroAssemblerX64::LoadCurrentCharacterUnchecked(int cp_offset,
                                                             int characters) {
   if (mode_ == LATIN1) {
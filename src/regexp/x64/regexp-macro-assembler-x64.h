@@ -82,6 +82,8 @@ class RegExpMacroAssemblerX64: public NativeRegExpMacroAssembler {
   virtual void ReadStackPointerFromRegister(int reg);
   virtual void SetCurrentPositionFromEnd(int by);
   virtual void SetRegister(int register_index, int to);
+  virtual bool SkipUntilCharacter(int cp_offset, const uc16* chars, int count,
+                                  uc16 mask);
   virtual bool Succeed();
   virtual void WriteCurrentPositionToRegister(int reg, int cp_offset);
   virtual void ClearRegisters(int reg_from, int reg_to);
@@ -185,6 +187,9 @@ class RegExpMacroAssemblerX64: public NativeRegExpMacroAssembler {
   // current position, into the current-character register.
   void LoadCurrentCharacterUnchecked(int cp_offset, int character_count);
 
+  // Fills all lanes of dst with the character c.
+  void BroadcastCharacter(XMMRegister dst, uc16 c);
+
   // Check whether preemption has been requested.
   void CheckPreemption();
 
@@ -152,6 +152,17 @@ RUNTIME_FUNCTION(Runtime_ThrowWasmError) {
   return isolate->Throw(*error_obj);
 }
 
+RUNTIME_FUNCTION(Runtime_WasmCompileLazy) {
+  HandleScope scope(isolate);
+  DCHECK_EQ(0, args.length());
+  Handle<Code> code;
+  if (!wasm::CompileLazy(isolate).ToHandle(&code)) {
+    DCHECK(isolate->has_pending_exception());
+    return isolate->heap()->exception();
+  }
+  return *code;
+}
+
 RUNTIME_FUNCTION(Runtime_UnwindAndFindExceptionHandler) {
   SealHandleScope shs(isolate);
   DCHECK(args.length() == 0);
@@ -32,6 +32,16 @@ class Signature : public ZoneObject {
     return reps_[index];
   }
 
+  bool Equals(const Signature* other) const {
+    if (this == other) return true;
+    if (return_count_ != other->return_count_) return false;
+    if (parameter_count_ != other->parameter_count_) return false;
+    for (size_t i = 0; i < return_count_ + parameter_count_; ++i) {
+      if (reps_[i] != other->reps_[i]) return false;
+    }
+    return true;
+  }
+
   // For incrementally building signatures.
   class Builder {
    public:
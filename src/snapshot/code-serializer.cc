@@ -4,6 +4,11 @@
 
 #include "src/snapshot/code-serializer.h"
 
+#include <map>
+
+#include "src/base/functional.h"
+#include "src/base/lazy-instance.h"
+#include "src/base/platform/mutex.h"
 #include "src/code-stubs.h"
 #include "src/log.h"
 #include "src/macro-assembler.h"
@@ -15,7 +20,7 @@ namespace internal {
 
 ScriptData* CodeSerializer::Serialize(Isolate* isolate,
                                       Handle<SharedFunctionInfo> info,
-                                      Handle<String> source) {
+                                      Handle<String> source, int size_budget) {
   base::ElapsedTimer timer;
   if (FLAG_profile_deserialization) timer.Start();
   if (FLAG_trace_serializer) {
@@ -26,12 +31,13 @@ ScriptData* CodeSerializer::Serialize(Isolate* isolate,
   }
 
   // Serialize code object.
-  CodeSerializer cs(isolate, *source);
+  CodeSerializer cs(isolate, *source, size_budget);
   DisallowHeapAllocation no_gc;
   Object** location = Handle<Object>::cast(info).location();
   cs.VisitPointer(location);
   cs.SerializeDeferredObjects();
   cs.Pad();
+  cs.RestoreClearedObjects();
 
   SerializedCodeData data(cs.sink()->data(), &cs);
   ScriptData* script_data = data.GetScriptData();
@@ -45,6 +51,15 @@ ScriptData* CodeSerializer::Serialize(Isolate* isolate,
   return script_data;
 }
 
+CodeSerializer::CodeSerializer(Isolate* isolate, String* source,
+                               int size_budget)
+    : Serializer(isolate),
+      source_(source),
+      source_hash_(SerializedCodeData::SourceHash(source)),
+      size_budget_(size_budget) {
+  reference_map_.AddAttachedReference(source);
+}
+
 void CodeSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
                                      WhereToPoint where_to_point, int skip) {
   if (SerializeHotObject(obj, how_to_code, where_to_point, skip)) return;
@@ -60,34 +75,14 @@ void CodeSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
   FlushSkip(skip);
 
   if (obj->IsCode()) {
-    Code* code_object = Code::cast(obj);
-    switch (code_object->kind()) {
-      case Code::OPTIMIZED_FUNCTION:  // No optimized code compiled yet.
-      case Code::HANDLER:             // No handlers patched in yet.
-      case Code::REGEXP:              // No regexp literals initialized yet.
-      case Code::NUMBER_OF_KINDS:     // Pseudo enum value.
-      case Code::BYTECODE_HANDLER:    // No direct references to handlers.
-        CHECK(false);
-      case Code::BUILTIN:
-        SerializeBuiltin(code_object->builtin_index(), how_to_code,
-                         where_to_point);
-        return;
-      case Code::STUB:
-#define IC_KIND_CASE(KIND) case Code::KIND:
-        IC_KIND_LIST(IC_KIND_CASE)
-#undef IC_KIND_CASE
-        SerializeCodeStub(code_object, how_to_code, where_to_point);
-        return;
-      case Code::FUNCTION:
-        DCHECK(code_object->has_reloc_info_for_serialization());
-        SerializeGeneric(code_object, how_to_code, where_to_point);
-        return;
-      case Code::WASM_FUNCTION:
-      case Code::WASM_TO_JS_FUNCTION:
-      case Code::JS_TO_WASM_FUNCTION:
-        UNREACHABLE();
-    }
-    UNREACHABLE();
+    SerializeCodeObject(Code::cast(obj), how_to_code, where_to_point);
+    return;
+  }
+
+  if (obj->IsSharedFunctionInfo()) {
+    ClearSharedFunctionInfo(SharedFunctionInfo::cast(obj));
+  } else if (obj->IsScript()) {
+    ClearScript(Script::cast(obj));
   }
 
   // Past this point we should not see any (context-specific) maps anymore.
@@ -102,6 +97,41 @@ void CodeSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
   SerializeGeneric(obj, how_to_code, where_to_point);
 }
 
+void CodeSerializer::SerializeCodeObject(Code* code_object,
+                                         HowToCode how_to_code,
+                                         WhereToPoint where_to_point) {
+  switch (code_object->kind()) {
+    case Code::OPTIMIZED_FUNCTION:  // No optimized code compiled yet.
+    case Code::HANDLER:             // No handlers patched in yet.
+    case Code::REGEXP:              // No regexp literals initialized yet.
+    case Code::NUMBER_OF_KINDS:     // Pseudo enum value.
+    case Code::BYTECODE_HANDLER:    // No direct references to handlers.
+      CHECK(false);
+    case Code::BUILTIN:
+      SerializeBuiltin(code_object->builtin_index(), how_to_code,
+                       where_to_point);
+      return;
+    case Code::STUB:
+#define IC_KIND_CASE(KIND) case Code::KIND:
+      IC_KIND_LIST(IC_KIND_CASE)
+#undef IC_KIND_CASE
+      SerializeCodeStub(code_object, how_to_code, where_to_point);
+      return;
+    case Code::FUNCTION:
+      DCHECK(code_object->has_reloc_info_for_serialization());
+      // The code may have run already. Patched inline caches can refer to
+      // code stubs that cannot be recreated from their key.
+      code_object->ClearInlineCaches();
+      SerializeGeneric(code_object, how_to_code, where_to_point);
+      return;
+    case Code::WASM_FUNCTION:
+    case Code::WASM_TO_JS_FUNCTION:
+    case Code::JS_TO_WASM_FUNCTION:
+      UNREACHABLE();
+  }
+  UNREACHABLE();
+}
+
 void CodeSerializer::SerializeGeneric(HeapObject* heap_object,
                                       HowToCode how_to_code,
                                       WhereToPoint where_to_point) {
@@ -111,6 +141,58 @@ void CodeSerializer::SerializeGeneric(HeapObject* heap_object,
   serializer.Serialize();
 }
 
+bool CodeSerializer::ShouldSerializeLazily(SharedFunctionInfo* shared) {
+  if (shared->is_toplevel() || !shared->is_compiled()) return false;
+  Code* code = shared->code();
+  if (code->kind() == Code::FUNCTION &&
+      !code->has_reloc_info_for_serialization()) {
+    return true;
+  }
+  return size_budget_ > 0 && sink_.Position() >= size_budget_;
+}
+
+void CodeSerializer::ClearSharedFunctionInfo(SharedFunctionInfo* shared) {
+  bool lazy = ShouldSerializeLazily(shared);
+  if (!lazy && shared->OptimizedCodeMapIsCleared()) return;
+
+  ClearedSharedFunctionInfo cleared = {shared, shared->code(),
+                                       shared->function_data(),
+                                       shared->optimized_code_map()};
+  cleared_shared_infos_.Add(cleared);
+  // Optimized code is context-dependent and never serialized.
+  shared->ClearOptimizedCodeMap();
+  if (lazy) {
+    if (FLAG_trace_serializer) {
+      PrintF(" Serializing as lazy: ");
+      shared->ShortPrint();
+      PrintF("\n");
+    }
+    shared->set_code(isolate()->builtins()->builtin(Builtins::kCompileLazy));
+    if (shared->HasBytecodeArray()) shared->ClearBytecodeArray();
+  }
+}
+
+void CodeSerializer::ClearScript(Script* script) {
+  // The script wrapper is a JSValue created in some context.
+  if (script->wrapper()->IsUndefined(isolate())) return;
+  ClearedScript cleared = {script, script->wrapper()};
+  cleared_scripts_.Add(cleared);
+  script->set_wrapper(isolate()->heap()->undefined_value());
+}
+
+void CodeSerializer::RestoreClearedObjects() {
+  for (const ClearedSharedFunctionInfo& cleared : cleared_shared_infos_) {
+    cleared.shared->set_code(cleared.code);
+    cleared.shared->set_function_data(cleared.function_data);
+    cleared.shared->set_optimized_code_map(cleared.optimized_code_map);
+  }
+  cleared_shared_infos_.Clear();
+  for (const ClearedScript& cleared : cleared_scripts_) {
+    cleared.script->set_wrapper(cleared.wrapper);
+  }
+  cleared_scripts_.Clear();
+}
+
 void CodeSerializer::SerializeBuiltin(int builtin_index, HowToCode how_to_code,
                                       WhereToPoint where_to_point) {
   DCHECK((how_to_code == kPlain && where_to_point == kStartOfObject) ||
@@ -147,6 +229,19 @@ void CodeSerializer::SerializeCodeStub(Code* code_stub, HowToCode how_to_code,
   PutAttachedReference(reference, how_to_code, where_to_point);
 }
 
+namespace {
+// Adds the code stubs that the serialized code refers to by key as attached
+// objects, after those that the serializer attached first.
+void AddCodeStubs(Isolate* isolate, SerializedCodeData* scd,
+                  Deserializer* deserializer) {
+  Vector<const uint32_t> code_stub_keys = scd->CodeStubKeys();
+  for (int i = 0; i < code_stub_keys.length(); i++) {
+    deserializer->AddAttachedObject(
+        CodeStub::GetCode(isolate, code_stub_keys[i]).ToHandleChecked());
+  }
+}
+}  // namespace
+
 MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
     Isolate* isolate, ScriptData* cached_data, Handle<String> source) {
   base::ElapsedTimer timer;
@@ -154,8 +249,8 @@ MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
 
   HandleScope scope(isolate);
 
-  base::SmartPointer<SerializedCodeData> scd(
-      SerializedCodeData::FromCachedData(isolate, cached_data, *source));
+  base::SmartPointer<SerializedCodeData> scd(SerializedCodeData::FromCachedData(
+      isolate, cached_data, SerializedCodeData::SourceHash(*source)));
   if (scd.is_empty()) {
     if (FLAG_profile_deserialization) PrintF("[Cached code failed check]\n");
     DCHECK(cached_data->rejected());
@@ -164,11 +259,7 @@ MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
 
   Deserializer deserializer(scd.get());
   deserializer.AddAttachedObject(source);
-  Vector<const uint32_t> code_stub_keys = scd->CodeStubKeys();
-  for (int i = 0; i < code_stub_keys.length(); i++) {
-    deserializer.AddAttachedObject(
-        CodeStub::GetCode(isolate, code_stub_keys[i]).ToHandleChecked());
-  }
+  AddCodeStubs(isolate, scd.get(), &deserializer);
 
   // Deserialize.
   Handle<SharedFunctionInfo> result;
@@ -197,44 +288,88 @@ MaybeHandle<SharedFunctionInfo> CodeSerializer::Deserialize(
   return scope.CloseAndEscape(result);
 }
 
-class Checksum {
- public:
-  explicit Checksum(Vector<const byte> payload) {
-#ifdef MEMORY_SANITIZER
-    // Computing the checksum includes padding bytes for objects like strings.
-    // Mark every object as initialized in the code serializer.
-    MSAN_MEMORY_IS_INITIALIZED(payload.start(), payload.length());
-#endif  // MEMORY_SANITIZER
-    // Fletcher's checksum. Modified to reduce 64-bit sums to 32-bit.
-    uintptr_t a = 1;
-    uintptr_t b = 0;
-    const uintptr_t* cur = reinterpret_cast<const uintptr_t*>(payload.start());
-    DCHECK(IsAligned(payload.length(), kIntptrSize));
-    const uintptr_t* end = cur + payload.length() / kIntptrSize;
-    while (cur < end) {
-      // Unsigned overflow expected and intended.
-      a += *cur++;
-      b += a;
-    }
-#if V8_HOST_ARCH_64_BIT
-    a ^= a >> 32;
-    b ^= b >> 32;
-#endif  // V8_HOST_ARCH_64_BIT
-    a_ = static_cast<uint32_t>(a);
-    b_ = static_cast<uint32_t>(b);
+WasmCodeSerializer::WasmCodeSerializer(Isolate* isolate,
+                                       Vector<const byte> module_bytes)
+    : CodeSerializer(isolate, ModuleBytesHash(module_bytes)) {
+  reference_map_.AddAttachedReference(*isolate->native_context());
+}
+
+ScriptData* WasmCodeSerializer::Serialize(Isolate* isolate,
+                                          Handle<FixedArray> code_table,
+                                          Vector<const byte> module_bytes) {
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+
+  WasmCodeSerializer cs(isolate, module_bytes);
+  DisallowHeapAllocation no_gc;
+  Object** location = Handle<Object>::cast(code_table).location();
+  cs.VisitPointer(location);
+  cs.SerializeDeferredObjects();
+  cs.Pad();
+
+  SerializedCodeData data(cs.sink()->data(), &cs);
+  ScriptData* script_data = data.GetScriptData();
+
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    int length = script_data->length();
+    PrintF("[Serializing wasm code to %d bytes took %0.3f ms]\n", length, ms);
   }
+  return script_data;
+}
+
+MaybeHandle<FixedArray> WasmCodeSerializer::Deserialize(
+    Isolate* isolate, ScriptData* data, Vector<const byte> module_bytes) {
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+
+  HandleScope scope(isolate);
 
-  bool Check(uint32_t a, uint32_t b) const { return a == a_ && b == b_; }
+  base::SmartPointer<SerializedCodeData> scd(SerializedCodeData::FromCachedData(
+      isolate, data, ModuleBytesHash(module_bytes)));
+  if (scd.is_empty()) {
+    if (FLAG_profile_deserialization) PrintF("[Cached wasm code failed check]\n");
+    return MaybeHandle<FixedArray>();
+  }
 
-  uint32_t a() const { return a_; }
-  uint32_t b() const { return b_; }
+  Deserializer deserializer(scd.get());
+  deserializer.AddAttachedObject(isolate->native_context());
+  AddCodeStubs(isolate, scd.get(), &deserializer);
 
- private:
-  uint32_t a_;
-  uint32_t b_;
+  Handle<HeapObject> result;
+  if (!deserializer.DeserializeObject(isolate).ToHandle(&result)) {
+    // Deserializing may fail if the reservations cannot be fulfilled.
+    if (FLAG_profile_deserialization) PrintF("[Deserializing failed]\n");
+    return MaybeHandle<FixedArray>();
+  }
 
-  DISALLOW_COPY_AND_ASSIGN(Checksum);
-};
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    PrintF("[Deserializing wasm code from %d bytes took %0.3f ms]\n",
+           data->length(), ms);
+  }
+  return scope.CloseAndEscape(Handle<FixedArray>::cast(result));
+}
+
+void WasmCodeSerializer::SerializeCodeObject(Code* code_object,
+                                             HowToCode how_to_code,
+                                             WhereToPoint where_to_point) {
+  switch (code_object->kind()) {
+    case Code::WASM_FUNCTION:
+    case Code::WASM_TO_JS_FUNCTION:  // Placeholders for the imports.
+      SerializeGeneric(code_object, how_to_code, where_to_point);
+      return;
+    default:
+      CodeSerializer::SerializeCodeObject(code_object, how_to_code,
+                                          where_to_point);
+  }
+}
+
+// static
+uint32_t WasmCodeSerializer::ModuleBytesHash(Vector<const byte> module_bytes) {
+  return static_cast<uint32_t>(
+      base::hash_range(module_bytes.begin(), module_bytes.end()));
+}
 
 SerializedCodeData::SerializedCodeData(const List<byte>* payload,
                                        const CodeSerializer* cs) {
@@ -258,7 +393,7 @@ SerializedCodeData::SerializedCodeData(const List<byte>* payload,
   // Set header values.
   SetMagicNumber(cs->isolate());
   SetHeaderValue(kVersionHashOffset, Version::Hash());
-  SetHeaderValue(kSourceHashOffset, SourceHash(cs->source()));
+  SetHeaderValue(kSourceHashOffset, cs->source_hash());
   SetHeaderValue(kCpuFeaturesOffset,
                  static_cast<uint32_t>(CpuFeatures::SupportedFeatures()));
   SetHeaderValue(kFlagHashOffset, FlagList::Hash());
@@ -286,7 +421,8 @@ SerializedCodeData::SerializedCodeData(const List<byte>* payload,
 }
 
 SerializedCodeData::SanityCheckResult SerializedCodeData::SanityCheck(
-    Isolate* isolate, String* source) const {
+    Isolate* isolate, uint32_t expected_source_hash,
+    const ScriptData* cached_data) const {
   uint32_t magic_number = GetMagicNumber();
   if (magic_number != ComputeMagicNumber(isolate)) return MAGIC_NUMBER_MISMATCH;
   uint32_t version_hash = GetHeaderValue(kVersionHashOffset);
@@ -296,16 +432,52 @@ SerializedCodeData::SanityCheckResult SerializedCodeData::SanityCheck(
   uint32_t c1 = GetHeaderValue(kChecksum1Offset);
   uint32_t c2 = GetHeaderValue(kChecksum2Offset);
   if (version_hash != Version::Hash()) return VERSION_MISMATCH;
-  if (source_hash != SourceHash(source)) return SOURCE_MISMATCH;
+  if (source_hash != expected_source_hash) return SOURCE_MISMATCH;
   if (cpu_features != static_cast<uint32_t>(CpuFeatures::SupportedFeatures())) {
     return CPU_FEATURES_MISMATCH;
   }
   if (flags_hash != FlagList::Hash()) return FLAGS_MISMATCH;
-  if (!Checksum(Payload()).Check(c1, c2)) return CHECKSUM_MISMATCH;
+  // A checksum verified ahead of time only counts if the header still carries
+  // the checksum that was verified.
+  bool checksum_verified = cached_data->checksum_verified() &&
+                           cached_data->verified_checksum1() == c1 &&
+                           cached_data->verified_checksum2() == c2;
+  if (!checksum_verified && !Checksum(Payload()).Check(c1, c2)) {
+    return CHECKSUM_MISMATCH;
+  }
   return CHECK_SUCCESS;
 }
 
-uint32_t SerializedCodeData::SourceHash(String* source) const {
+bool SerializedCodeData::HasValidLayout() const {
+  if (size_ < kHeaderSize) return false;
+  uint64_t reservations_size =
+      static_cast<uint64_t>(GetHeaderValue(kNumReservationsOffset)) *
+      kInt32Size;
+  uint64_t code_stubs_size =
+      static_cast<uint64_t>(GetHeaderValue(kNumCodeStubKeysOffset)) *
+      kInt32Size;
+  uint64_t payload_offset = kHeaderSize + reservations_size + code_stubs_size;
+  uint64_t padded_payload_offset = RoundUp(payload_offset, kPointerSize);
+  uint64_t length = GetHeaderValue(kPayloadLengthOffset);
+  return padded_payload_offset + length == static_cast<uint64_t>(size_);
+}
+
+// static
+bool SerializedCodeData::VerifyChecksum(ScriptData* cached_data,
+                                        uint32_t* checksum1,
+                                        uint32_t* checksum2) {
+  SerializedCodeData scd(cached_data);
+  if (!scd.HasValidLayout()) return false;
+  uint32_t c1 = scd.GetHeaderValue(kChecksum1Offset);
+  uint32_t c2 = scd.GetHeaderValue(kChecksum2Offset);
+  if (!Checksum(scd.Payload()).Check(c1, c2)) return false;
+  *checksum1 = c1;
+  *checksum2 = c2;
+  return true;
+}
+
+// static
+uint32_t SerializedCodeData::SourceHash(String* source) {
   return source->length();
 }
 
@@ -348,18 +520,84 @@ Vector<const uint32_t> SerializedCodeData::CodeStubKeys() const {
 SerializedCodeData::SerializedCodeData(ScriptData* data)
     : SerializedData(const_cast<byte*>(data->data()), data->length()) {}
 
-SerializedCodeData* SerializedCodeData::FromCachedData(Isolate* isolate,
-                                                       ScriptData* cached_data,
-                                                       String* source) {
+SerializedCodeData* SerializedCodeData::FromCachedData(
+    Isolate* isolate, ScriptData* cached_data, uint32_t expected_source_hash) {
   DisallowHeapAllocation no_gc;
   SerializedCodeData* scd = new SerializedCodeData(cached_data);
-  SanityCheckResult r = scd->SanityCheck(isolate, source);
+  SanityCheckResult r =
+      scd->SanityCheck(isolate, expected_source_hash, cached_data);
   if (r == CHECK_SUCCESS) return scd;
   cached_data->Reject();
-  source->GetIsolate()->counters()->code_cache_reject_reason()->AddSample(r);
+  isolate->counters()->code_cache_reject_reason()->AddSample(r);
   delete scd;
   return NULL;
 }
 
+namespace {
+
+// A result of VerifyCachedDataTask: the data and length that were verified
+// and the checksum their header carried.
+struct VerifiedCachedData {
+  const uint8_t* data;
+  int length;
+  uint32_t checksum1;
+  uint32_t checksum2;
+};
+
+// The results are kept here rather than in the embedder-facing CachedData so
+// that its layout does not change.
+typedef std::map<const ScriptCompiler::CachedData*, VerifiedCachedData>
+    VerifiedCachedDataMap;
+
+base::LazyMutex verified_cached_data_mutex = LAZY_MUTEX_INITIALIZER;
+base::LazyInstance<VerifiedCachedDataMap>::type verified_cached_data =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+void VerifyCachedDataTask::Run() {
+  // ScriptData takes care of pointer-aligning the data. The checksum only
+  // depends on the bytes, so the result carries over to the copy made when
+  // the cache is consumed.
+  ScriptData script_data(cached_data_->data, cached_data_->length);
+  VerifiedCachedData result = {cached_data_->data, cached_data_->length, 0, 0};
+  if (!SerializedCodeData::VerifyChecksum(&script_data, &result.checksum1,
+                                          &result.checksum2)) {
+    return;
+  }
+  base::LockGuard<base::Mutex> lock_guard(verified_cached_data_mutex.Pointer());
+  (*verified_cached_data.Pointer())[cached_data_] = result;
+}
+
+// static
+bool VerifyCachedDataTask::GetVerifiedChecksum(
+    const ScriptCompiler::CachedData* cached_data, uint32_t* checksum1,
+    uint32_t* checksum2) {
+  base::LockGuard<base::Mutex> lock_guard(verified_cached_data_mutex.Pointer());
+  VerifiedCachedDataMap* map = verified_cached_data.Pointer();
+  VerifiedCachedDataMap::iterator it = map->find(cached_data);
+  if (it == map->end() || it->second.data != cached_data->data ||
+      it->second.length != cached_data->length) {
+    return false;
+  }
+  *checksum1 = it->second.checksum1;
+  *checksum2 = it->second.checksum2;
+  return true;
+}
+
+// static
+bool VerifyCachedDataTask::IsVerified(
+    const ScriptCompiler::CachedData* cached_data) {
+  uint32_t checksum1, checksum2;
+  return GetVerifiedChecksum(cached_data, &checksum1, &checksum2);
+}
+
+// static
+void VerifyCachedDataTask::Forget(
+    const ScriptCompiler::CachedData* cached_data) {
+  base::LockGuard<base::Mutex> lock_guard(verified_cached_data_mutex.Pointer());
+  verified_cached_data.Pointer()->erase(cached_data);
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -13,9 +13,11 @@ namespace internal {
 
 class CodeSerializer : public Serializer {
  public:
+  // If |size_budget| is positive, inner functions that are reached after the
+  // payload has grown past that many bytes are serialized as lazily compiled.
   static ScriptData* Serialize(Isolate* isolate,
                                Handle<SharedFunctionInfo> info,
-                               Handle<String> source);
+                               Handle<String> source, int size_budget = 0);
 
   MUST_USE_RESULT static MaybeHandle<SharedFunctionInfo> Deserialize(
       Isolate* isolate, ScriptData* cached_data, Handle<String> source);
@@ -25,16 +27,30 @@ class CodeSerializer : public Serializer {
     return source_;
   }
 
+  uint32_t source_hash() const { return source_hash_; }
+
   const List<uint32_t>* stub_keys() const { return &stub_keys_; }
 
- private:
-  CodeSerializer(Isolate* isolate, String* source)
-      : Serializer(isolate), source_(source) {
-    reference_map_.AddAttachedReference(source);
-  }
+ protected:
+  // Used by serializers of code that does not belong to a script.
+  CodeSerializer(Isolate* isolate, uint32_t source_hash)
+      : Serializer(isolate),
+        source_(nullptr),
+        source_hash_(source_hash),
+        size_budget_(0) {}
 
   ~CodeSerializer() override { OutputStatistics("CodeSerializer"); }
 
+  // Serializes a code object that is not yet in the reference map.
+  virtual void SerializeCodeObject(Code* code_object, HowToCode how_to_code,
+                                   WhereToPoint where_to_point);
+
+  void SerializeGeneric(HeapObject* heap_object, HowToCode how_to_code,
+                        WhereToPoint where_to_point);
+
+ private:
+  CodeSerializer(Isolate* isolate, String* source, int size_budget);
+
   void SerializeObject(HeapObject* o, HowToCode how_to_code,
                        WhereToPoint where_to_point, int skip) override;
 
@@ -42,12 +58,37 @@ class CodeSerializer : public Serializer {
                         WhereToPoint where_to_point);
   void SerializeCodeStub(Code* code_stub, HowToCode how_to_code,
                          WhereToPoint where_to_point);
-  void SerializeGeneric(HeapObject* heap_object, HowToCode how_to_code,
-                        WhereToPoint where_to_point);
+
+  // Functions compiled after the script was compiled for the code cache do
+  // not have the reloc info required for serialization. Those, and functions
+  // past the size budget, are written out as if they had never been compiled.
+  bool ShouldSerializeLazily(SharedFunctionInfo* shared);
+
+  // Context-dependent and dropped fields are cleared in the live objects while
+  // serializing, and restored afterwards.
+  void ClearSharedFunctionInfo(SharedFunctionInfo* shared);
+  void ClearScript(Script* script);
+  void RestoreClearedObjects();
+
+  struct ClearedSharedFunctionInfo {
+    SharedFunctionInfo* shared;
+    Code* code;
+    Object* function_data;
+    FixedArray* optimized_code_map;
+  };
+
+  struct ClearedScript {
+    Script* script;
+    HeapObject* wrapper;
+  };
 
   DisallowHeapAllocation no_gc_;
   String* source_;
+  uint32_t source_hash_;
+  int size_budget_;
   List<uint32_t> stub_keys_;
+  List<ClearedSharedFunctionInfo> cleared_shared_infos_;
+  List<ClearedScript> cleared_scripts_;
   DISALLOW_COPY_AND_ASSIGN(CodeSerializer);
 };
 
@@ -57,7 +98,7 @@ class SerializedCodeData : public SerializedData {
   // Used when consuming.
   static SerializedCodeData* FromCachedData(Isolate* isolate,
                                             ScriptData* cached_data,
-                                            String* source);
+                                            uint32_t expected_source_hash);
 
   // Used when producing.
   SerializedCodeData(const List<byte>* payload, const CodeSerializer* cs);
@@ -70,9 +111,19 @@ class SerializedCodeData : public SerializedData {
 
   Vector<const uint32_t> CodeStubKeys() const;
 
+  // Checks the payload checksum without touching the heap, so that it can run
+  // on a background thread ahead of FromCachedData. On success, returns the
+  // checksum stored in the header.
+  static bool VerifyChecksum(ScriptData* cached_data, uint32_t* checksum1,
+                             uint32_t* checksum2);
+
+  static uint32_t SourceHash(String* source);
+
  private:
   explicit SerializedCodeData(ScriptData* data);
 
+  bool HasValidLayout() const;
+
   enum SanityCheckResult {
     CHECK_SUCCESS = 0,
     MAGIC_NUMBER_MISMATCH = 1,
@@ -83,9 +134,9 @@ class SerializedCodeData : public SerializedData {
     CHECKSUM_MISMATCH = 6
   };
 
-  SanityCheckResult SanityCheck(Isolate* isolate, String* source) const;
-
-  uint32_t SourceHash(String* source) const;
+  SanityCheckResult SanityCheck(Isolate* isolate,
+                                uint32_t expected_source_hash,
+                                const ScriptData* cached_data) const;
 
   // The data header consists of uint32_t-sized entries:
   // [0] magic number and external reference count
@@ -113,6 +164,57 @@ class SerializedCodeData : public SerializedData {
   static const int kHeaderSize = kChecksum2Offset + kInt32Size;
 };
 
+// Serializes the code table of a compiled wasm module, as returned by
+// WasmModule::CompileFunctions before the module is instantiated. The code
+// embeds the native context, which is attached to the current native context
+// when deserializing. Memory, globals and imports are still placeholders that
+// are patched when the module is instantiated with the code table.
+class WasmCodeSerializer : public CodeSerializer {
+ public:
+  static ScriptData* Serialize(Isolate* isolate, Handle<FixedArray> code_table,
+                               Vector<const byte> module_bytes);
+
+  // Returns a null handle if the data was produced for other module bytes,
+  // another V8 version, or different flags or CPU features.
+  MUST_USE_RESULT static MaybeHandle<FixedArray> Deserialize(
+      Isolate* isolate, ScriptData* data, Vector<const byte> module_bytes);
+
+ private:
+  WasmCodeSerializer(Isolate* isolate, Vector<const byte> module_bytes);
+
+  void SerializeCodeObject(Code* code_object, HowToCode how_to_code,
+                           WhereToPoint where_to_point) override;
+
+  static uint32_t ModuleBytesHash(Vector<const byte> module_bytes);
+
+  DISALLOW_COPY_AND_ASSIGN(WasmCodeSerializer);
+};
+
+// Implementation of v8::ScriptCompiler::VerifyCachedDataTask. Runs
+// SerializedCodeData::VerifyChecksum and records the result on the embedder's
+// CachedData.
+class VerifyCachedDataTask : public ScriptCompiler::VerifyCachedDataTask {
+ public:
+  explicit VerifyCachedDataTask(ScriptCompiler::CachedData* cached_data)
+      : cached_data_(cached_data) {}
+
+  void Run() override;
+
+  // Whether Run has verified the checksum of the data the cached data
+  // currently points to. If so, returns the checksum found in the header at
+  // that time, which the consumer compares against the header it reads.
+  static bool GetVerifiedChecksum(const ScriptCompiler::CachedData* cached_data,
+                                  uint32_t* checksum1, uint32_t* checksum2);
+  static bool IsVerified(const ScriptCompiler::CachedData* cached_data);
+  // Drops the result for a cached data that is being destroyed.
+  static void Forget(const ScriptCompiler::CachedData* cached_data);
+
+ private:
+  ScriptCompiler::CachedData* cached_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerifyCachedDataTask);
+};
+
 }  // namespace internal
 }  // namespace v8
 
@@ -53,6 +53,10 @@ class Deserializer : public SerializerDeserializer {
   // Deserialize a shared function info. Fail gracefully.
   MaybeHandle<SharedFunctionInfo> DeserializeCode(Isolate* isolate);
 
+  // Deserialize code that does not belong to a script, rooted at a single
+  // object. Fail gracefully.
+  MaybeHandle<HeapObject> DeserializeObject(Isolate* isolate);
+
   // Add an object to back an attached reference. The order to add objects must
   // mirror the order they are added in the serializer.
   void AddAttachedObject(Handle<HeapObject> attached_object) {
@@ -79,7 +79,8 @@ class SnapshotWriter {
   }
 
   void WriteData(const i::Vector<const i::byte>& blob) const {
-    fprintf(fp_, "static const byte blob_data[] = {\n");
+    // Aligned, so that the checksum can be computed a word at a time.
+    fprintf(fp_, "V8_ALIGNED(8) static const byte blob_data[] = {\n");
     WriteSnapshotData(blob);
     fprintf(fp_, "};\n");
     fprintf(fp_, "static const int blob_size = %d;\n", blob.length());
@@ -83,14 +83,20 @@ void PartialSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
 
   FlushSkip(skip);
 
-  // Clear literal boilerplates.
   if (obj->IsJSFunction()) {
     JSFunction* function = JSFunction::cast(obj);
-    LiteralsArray* literals = function->literals();
-    for (int i = 0; i < literals->literals_count(); i++) {
-      literals->set_literal_undefined(i);
+    if (startup_serializer_->keep_type_feedback()) {
+      // Keep literal boilerplates and context-independent feedback, but drop
+      // property access ICs, whose handlers cannot be serialized.
+      function->feedback_vector()->ClearPropertyAccessSlots(function->shared());
+    } else {
+      // Clear literal boilerplates.
+      LiteralsArray* literals = function->literals();
+      for (int i = 0; i < literals->literals_count(); i++) {
+        literals->set_literal_undefined(i);
+      }
+      function->ClearTypeFeedbackInfo();
     }
-    function->ClearTypeFeedbackInfo();
   }
 
   // Object has not yet been serialized.  Serialize it here.
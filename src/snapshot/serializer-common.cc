@@ -7,6 +7,7 @@
 #include "src/external-reference-table.h"
 #include "src/ic/stub-cache.h"
 #include "src/list-inl.h"
+#include "src/msan.h"
 
 namespace v8 {
 namespace internal {
@@ -75,5 +76,46 @@ bool SerializerDeserializer::CanBeDeferred(HeapObject* o) {
   return !o->IsString() && !o->IsScript();
 }
 
+Checksum::Checksum(Vector<const byte> payload) {
+#ifdef MEMORY_SANITIZER
+  // Computing the checksum includes padding bytes for objects like strings.
+  // Mark every object as initialized in the code serializer.
+  MSAN_MEMORY_IS_INITIALIZED(payload.start(), payload.length());
+#endif  // MEMORY_SANITIZER
+  // Fletcher's checksum. Modified to reduce 64-bit sums to 32-bit.
+  uintptr_t a = 1;
+  uintptr_t b = 0;
+  const byte* cur = payload.start();
+  const byte* end = cur + payload.length() / kIntptrSize * kIntptrSize;
+  if (IsAligned(reinterpret_cast<intptr_t>(cur), kIntptrSize)) {
+    for (; cur < end; cur += kIntptrSize) {
+      // Unsigned overflow expected and intended.
+      a += *reinterpret_cast<const uintptr_t*>(cur);
+      b += a;
+    }
+  } else {
+    // Blobs provided by the embedder need not be aligned.
+    for (; cur < end; cur += kIntptrSize) {
+      a += ReadUnalignedValue<uintptr_t>(cur);
+      b += a;
+    }
+  }
+  // Snapshot blobs are not padded to pointer size; fold in the trailing bytes
+  // as one zero-extended word.
+  int tail = payload.length() % kIntptrSize;
+  if (tail != 0) {
+    uintptr_t last = 0;
+    memcpy(&last, cur, tail);
+    a += last;
+    b += a;
+  }
+#if V8_HOST_ARCH_64_BIT
+  a ^= a >> 32;
+  b ^= b >> 32;
+#endif  // V8_HOST_ARCH_64_BIT
+  a_ = static_cast<uint32_t>(a);
+  b_ = static_cast<uint32_t>(b);
+}
+
 }  // namespace internal
 }  // namespace v8
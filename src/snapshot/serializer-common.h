@@ -279,6 +279,24 @@ class SerializedData {
   bool owns_data_;
 };
 
+// Fletcher's checksum over serialized data, used to detect corrupted code
+// caches and snapshot blobs. Aligned data is read a word at a time.
+class Checksum {
+ public:
+  explicit Checksum(Vector<const byte> payload);
+
+  bool Check(uint32_t a, uint32_t b) const { return a == a_ && b == b_; }
+
+  uint32_t a() const { return a_; }
+  uint32_t b() const { return b_; }
+
+ private:
+  uint32_t a_;
+  uint32_t b_;
+
+  DISALLOW_COPY_AND_ASSIGN(Checksum);
+};
+
 }  // namespace internal
 }  // namespace v8
 
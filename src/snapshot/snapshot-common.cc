@@ -7,10 +7,14 @@
 #include "src/snapshot/snapshot.h"
 
 #include "src/api.h"
+#include "src/base/platform/condition-variable.h"
+#include "src/base/platform/mutex.h"
 #include "src/base/platform/platform.h"
 #include "src/full-codegen/full-codegen.h"
 #include "src/snapshot/deserializer.h"
+#include "src/snapshot/snapshot-compression.h"
 #include "src/snapshot/snapshot-source-sink.h"
+#include "src/v8.h"
 #include "src/version.h"
 
 namespace v8 {
@@ -48,8 +52,19 @@ bool Snapshot::Initialize(Isolate* isolate) {
   if (FLAG_profile_deserialization) timer.Start();
 
   const v8::StartupData* blob = isolate->snapshot_blob();
+  if (FLAG_verify_snapshot_checksum) {
+    if (blob == DefaultSnapshotBlob()) {
+      StartVerifyingDefaultChecksum();
+    } else {
+      // Custom blobs may be disposed of right after isolate creation, so they
+      // cannot be verified in the background.
+      CHECK(VerifyChecksum(blob));
+    }
+  }
   Vector<const byte> startup_data = ExtractStartupData(blob);
-  SnapshotData snapshot_data(startup_data);
+  base::SmartArrayPointer<byte> decompressed;
+  SnapshotData snapshot_data(
+      MaybeDecompress(blob, startup_data, &decompressed));
   Deserializer deserializer(&snapshot_data);
   bool success = isolate->Init(&deserializer);
   if (FLAG_profile_deserialization) {
@@ -70,7 +85,9 @@ MaybeHandle<Context> Snapshot::NewContextFromSnapshot(
   const v8::StartupData* blob = isolate->snapshot_blob();
   Vector<const byte> context_data =
       ExtractContextData(blob, static_cast<int>(context_index));
-  SnapshotData snapshot_data(context_data);
+  base::SmartArrayPointer<byte> decompressed;
+  SnapshotData snapshot_data(
+      MaybeDecompress(blob, context_data, &decompressed));
   Deserializer deserializer(&snapshot_data);
 
   MaybeHandle<Object> maybe_context =
@@ -87,6 +104,109 @@ MaybeHandle<Context> Snapshot::NewContextFromSnapshot(
   return Handle<Context>::cast(result);
 }
 
+bool Snapshot::VerifyChecksum(const v8::StartupData* data) {
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+  CHECK_LT(kChecksummedContentOffset, data->raw_size);
+  uint32_t expected_a;
+  uint32_t expected_b;
+  memcpy(&expected_a, data->data + kChecksum1Offset, kInt32Size);
+  memcpy(&expected_b, data->data + kChecksum2Offset, kInt32Size);
+  Checksum checksum(ChecksummedContent(data));
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    PrintF("[Verifying snapshot checksum (%d bytes) took %0.3f ms]\n",
+           data->raw_size, ms);
+  }
+  return checksum.Check(expected_a, expected_b);
+}
+
+namespace {
+
+enum class ChecksumState {
+  kNotStarted,
+  kPending,  // The task is posted, but not running yet.
+  kRunning,
+  kValid,
+  kInvalid
+};
+
+base::LazyMutex default_checksum_mutex = LAZY_MUTEX_INITIALIZER;
+base::LazyConditionVariable default_checksum_verified =
+    LAZY_CONDITION_VARIABLE_INITIALIZER;
+ChecksumState default_checksum_state = ChecksumState::kNotStarted;
+
+class VerifyDefaultChecksumTask : public v8::Task {
+ public:
+  explicit VerifyDefaultChecksumTask(const v8::StartupData* blob)
+      : blob_(blob) {}
+
+  void Run() override {
+    {
+      base::LockGuard<base::Mutex> lock_guard(default_checksum_mutex.Pointer());
+      // The blob was verified when the verification was cancelled, and may
+      // have been freed since.
+      if (default_checksum_state != ChecksumState::kPending) return;
+      default_checksum_state = ChecksumState::kRunning;
+    }
+    bool valid = Snapshot::VerifyChecksum(blob_);
+    base::LockGuard<base::Mutex> lock_guard(default_checksum_mutex.Pointer());
+    default_checksum_state =
+        valid ? ChecksumState::kValid : ChecksumState::kInvalid;
+    default_checksum_verified.Pointer()->NotifyAll();
+  }
+
+ private:
+  // The default blob is only freed after CancelVerifyingDefaultChecksum.
+  const v8::StartupData* blob_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerifyDefaultChecksumTask);
+};
+
+}  // namespace
+
+void Snapshot::StartVerifyingDefaultChecksum() {
+  const v8::StartupData* blob = DefaultSnapshotBlob();
+  {
+    base::LockGuard<base::Mutex> lock_guard(default_checksum_mutex.Pointer());
+    if (default_checksum_state != ChecksumState::kNotStarted) return;
+    if (blob == NULL || blob->data == NULL) {
+      // There is nothing to verify without a snapshot.
+      default_checksum_state = ChecksumState::kValid;
+      return;
+    }
+    default_checksum_state = ChecksumState::kPending;
+  }
+  V8::GetCurrentPlatform()->CallOnBackgroundThread(
+      new VerifyDefaultChecksumTask(blob), v8::Platform::kShortRunningTask);
+}
+
+bool Snapshot::DefaultChecksumIsValid() {
+  StartVerifyingDefaultChecksum();
+  base::LockGuard<base::Mutex> lock_guard(default_checksum_mutex.Pointer());
+  while (default_checksum_state == ChecksumState::kPending ||
+         default_checksum_state == ChecksumState::kRunning) {
+    default_checksum_verified.Pointer()->Wait(default_checksum_mutex.Pointer());
+  }
+  return default_checksum_state == ChecksumState::kValid;
+}
+
+void Snapshot::CancelVerifyingDefaultChecksum() {
+  base::LockGuard<base::Mutex> lock_guard(default_checksum_mutex.Pointer());
+  if (default_checksum_state == ChecksumState::kPending) {
+    // The task would run after the blob is freed. Other threads may be
+    // waiting for the result, so the blob is verified here instead.
+    bool valid = VerifyChecksum(DefaultSnapshotBlob());
+    default_checksum_state =
+        valid ? ChecksumState::kValid : ChecksumState::kInvalid;
+    default_checksum_verified.Pointer()->NotifyAll();
+    return;
+  }
+  while (default_checksum_state == ChecksumState::kRunning) {
+    default_checksum_verified.Pointer()->Wait(default_checksum_mutex.Pointer());
+  }
+}
+
 void UpdateMaxRequirementPerPage(
     uint32_t* requirements,
     Vector<const SerializedData::Reservation> reservations) {
@@ -157,13 +277,29 @@ v8::StartupData Snapshot::CreateSnapshotBlob(
     const SnapshotData* startup_snapshot,
     const List<SnapshotData*>* context_snapshots) {
   int num_contexts = context_snapshots->length();
-  int startup_snapshot_offset = StartupSnapshotOffset(num_contexts);
-  int total_length = startup_snapshot_offset;
-  total_length += startup_snapshot->RawData().length();
+  List<Vector<const byte> > payloads(num_contexts + 1);
+  payloads.Add(startup_snapshot->RawData());
   for (const auto& context_snapshot : *context_snapshots) {
-    total_length += context_snapshot->RawData().length();
+    payloads.Add(context_snapshot->RawData());
   }
 
+  // Compressed payloads are prefixed with their uncompressed size.
+  List<List<byte>*> compressed_payloads;
+  if (FLAG_compress_snapshot) {
+    for (int i = 0; i < payloads.length(); i++) {
+      List<byte>* compressed = new List<byte>();
+      int raw_size = payloads[i].length();
+      compressed->AddAll(Vector<byte>(reinterpret_cast<byte*>(&raw_size),
+                                      kInt32Size));
+      SnapshotCompression::Compress(payloads[i], compressed);
+      compressed_payloads.Add(compressed);
+      payloads[i] = compressed->ToConstVector();
+    }
+  }
+
+  int total_length = StartupSnapshotOffset(num_contexts);
+  for (const auto& payload : payloads) total_length += payload.length();
+
   uint32_t first_page_sizes[kNumPagedSpaces];
   CalculateFirstPageSizes(startup_snapshot, context_snapshots,
                           first_page_sizes);
@@ -171,11 +307,12 @@ v8::StartupData Snapshot::CreateSnapshotBlob(
   char* data = new char[total_length];
   memcpy(data + kFirstPageSizesOffset, first_page_sizes,
          kNumPagedSpaces * kInt32Size);
+  int compressed = FLAG_compress_snapshot ? 1 : 0;
+  memcpy(data + kCompressedOffset, &compressed, kInt32Size);
   memcpy(data + kNumberOfContextsOffset, &num_contexts, kInt32Size);
   int payload_offset = StartupSnapshotOffset(num_contexts);
-  int payload_length = startup_snapshot->RawData().length();
-  memcpy(data + payload_offset, startup_snapshot->RawData().start(),
-         payload_length);
+  int payload_length = payloads[0].length();
+  memcpy(data + payload_offset, payloads[0].start(), payload_length);
   if (FLAG_profile_deserialization) {
     PrintF("Snapshot blob consists of:\n%10d bytes for startup\n",
            payload_length);
@@ -183,17 +320,24 @@ v8::StartupData Snapshot::CreateSnapshotBlob(
   payload_offset += payload_length;
   for (int i = 0; i < num_contexts; i++) {
     memcpy(data + ContextSnapshotOffsetOffset(i), &payload_offset, kInt32Size);
-    SnapshotData* context_snapshot = context_snapshots->at(i);
-    payload_length = context_snapshot->RawData().length();
-    memcpy(data + payload_offset, context_snapshot->RawData().start(),
-           payload_length);
+    payload_length = payloads[i + 1].length();
+    memcpy(data + payload_offset, payloads[i + 1].start(), payload_length);
     if (FLAG_profile_deserialization) {
       PrintF("%10d bytes for context #%d\n", payload_length, i);
     }
     payload_offset += payload_length;
   }
 
+  for (const auto& compressed_payload : compressed_payloads) {
+    delete compressed_payload;
+  }
+
   v8::StartupData result = {data, total_length};
+  Checksum checksum(ChecksummedContent(&result));
+  uint32_t checksum_a = checksum.a();
+  uint32_t checksum_b = checksum.b();
+  memcpy(data + kChecksum1Offset, &checksum_a, kInt32Size);
+  memcpy(data + kChecksum2Offset, &checksum_b, kInt32Size);
   return result;
 }
 
@@ -241,6 +385,35 @@ Vector<const byte> Snapshot::ExtractContextData(const v8::StartupData* data,
   return Vector<const byte>(context_data, context_length);
 }
 
+bool Snapshot::IsCompressed(const v8::StartupData* data) {
+  CHECK_LT(kCompressedOffset, data->raw_size);
+  int compressed;
+  memcpy(&compressed, data->data + kCompressedOffset, kInt32Size);
+  return compressed != 0;
+}
+
+Vector<const byte> Snapshot::MaybeDecompress(
+    const v8::StartupData* data, Vector<const byte> snapshot_data,
+    base::SmartArrayPointer<byte>* buffer) {
+  if (!IsCompressed(data)) return snapshot_data;
+  base::ElapsedTimer timer;
+  if (FLAG_profile_deserialization) timer.Start();
+  CHECK_LE(kInt32Size, snapshot_data.length());
+  int raw_size;
+  memcpy(&raw_size, snapshot_data.start(), kInt32Size);
+  CHECK_LE(0, raw_size);
+  buffer->Reset(NewArray<byte>(raw_size));
+  CHECK(SnapshotCompression::Decompress(snapshot_data.SubVector(
+                                            kInt32Size, snapshot_data.length()),
+                                        Vector<byte>(buffer->get(), raw_size)));
+  if (FLAG_profile_deserialization) {
+    double ms = timer.Elapsed().InMillisecondsF();
+    PrintF("[Decompressing %d to %d bytes took %0.3f ms]\n",
+           snapshot_data.length(), raw_size, ms);
+  }
+  return Vector<const byte>(buffer->get(), raw_size);
+}
+
 SnapshotData::SnapshotData(const Serializer* serializer) {
   DisallowHeapAllocation no_gc;
   List<Reservation> reservations;
@@ -0,0 +1,135 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/snapshot/snapshot-compression.h"
+
+#include <vector>
+
+#include "src/list-inl.h"
+#include "src/utils.h"
+
+namespace v8 {
+namespace internal {
+
+void SnapshotCompression::PutLength(int length, List<byte>* output) {
+  while (length >= 0xff) {
+    output->Add(0xff);
+    length -= 0xff;
+  }
+  output->Add(static_cast<byte>(length));
+}
+
+void SnapshotCompression::PutSequence(const byte* literals, int literal_length,
+                                      int offset, int match_length,
+                                      List<byte>* output) {
+  int literal_token = Min(literal_length, kLengthMask);
+  int match_token =
+      offset == 0 ? 0 : Min(match_length - kMinMatchLength, kLengthMask);
+  output->Add(static_cast<byte>((literal_token << 4) | match_token));
+  if (literal_token == kLengthMask) {
+    PutLength(literal_length - kLengthMask, output);
+  }
+  output->AddAll(Vector<byte>(const_cast<byte*>(literals), literal_length));
+  if (offset == 0) return;
+  output->Add(static_cast<byte>(offset & 0xff));
+  output->Add(static_cast<byte>(offset >> 8));
+  if (match_token == kLengthMask) {
+    PutLength(match_length - kMinMatchLength - kLengthMask, output);
+  }
+}
+
+void SnapshotCompression::Compress(Vector<const byte> input,
+                                   List<byte>* output) {
+  const byte* base = input.start();
+  int length = input.length();
+  // Maps the hash of four bytes to the last position they were seen at.
+  std::vector<int> table(1 << kHashBits, -1);
+  int anchor = 0;
+  int position = 0;
+  int match_limit = length - kLastLiterals;
+  while (position + kMinMatchLength <= match_limit) {
+    uint32_t sequence = ReadUnalignedValue<uint32_t>(base + position);
+    uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+    int candidate = table[hash];
+    table[hash] = position;
+    if (candidate >= 0 && position - candidate <= kMaxOffset &&
+        ReadUnalignedValue<uint32_t>(base + candidate) == sequence) {
+      int match_length = kMinMatchLength;
+      while (position + match_length < match_limit &&
+             base[candidate + match_length] == base[position + match_length]) {
+        match_length++;
+      }
+      PutSequence(base + anchor, position - anchor, position - candidate,
+                  match_length, output);
+      position += match_length;
+      anchor = position;
+    } else {
+      position++;
+    }
+  }
+  PutSequence(base + anchor, length - anchor, 0, 0, output);
+}
+
+bool SnapshotCompression::GetLength(const byte** input, const byte* end,
+                                    size_t* length) {
+  byte next;
+  do {
+    if (*input == end) return false;
+    next = *(*input)++;
+    *length += next;
+    if (*length > static_cast<size_t>(kMaxInt)) return false;
+  } while (next == 0xff);
+  return true;
+}
+
+bool SnapshotCompression::Decompress(Vector<const byte> input,
+                                     Vector<byte> output) {
+  const byte* in = input.start();
+  const byte* in_end = input.end();
+  byte* out = output.start();
+  byte* out_end = output.end();
+  while (in < in_end) {
+    int token = *in++;
+    size_t literal_length = token >> 4;
+    if (literal_length == kLengthMask &&
+        !GetLength(&in, in_end, &literal_length)) {
+      return false;
+    }
+    if (literal_length > static_cast<size_t>(in_end - in) ||
+        literal_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    MemCopy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    // The last sequence has no match.
+    if (in == in_end) break;
+
+    if (in_end - in < 2) return false;
+    size_t offset = in[0] | (in[1] << 8);
+    in += 2;
+    if (offset == 0 || offset > static_cast<size_t>(out - output.start())) {
+      return false;
+    }
+    size_t match_length = token & kLengthMask;
+    if (match_length == kLengthMask &&
+        !GetLength(&in, in_end, &match_length)) {
+      return false;
+    }
+    match_length += kMinMatchLength;
+    if (match_length > static_cast<size_t>(out_end - out)) return false;
+    const byte* match = out - offset;
+    if (offset >= match_length) {
+      MemCopy(out, match, match_length);
+    } else {
+      // An overlapping match repeats the last |offset| bytes.
+      for (size_t i = 0; i < match_length; i++) out[i] = match[i];
+    }
+    out += match_length;
+  }
+  return out == out_end;
+}
+
+}  // namespace internal
+}  // namespace v8
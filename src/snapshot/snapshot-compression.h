@@ -0,0 +1,49 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_SNAPSHOT_SNAPSHOT_COMPRESSION_H_
+#define V8_SNAPSHOT_SNAPSHOT_COMPRESSION_H_
+
+#include "src/globals.h"
+#include "src/list.h"
+#include "src/vector.h"
+
+namespace v8 {
+namespace internal {
+
+// A byte-oriented LZ77 compressor for snapshot data, using the LZ4 block
+// format: each sequence is a token byte holding the lengths of a literal run
+// and of the following match, the literals, and the 16-bit little endian
+// offset of the match. The last sequence consists of literals only.
+// Compression is greedy and only runs in mksnapshot; decompression is a
+// plain copy loop so that it does not noticeably slow down isolate creation.
+class SnapshotCompression : public AllStatic {
+ public:
+  // Appends the compressed form of |input| to |output|.
+  static void Compress(Vector<const byte> input, List<byte>* output);
+
+  // Decompresses |input| into |output|, which has to have exactly the size of
+  // the original data. Returns false if the input is malformed.
+  static bool Decompress(Vector<const byte> input, Vector<byte> output);
+
+ private:
+  static const int kMinMatchLength = 4;
+  static const int kMaxOffset = 0xffff;
+  // The last bytes of the input are always emitted as literals.
+  static const int kLastLiterals = 5;
+  static const int kHashBits = 14;
+  // Lengths that do not fit into a nibble of the token byte are continued in
+  // the following bytes.
+  static const int kLengthMask = 0xf;
+
+  static void PutLength(int length, List<byte>* output);
+  static void PutSequence(const byte* literals, int literal_length, int offset,
+                          int match_length, List<byte>* output);
+  static bool GetLength(const byte** input, const byte* end, size_t* length);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_SNAPSHOT_SNAPSHOT_COMPRESSION_H_
@@ -5,6 +5,7 @@
 #ifndef V8_SNAPSHOT_SNAPSHOT_H_
 #define V8_SNAPSHOT_SNAPSHOT_H_
 
+#include "src/base/smart-pointers.h"
 #include "src/snapshot/partial-serializer.h"
 #include "src/snapshot/startup-serializer.h"
 
@@ -67,6 +68,23 @@ class Snapshot : public AllStatic {
 
   static uint32_t SizeOfFirstPage(Isolate* isolate, AllocationSpace space);
 
+  // Verifies the checksum of a snapshot blob on the calling thread.
+  static bool VerifyChecksum(const v8::StartupData* data);
+
+  // The checksum of the default snapshot blob is verified at most once per
+  // process, on a background thread, so that it does not delay isolate
+  // creation. The first call starts the verification, later calls do nothing.
+  static void StartVerifyingDefaultChecksum();
+
+  // Waits for the verification of the default snapshot blob's checksum to
+  // complete, starting it if necessary, and returns its result.
+  static bool DefaultChecksumIsValid();
+
+  // Makes sure that the verification of the default snapshot blob's checksum
+  // no longer reads the blob: a pending verification is done on the calling
+  // thread, a running one is waited for. Must be called before the default
+  // blob is freed.
+  static void CancelVerifyingDefaultChecksum();
 
   // To be implemented by the snapshot source.
   static const v8::StartupData* DefaultSnapshotBlob();
@@ -84,23 +102,46 @@ class Snapshot : public AllStatic {
   static Vector<const byte> ExtractStartupData(const v8::StartupData* data);
   static Vector<const byte> ExtractContextData(const v8::StartupData* data,
                                                int index);
+  static bool IsCompressed(const v8::StartupData* data);
+  // Returns |snapshot_data| as is, or decompressed into |buffer| if the blob
+  // is compressed.
+  static Vector<const byte> MaybeDecompress(
+      const v8::StartupData* data, Vector<const byte> snapshot_data,
+      base::SmartArrayPointer<byte>* buffer);
+  static Vector<const byte> ChecksummedContent(const v8::StartupData* data) {
+    const byte* start = reinterpret_cast<const byte*>(data->data);
+    return Vector<const byte>(start + kChecksummedContentOffset,
+                              data->raw_size - kChecksummedContentOffset);
+  }
 
   // Snapshot blob layout:
-  // [0 - 5] pre-calculated first page sizes for paged spaces
-  // [6] number of contexts N
-  // [7] offset to context 0
-  // [8] offset to context 1
+  // [0] checksum part 1
+  // [1] checksum part 2
+  // [2 - 7] pre-calculated first page sizes for paged spaces
+  // [8] whether the snapshot data is compressed
+  // [9] number of contexts N
+  // [10] offset to context 0
+  // [11] offset to context 1
   // ...
   // ... offset to context N - 1
   // ... startup snapshot data
   // ... context 0 snapshot data
   // ... context 1 snapshot data
+  //
+  // Compressed snapshot data starts with its uncompressed size, followed by
+  // the output of SnapshotCompression.
 
   static const int kNumPagedSpaces = LAST_PAGED_SPACE - FIRST_PAGED_SPACE + 1;
 
-  static const int kFirstPageSizesOffset = 0;
-  static const int kNumberOfContextsOffset =
+  static const int kChecksum1Offset = 0;
+  static const int kChecksum2Offset = kChecksum1Offset + kInt32Size;
+  // The checksum covers everything following it. This offset is pointer
+  // aligned, so that Checksum can read words from aligned blobs.
+  static const int kChecksummedContentOffset = kChecksum2Offset + kInt32Size;
+  static const int kFirstPageSizesOffset = kChecksummedContentOffset;
+  static const int kCompressedOffset =
       kFirstPageSizesOffset + kNumPagedSpaces * kInt32Size;
+  static const int kNumberOfContextsOffset = kCompressedOffset + kInt32Size;
   static const int kFirstContextOffsetOffset =
       kNumberOfContextsOffset + kInt32Size;
 
@@ -4,6 +4,7 @@
 
 #include "src/snapshot/startup-serializer.h"
 
+#include "src/base/functional.h"
 #include "src/objects-inl.h"
 #include "src/v8threads.h"
 
@@ -16,6 +17,9 @@ StartupSerializer::StartupSerializer(
     : Serializer(isolate),
       clear_function_code_(function_code_handling ==
                            v8::SnapshotCreator::FunctionCodeHandling::kClear),
+      keep_type_feedback_(
+          function_code_handling ==
+          v8::SnapshotCreator::FunctionCodeHandling::kKeepWithTypeFeedback),
       serializing_builtins_(false) {
   InitializeCodeAddressMap();
 }
@@ -64,6 +68,15 @@ void StartupSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
 
   if (SerializeBackReference(obj, how_to_code, where_to_point, skip)) return;
 
+  if (root_index == RootIndexMap::kInvalidRootIndex &&
+      DuplicateMap::CanBeDeduplicated(obj)) {
+    HeapObject* duplicate = duplicate_map_.LookupOrInsert(obj);
+    if (duplicate != NULL &&
+        SerializeBackReference(duplicate, how_to_code, where_to_point, skip)) {
+      return;
+    }
+  }
+
   FlushSkip(skip);
 
   // Object has not yet been serialized.  Serialize it here.
@@ -81,6 +94,44 @@ void StartupSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
   }
 }
 
+bool StartupSerializer::DuplicateMap::CanBeDeduplicated(HeapObject* obj) {
+  if (obj->IsString()) {
+    return obj->IsSeqString() && !obj->IsInternalizedString();
+  }
+  return obj->map() == obj->GetHeap()->fixed_cow_array_map();
+}
+
+HeapObject* StartupSerializer::DuplicateMap::LookupOrInsert(HeapObject* obj) {
+  base::HashMap::Entry* entry = map_.LookupOrInsert(obj, Hash(obj));
+  HeapObject* duplicate = reinterpret_cast<HeapObject*>(entry->key);
+  return duplicate == obj ? NULL : duplicate;
+}
+
+bool StartupSerializer::DuplicateMap::Match(void* key1, void* key2) {
+  HeapObject* a = reinterpret_cast<HeapObject*>(key1);
+  HeapObject* b = reinterpret_cast<HeapObject*>(key2);
+  if (a->map() != b->map()) return false;
+  if (a->IsString()) return String::cast(a)->Equals(String::cast(b));
+  FixedArray* array_a = FixedArray::cast(a);
+  FixedArray* array_b = FixedArray::cast(b);
+  if (array_a->length() != array_b->length()) return false;
+  for (int i = 0; i < array_a->length(); i++) {
+    if (array_a->get(i) != array_b->get(i)) return false;
+  }
+  return true;
+}
+
+uint32_t StartupSerializer::DuplicateMap::Hash(HeapObject* obj) {
+  if (obj->IsString()) return String::cast(obj)->Hash();
+  FixedArray* array = FixedArray::cast(obj);
+  uint32_t hash = static_cast<uint32_t>(array->length());
+  for (int i = 0; i < array->length(); i++) {
+    uintptr_t element = reinterpret_cast<uintptr_t>(array->get(i));
+    hash = static_cast<uint32_t>(base::hash_combine(hash, element));
+  }
+  return hash;
+}
+
 void StartupSerializer::SerializeWeakReferencesAndDeferred() {
   // This comes right after serialization of the partial snapshot, where we
   // add entries to the partial snapshot cache of the startup snapshot. Add
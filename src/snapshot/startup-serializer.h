@@ -29,6 +29,30 @@ class StartupSerializer : public Serializer {
 
   int PartialSnapshotCacheIndex(HeapObject* o);
 
+  // Whether partial snapshots should keep the type feedback of functions.
+  bool keep_type_feedback() const { return keep_type_feedback_; }
+
+  // Non-internalized sequential strings and copy-on-write arrays are never
+  // modified in place, so identical copies can share one serialized object.
+  class DuplicateMap {
+   public:
+    DuplicateMap() : map_(Match) {}
+
+    static bool CanBeDeduplicated(HeapObject* obj);
+
+    // Returns an object with the same contents recorded before, or records
+    // |obj| and returns NULL.
+    HeapObject* LookupOrInsert(HeapObject* obj);
+
+   private:
+    static bool Match(void* key1, void* key2);
+    static uint32_t Hash(HeapObject* obj);
+
+    base::HashMap map_;
+
+    DISALLOW_COPY_AND_ASSIGN(DuplicateMap);
+  };
+
  private:
   class PartialCacheIndexMap : public AddressMapBase {
    public:
@@ -69,10 +93,12 @@ class StartupSerializer : public Serializer {
   bool RootShouldBeSkipped(int root_index);
 
   bool clear_function_code_;
+  bool keep_type_feedback_;
   bool serializing_builtins_;
   bool serializing_immortal_immovables_roots_;
   std::bitset<Heap::kStrongRootListLength> root_has_been_serialized_;
   PartialCacheIndexMap partial_cache_index_map_;
+  DuplicateMap duplicate_map_;
   DISALLOW_COPY_AND_ASSIGN(StartupSerializer);
 };
 
@@ -10,6 +10,7 @@
 #include "src/base/file-utils.h"
 #include "src/base/logging.h"
 #include "src/base/platform/platform.h"
+#include "src/snapshot/snapshot.h"
 #include "src/utils.h"
 
 
@@ -23,6 +24,11 @@ namespace {
 v8::StartupData g_natives;
 v8::StartupData g_snapshot;
 
+// Blobs that could be memory-mapped are backed directly by the file, so that
+// all isolates and all processes using the same blob share its pages.
+base::OS::MemoryMappedFile* g_natives_file = nullptr;
+base::OS::MemoryMappedFile* g_snapshot_file = nullptr;
+
 
 void ClearStartupData(v8::StartupData* data) {
   data->data = nullptr;
@@ -30,24 +36,54 @@ void ClearStartupData(v8::StartupData* data) {
 }
 
 
-void DeleteStartupData(v8::StartupData* data) {
-  delete[] data->data;
+void DeleteStartupData(v8::StartupData* data,
+                       base::OS::MemoryMappedFile** mapped_file) {
+  if (*mapped_file != nullptr) {
+    delete *mapped_file;
+    *mapped_file = nullptr;
+  } else {
+    delete[] data->data;
+  }
   ClearStartupData(data);
 }
 
 
 void FreeStartupData() {
-  DeleteStartupData(&g_natives);
-  DeleteStartupData(&g_snapshot);
+  // The snapshot checksum may still be verified on a background thread.
+  Snapshot::CancelVerifyingDefaultChecksum();
+  DeleteStartupData(&g_natives, &g_natives_file);
+  DeleteStartupData(&g_snapshot, &g_snapshot_file);
+}
+
+
+bool MapFile(const char* blob_file, v8::StartupData* startup_data,
+             base::OS::MemoryMappedFile** mapped_file) {
+  base::OS::MemoryMappedFile* file = base::OS::MemoryMappedFile::open(
+      blob_file, base::OS::MemoryMappedFile::FileMode::kReadOnly);
+  if (file == nullptr) return false;
+  if (file->memory() == nullptr || file->size() == 0) {
+    delete file;
+    return false;
+  }
+  *mapped_file = file;
+  startup_data->data = static_cast<const char*>(file->memory());
+  startup_data->raw_size = static_cast<int>(file->size());
+  return true;
 }
 
 
 void Load(const char* blob_file, v8::StartupData* startup_data,
+          base::OS::MemoryMappedFile** mapped_file,
           void (*setter_fn)(v8::StartupData*)) {
   ClearStartupData(startup_data);
 
   CHECK(blob_file);
 
+  if (MapFile(blob_file, startup_data, mapped_file)) {
+    (*setter_fn)(startup_data);
+    return;
+  }
+
   FILE* file = fopen(blob_file, "rb");
   if (!file) {
     PrintF(stderr, "Failed to open startup resource '%s'.\n", blob_file);
@@ -72,8 +108,9 @@ void Load(const char* blob_file, v8::StartupData* startup_data,
 
 
 void LoadFromFiles(const char* natives_blob, const char* snapshot_blob) {
-  Load(natives_blob, &g_natives, v8::V8::SetNativesDataBlob);
-  Load(snapshot_blob, &g_snapshot, v8::V8::SetSnapshotDataBlob);
+  Load(natives_blob, &g_natives, &g_natives_file, v8::V8::SetNativesDataBlob);
+  Load(snapshot_blob, &g_snapshot, &g_snapshot_file,
+       v8::V8::SetSnapshotDataBlob);
 
   atexit(&FreeStartupData);
 }
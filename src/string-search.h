@@ -5,9 +5,14 @@
 #ifndef V8_STRING_SEARCH_H_
 #define V8_STRING_SEARCH_H_
 
+#include "src/base/bits.h"
 #include "src/isolate.h"
 #include "src/vector.h"
 
+#if V8_HOST_ARCH_X64
+#include <emmintrin.h>  // NOLINT
+#endif
+
 namespace v8 {
 namespace internal {
 
@@ -130,6 +135,8 @@ class StringSearch : private StringSearchBase {
 
   void PopulateBoyerMooreTable();
 
+  bool ClaimSharedTables();
+
   static inline bool exceedsOneByte(uint8_t c) {
     return false;
   }
@@ -154,9 +161,9 @@ class StringSearch : private StringSearchBase {
     return bad_char_occurrence[equiv_class];
   }
 
-  // The following tables are shared by all searches.
-  // TODO(lrn): Introduce a way for a pattern to keep its tables
-  // between searches (e.g., for an Atom RegExp).
+  // The following tables are shared by all searches. They remember the
+  // pattern they were built for, so that searching for the same pattern
+  // again (e.g., a split in a loop) does not rebuild them.
 
   // Store for the BoyerMoore(Horspool) bad char shift table.
   // Return a table covering the last kBMMaxShift+1 positions of
@@ -230,6 +237,83 @@ inline int FindFirstCharacter(Vector<const PatternChar> pattern,
 }
 
 
+#if V8_HOST_ARCH_X64
+
+inline __m128i BroadcastCharacter(uint8_t c) {
+  return _mm_set1_epi8(static_cast<char>(c));
+}
+
+
+inline __m128i BroadcastCharacter(uc16 c) {
+  return _mm_set1_epi16(static_cast<int16_t>(c));
+}
+
+
+inline __m128i CompareCharacters(__m128i chars, __m128i block, uint8_t) {
+  return _mm_cmpeq_epi8(chars, block);
+}
+
+
+inline __m128i CompareCharacters(__m128i chars, __m128i block, uc16) {
+  return _mm_cmpeq_epi16(chars, block);
+}
+
+#endif  // V8_HOST_ARCH_X64
+
+
+// Finds the first index at or after index where the subject has both the
+// first and the last character of the pattern in place. The characters in
+// between are not compared.
+template <typename PatternChar, typename SubjectChar>
+inline int FindFirstAndLastCharacter(Vector<const PatternChar> pattern,
+                                     Vector<const SubjectChar> subject,
+                                     int index) {
+  const int pattern_length = pattern.length();
+  DCHECK(pattern_length > 1);
+  const int last = pattern_length - 1;
+  const int max_n = (subject.length() - pattern_length + 1);
+  const SubjectChar first_char = static_cast<SubjectChar>(pattern[0]);
+  const SubjectChar last_char = static_cast<SubjectChar>(pattern[last]);
+  const SubjectChar* chars = subject.start();
+  int pos = index;
+#if V8_HOST_ARCH_X64
+  // Compare a block of candidate positions at a time against the first
+  // character and the same block shifted by the pattern length against the
+  // last character. Both loads stay within the subject.
+  const int kBlockLength = sizeof(__m128i) / sizeof(SubjectChar);
+  const __m128i first_block = BroadcastCharacter(first_char);
+  const __m128i last_block = BroadcastCharacter(last_char);
+  for (; pos + kBlockLength <= max_n; pos += kBlockLength) {
+    __m128i first_chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + pos));
+    __m128i last_chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + pos + last));
+    __m128i matches = _mm_and_si128(
+        CompareCharacters(first_block, first_chars, first_char),
+        CompareCharacters(last_block, last_chars, last_char));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    if (mask != 0) {
+      return pos + base::bits::CountTrailingZeros32(mask) /
+                       static_cast<int>(sizeof(SubjectChar));
+    }
+  }
+  for (; pos < max_n; pos++) {
+    if (chars[pos] == first_char && chars[pos + last] == last_char) {
+      return pos;
+    }
+  }
+#else
+  while (pos < max_n) {
+    pos = FindFirstCharacter(pattern, subject, pos);
+    if (pos == -1) return -1;
+    if (chars[pos + last] == last_char) return pos;
+    pos++;
+  }
+#endif  // V8_HOST_ARCH_X64
+  return -1;
+}
+
+
 //---------------------------------------------------------------------
 // Single Character Pattern Search Strategy
 //---------------------------------------------------------------------
@@ -282,7 +366,7 @@ int StringSearch<PatternChar, SubjectChar>::LinearSearch(
   int i = index;
   int n = subject.length() - pattern_length;
   while (i <= n) {
-    i = FindFirstCharacter(pattern, subject, i);
+    i = FindFirstAndLastCharacter(pattern, subject, i);
     if (i == -1) return -1;
     DCHECK_LE(i, n);
     i++;
@@ -354,8 +438,37 @@ int StringSearch<PatternChar, SubjectChar>::BoyerMooreSearch(
 }
 
 
+template <typename PatternChar, typename SubjectChar>
+bool StringSearch<PatternChar, SubjectChar>::ClaimSharedTables() {
+  // The tables only depend on the pattern length and on the character codes
+  // of the part of the pattern from offset start_, since both alphabets have
+  // the same size.
+  STATIC_ASSERT(kLatin1AlphabetSize == kUC16AlphabetSize);
+  int pattern_length = pattern_.length();
+  uc16* cached_pattern = isolate_->string_search_table_pattern();
+  if (isolate_->string_search_table_pattern_length() == pattern_length) {
+    int i = start_;
+    while (i < pattern_length && cached_pattern[i - start_] == pattern_[i]) {
+      i++;
+    }
+    if (i == pattern_length) return true;
+  }
+  for (int i = start_; i < pattern_length; i++) {
+    cached_pattern[i - start_] = pattern_[i];
+  }
+  isolate_->set_string_search_table_pattern_length(pattern_length);
+  isolate_->set_bad_char_shift_table_valid(false);
+  isolate_->set_good_suffix_shift_table_valid(false);
+  return false;
+}
+
+
 template <typename PatternChar, typename SubjectChar>
 void StringSearch<PatternChar, SubjectChar>::PopulateBoyerMooreTable() {
+  if (ClaimSharedTables() && isolate_->good_suffix_shift_table_valid()) {
+    return;
+  }
+  isolate_->set_good_suffix_shift_table_valid(true);
   int pattern_length = pattern_.length();
   const PatternChar* pattern = pattern_.start();
   // Only look at the last kBMMaxShift characters of pattern (from start_
@@ -477,6 +590,8 @@ int StringSearch<PatternChar, SubjectChar>::BoyerMooreHorspoolSearch(
 
 template <typename PatternChar, typename SubjectChar>
 void StringSearch<PatternChar, SubjectChar>::PopulateBoyerMooreHorspoolTable() {
+  if (ClaimSharedTables() && isolate_->bad_char_shift_table_valid()) return;
+  isolate_->set_bad_char_shift_table_valid(true);
   int pattern_length = pattern_.length();
 
   int* bad_char_occurrence = bad_char_table();
@@ -526,7 +641,7 @@ int StringSearch<PatternChar, SubjectChar>::InitialSearch(
   for (int i = index, n = subject.length() - pattern_length; i <= n; i++) {
     badness++;
     if (badness <= 0) {
-      i = FindFirstCharacter(pattern, subject, i);
+      i = FindFirstAndLastCharacter(pattern, subject, i);
       if (i == -1) return -1;
       DCHECK_LE(i, n);
       int j = 1;
@@ -287,6 +287,12 @@ void TypeFeedbackVector::ClearSlotsImpl(SharedFunctionInfo* shared,
   Isolate* isolate = GetIsolate();
 
   if (!force_clear && !ClearLogic(isolate)) return;
+  if (!force_clear && isolate->serializer_keeps_type_feedback()) {
+    // The snapshot keeps call targets and allocation sites. Only handler
+    // code has to be cleared before serialization.
+    ClearPropertyAccessSlots(shared);
+    return;
+  }
 
   Object* uninitialized_sentinel =
       TypeFeedbackVector::RawUninitializedSentinel(isolate);
@@ -352,6 +358,51 @@ void TypeFeedbackVector::ClearSlotsImpl(SharedFunctionInfo* shared,
 }
 
 
+void TypeFeedbackVector::ClearPropertyAccessSlots(SharedFunctionInfo* shared) {
+  Object* uninitialized_sentinel =
+      TypeFeedbackVector::RawUninitializedSentinel(GetIsolate());
+
+  TypeFeedbackMetadataIterator iter(metadata());
+  while (iter.HasNext()) {
+    FeedbackVectorSlot slot = iter.Next();
+    if (Get(slot) == uninitialized_sentinel) continue;
+    switch (iter.kind()) {
+      case FeedbackVectorSlotKind::LOAD_IC: {
+        LoadICNexus nexus(this, slot);
+        nexus.Clear(shared->code());
+        break;
+      }
+      case FeedbackVectorSlotKind::LOAD_GLOBAL_IC: {
+        LoadGlobalICNexus nexus(this, slot);
+        nexus.Clear(shared->code());
+        break;
+      }
+      case FeedbackVectorSlotKind::KEYED_LOAD_IC: {
+        KeyedLoadICNexus nexus(this, slot);
+        nexus.Clear(shared->code());
+        break;
+      }
+      case FeedbackVectorSlotKind::STORE_IC: {
+        StoreICNexus nexus(this, slot);
+        nexus.Clear(shared->code());
+        break;
+      }
+      case FeedbackVectorSlotKind::KEYED_STORE_IC: {
+        KeyedStoreICNexus nexus(this, slot);
+        nexus.Clear(shared->code());
+        break;
+      }
+      case FeedbackVectorSlotKind::CALL_IC:
+      case FeedbackVectorSlotKind::GENERAL:
+        break;
+      case FeedbackVectorSlotKind::INVALID:
+      case FeedbackVectorSlotKind::KINDS_NUMBER:
+        UNREACHABLE();
+        break;
+    }
+  }
+}
+
 // static
 void TypeFeedbackVector::ClearAllKeyedStoreICs(Isolate* isolate) {
   SharedFunctionInfo::Iterator iterator(isolate);
@@ -283,6 +283,10 @@ class TypeFeedbackVector : public FixedArray {
     ClearSlotsImpl(shared, false);
   }
 
+  // Clears the slots of property load and store ICs, which refer to handler
+  // code, but keeps call IC feedback and allocation sites.
+  void ClearPropertyAccessSlots(SharedFunctionInfo* shared);
+
   static void ClearAllKeyedStoreICs(Isolate* isolate);
   void ClearKeyedStoreICs(SharedFunctionInfo* shared);
 
@@ -63,7 +63,8 @@ AsmTyper::AsmTyper(Isolate* isolate, Zone* zone, Script* script,
       building_function_tables_(false),
       visiting_exports_(false),
       cache_(TypeCache::Get()),
-      bounds_(zone) {
+      bounds_(zone),
+      function_bounds_(nullptr) {
   InitializeAstVisitor(isolate);
   InitializeStdlib();
 }
@@ -75,7 +76,40 @@ bool AsmTyper::Validate() {
 }
 
 
+bool AsmTyper::ValidateModule() {
+  VisitAsmModuleHeader(root_);
+  if (valid_ && !HasStackOverflow()) VisitAsmModuleExports(root_);
+  return valid_ && !HasStackOverflow();
+}
+
+
+bool AsmTyper::ValidateFunction(FunctionDeclaration* decl,
+                                AstTypeBounds* bounds) {
+  DCHECK_NULL(function_bounds_);
+  function_bounds_ = bounds;
+  VisitAsmFunction(decl);
+  function_bounds_ = nullptr;
+  return valid_ && !HasStackOverflow();
+}
+
+
 void AsmTyper::VisitAsmModule(FunctionLiteral* fun) {
+  RECURSE(VisitAsmModuleHeader(fun));
+
+  // Validate function bodies.
+  ZoneList<Declaration*>* decls = fun->scope()->declarations();
+  for (int i = 0; i < decls->length(); ++i) {
+    FunctionDeclaration* decl = decls->at(i)->AsFunctionDeclaration();
+    if (decl != nullptr) {
+      RECURSE(VisitAsmFunction(decl));
+    }
+  }
+
+  RECURSE(VisitAsmModuleExports(fun));
+}
+
+
+void AsmTyper::VisitAsmModuleHeader(FunctionLiteral* fun) {
   Scope* scope = fun->scope();
   if (!scope->is_function_scope()) FAIL(fun, "not at function scope");
 
@@ -122,19 +156,18 @@ void AsmTyper::VisitAsmModule(FunctionLiteral* fun) {
   building_function_tables_ = true;
   RECURSE(VisitStatements(fun->body()));
   building_function_tables_ = false;
+}
 
-  // Validate function bodies.
-  for (int i = 0; i < decls->length(); ++i) {
-    FunctionDeclaration* decl = decls->at(i)->AsFunctionDeclaration();
-    if (decl != nullptr) {
-      RECURSE(VisitWithExpectation(decl->fun(), Type::Any(), "UNREACHABLE"));
-      if (!computed_type_->IsFunction()) {
-        FAIL(decl->fun(), "function literal expected to be a function");
-      }
-    }
+
+void AsmTyper::VisitAsmFunction(FunctionDeclaration* decl) {
+  RECURSE(VisitWithExpectation(decl->fun(), Type::Any(), "UNREACHABLE"));
+  if (!computed_type_->IsFunction()) {
+    FAIL(decl->fun(), "function literal expected to be a function");
   }
+}
+
 
-  // Validate exports.
+void AsmTyper::VisitAsmModuleExports(FunctionLiteral* fun) {
   visiting_exports_ = true;
   ReturnStatement* stmt = fun->body()->last()->AsReturnStatement();
   if (stmt == nullptr) {
@@ -142,6 +175,7 @@ void AsmTyper::VisitAsmModule(FunctionLiteral* fun) {
   }
   RECURSE(VisitWithExpectation(stmt->expression(), Type::Object(),
                                "expected object export"));
+  visiting_exports_ = false;
 }
 
 
@@ -811,7 +845,7 @@ void AsmTyper::VisitHeapAccess(Property* expr, bool assigning,
           FAIL(right, "heap access shift must match element size");
         }
       }
-      bounds_.set(expr->key(), Bounds(cache_.kAsmSigned));
+      current_bounds()->set(expr->key(), Bounds(cache_.kAsmSigned));
     }
     Type* result_type;
     if (type->Is(cache_.kAsmIntArrayElement)) {
@@ -962,7 +996,7 @@ void AsmTyper::CheckPolymorphicStdlibArguments(
   }
   // Handle polymorphic stdlib functions specially.
   Expression* arg0 = args->at(0);
-  Type* arg0_type = bounds_.get(arg0).upper;
+  Type* arg0_type = current_bounds()->get(arg0).upper;
   switch (standard_member) {
     case kMathFround: {
       if (!arg0_type->Is(cache_.kAsmFloat) &&
@@ -991,8 +1025,9 @@ void AsmTyper::CheckPolymorphicStdlibArguments(
         FAIL(arg0, "illegal function argument type");
       }
       if (args->length() > 1) {
-        Type* other = Type::Intersect(bounds_.get(args->at(0)).upper,
-                                      bounds_.get(args->at(1)).upper, zone());
+        Type* other =
+            Type::Intersect(current_bounds()->get(args->at(0)).upper,
+                            current_bounds()->get(args->at(1)).upper, zone());
         if (!other->Is(cache_.kAsmFloat) && !other->Is(cache_.kAsmDouble) &&
             !other->Is(cache_.kAsmSigned)) {
           FAIL(arg0, "function arguments types don't match");
@@ -1039,8 +1074,8 @@ void AsmTyper::VisitCall(Call* expr) {
         }
       }
       intish_ = 0;
-      bounds_.set(expr->expression(),
-                  Bounds(Type::Function(Type::Any(), zone())));
+      current_bounds()->set(expr->expression(),
+                            Bounds(Type::Function(Type::Any(), zone())));
       RECURSE(IntersectResult(expr, expected_type));
     } else {
       if (fun_type->Arity() != args->length()) {
@@ -1206,12 +1241,12 @@ void AsmTyper::VisitBinaryOperation(BinaryOperation* expr) {
       RECURSE(VisitIntegerBitwiseOperator(expr, Type::Any(), cache_.kAsmIntQ,
                                           cache_.kAsmSigned, true));
       if (expr->left()->IsCall() && expr->op() == Token::BIT_OR &&
-          Type::Number()->Is(bounds_.get(expr->left()).upper)) {
+          Type::Number()->Is(current_bounds()->get(expr->left()).upper)) {
         // Force the return types of foreign functions.
-        bounds_.set(expr->left(), Bounds(cache_.kAsmSigned));
+        current_bounds()->set(expr->left(), Bounds(cache_.kAsmSigned));
       }
       if (in_function_ &&
-          !bounds_.get(expr->left()).upper->Is(cache_.kAsmIntQ)) {
+          !current_bounds()->get(expr->left()).upper->Is(cache_.kAsmIntQ)) {
         FAIL(expr->left(), "intish required");
       }
       return;
@@ -1221,7 +1256,7 @@ void AsmTyper::VisitBinaryOperation(BinaryOperation* expr) {
       Literal* left = expr->left()->AsLiteral();
       if (left && left->value()->IsBoolean()) {
         if (left->ToBooleanIsTrue()) {
-          bounds_.set(left, Bounds(cache_.kSingletonOne));
+          current_bounds()->set(left, Bounds(cache_.kSingletonOne));
           RECURSE(VisitWithExpectation(expr->right(), cache_.kAsmIntQ,
                                        "not operator expects an integer"));
           RECURSE(IntersectResult(expr, cache_.kAsmSigned));
@@ -1308,13 +1343,14 @@ void AsmTyper::VisitBinaryOperation(BinaryOperation* expr) {
                  expr->right()->AsLiteral()->raw_value()->AsNumber() == 1.0) {
         // For unary +, expressed as x * 1.0
         if (expr->left()->IsCall() &&
-            Type::Number()->Is(bounds_.get(expr->left()).upper)) {
+            Type::Number()->Is(current_bounds()->get(expr->left()).upper)) {
           // Force the return types of foreign functions.
-          bounds_.set(expr->left(), Bounds(cache_.kAsmDouble));
-          left_type = bounds_.get(expr->left()).upper;
+          current_bounds()->set(expr->left(), Bounds(cache_.kAsmDouble));
+          left_type = current_bounds()->get(expr->left()).upper;
         }
         if (!(expr->left()->IsProperty() &&
-              Type::Number()->Is(bounds_.get(expr->left()).upper))) {
+              Type::Number()->Is(
+                  current_bounds()->get(expr->left()).upper))) {
           if (!left_type->Is(cache_.kAsmSigned) &&
               !left_type->Is(cache_.kAsmUnsigned) &&
               !left_type->Is(cache_.kAsmFixnum) &&
@@ -1332,7 +1368,7 @@ void AsmTyper::VisitBinaryOperation(BinaryOperation* expr) {
                  !expr->right()->AsLiteral()->raw_value()->ContainsDot() &&
                  expr->right()->AsLiteral()->raw_value()->AsNumber() == -1.0) {
         // For unary -, expressed as x * -1
-        bounds_.set(expr->right(), Bounds(cache_.kAsmDouble));
+        current_bounds()->set(expr->right(), Bounds(cache_.kAsmDouble));
         RECURSE(IntersectResult(expr, cache_.kAsmDouble));
         return;
       } else if (type->Is(cache_.kAsmFloat) && expr->op() != Token::MOD) {
@@ -1598,7 +1634,7 @@ AsmTyper::StandardMember AsmTyper::VariableAsStandardMember(
 
 void AsmTyper::SetResult(Expression* expr, Type* type) {
   computed_type_ = type;
-  bounds_.set(expr, Bounds(computed_type_));
+  current_bounds()->set(expr, Bounds(computed_type_));
 }
 
 
@@ -1614,7 +1650,7 @@ void AsmTyper::IntersectResult(Expression* expr, Type* type) {
 #endif
     FAIL(expr, "type mismatch");
   }
-  bounds_.set(expr, Bounds(bounded_type));
+  current_bounds()->set(expr, Bounds(bounded_type));
 }
 
 
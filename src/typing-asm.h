@@ -23,6 +23,14 @@ class AsmTyper : public AstVisitor {
   explicit AsmTyper(Isolate* isolate, Zone* zone, Script* script,
                     FunctionLiteral* root);
   bool Validate();
+  // Validates the module except for the bodies of its functions, which are
+  // validated one at a time with ValidateFunction afterwards. This lets a
+  // client consume the types of a function body and drop them before the next
+  // body is validated.
+  bool ValidateModule();
+  // Validates the body of a module function after ValidateModule. The types of
+  // the expressions in the body are recorded in {bounds} instead of bounds().
+  bool ValidateFunction(FunctionDeclaration* decl, AstTypeBounds* bounds);
   void set_allow_simd(bool simd) { allow_simd_ = simd; }
   const char* error_message() { return error_message_; }
   const AstTypeBounds* bounds() { return &bounds_; }
@@ -120,6 +128,7 @@ class AsmTyper : public AstVisitor {
   TypeCache const& cache_;
 
   AstTypeBounds bounds_;
+  AstTypeBounds* function_bounds_;  // Bounds of the current function, if any.
 
   static const int kErrorMessageLimit = 100;
   char error_message_[kErrorMessageLimit];
@@ -136,6 +145,9 @@ class AsmTyper : public AstVisitor {
   void VisitExpressionAnnotation(Expression* e, Variable* var, bool is_return);
   void VisitFunctionAnnotation(FunctionLiteral* f);
   void VisitAsmModule(FunctionLiteral* f);
+  void VisitAsmModuleHeader(FunctionLiteral* f);
+  void VisitAsmModuleExports(FunctionLiteral* f);
+  void VisitAsmFunction(FunctionDeclaration* decl);
 
   void VisitHeapAccess(Property* expr, bool assigning, Type* assignment_type);
 
@@ -174,6 +186,10 @@ class AsmTyper : public AstVisitor {
                                    Type* right_expected, Type* result_type,
                                    bool conversion);
 
+  AstTypeBounds* current_bounds() {
+    return function_bounds_ != nullptr ? function_bounds_ : &bounds_;
+  }
+
   Zone* zone() const { return zone_; }
 
 #define DECLARE_VISIT(type) void Visit##type(type* node) override;
@@ -8,6 +8,7 @@
 #include "src/base/once.h"
 #include "src/base/platform/platform.h"
 #include "src/bootstrapper.h"
+#include "src/compilation-cache.h"
 #include "src/crankshaft/lithium-allocator.h"
 #include "src/debug/debug.h"
 #include "src/deoptimizer.h"
@@ -45,6 +46,8 @@ void V8::TearDown() {
   Bootstrapper::TearDownExtensions();
   ElementsAccessor::TearDown();
   LOperand::TearDownCaches();
+  SharedCompilationCache::Clear();
+  Snapshot::CancelVerifyingDefaultChecksum();
   RegisteredExtension::UnregisterAll();
   Isolate::GlobalTearDown();
   sampler::Sampler::TearDown();
@@ -114,6 +117,7 @@ void V8::SetPlatformForTesting(v8::Platform* platform) { platform_ = platform; }
 
 void V8::SetNativesBlob(StartupData* natives_blob) {
 #ifdef V8_USE_EXTERNAL_STARTUP_DATA
+  base::OS::PrefetchPages(natives_blob->data, natives_blob->raw_size);
   base::CallOnce(&init_natives_once, &SetNativesFromFile, natives_blob);
 #else
   CHECK(false);
@@ -123,6 +127,8 @@ void V8::SetNativesBlob(StartupData* natives_blob) {
 
 void V8::SetSnapshotBlob(StartupData* snapshot_blob) {
 #ifdef V8_USE_EXTERNAL_STARTUP_DATA
+  // A blob mapped from a file is read in while the isolate is set up.
+  base::OS::PrefetchPages(snapshot_blob->data, snapshot_blob->raw_size);
   base::CallOnce(&init_snapshot_once, &SetSnapshotFromFile, snapshot_blob);
 #else
   CHECK(false);
@@ -30,6 +30,7 @@
     'v8_code': 1,
     'v8_random_seed%': 314159265,
     'v8_vector_stores%': 0,
+    'v8_compress_snapshot%': 0,
     'embed_script%': "",
     'warmup_script%': "",
     'v8_extra_library_files%': [],
@@ -216,6 +217,9 @@
               ['v8_vector_stores!=0', {
                 'mksnapshot_flags': ['--vector-stores'],
               }],
+              ['v8_compress_snapshot!=0', {
+                'mksnapshot_flags': ['--compress-snapshot'],
+              }],
             ],
           },
           'action': [
@@ -318,6 +322,9 @@
                   ['v8_vector_stores!=0', {
                     'mksnapshot_flags': ['--vector-stores'],
                   }],
+                  ['v8_compress_snapshot!=0', {
+                    'mksnapshot_flags': ['--compress-snapshot'],
+                  }],
                 ],
               },
               'conditions': [
@@ -1044,6 +1051,8 @@
         'regexp/regexp-macro-assembler-tracer.h',
         'regexp/regexp-macro-assembler.cc',
         'regexp/regexp-macro-assembler.h',
+        'regexp/regexp-nfa.cc',
+        'regexp/regexp-nfa.h',
         'regexp/regexp-parser.cc',
         'regexp/regexp-parser.h',
         'regexp/regexp-stack.cc',
@@ -1102,6 +1111,8 @@
         'snapshot/serializer-common.h',
         'snapshot/snapshot.h',
         'snapshot/snapshot-common.cc',
+        'snapshot/snapshot-compression.cc',
+        'snapshot/snapshot-compression.h',
         'snapshot/snapshot-source-sink.cc',
         'snapshot/snapshot-source-sink.h',
         'snapshot/startup-serializer.cc',
@@ -1170,6 +1181,8 @@
         'wasm/leb-helper.h',
         'wasm/module-decoder.cc',
         'wasm/module-decoder.h',
+        'wasm/signature-map.cc',
+        'wasm/signature-map.h',
         'wasm/switch-logic.h',
         'wasm/switch-logic.cc',
         'wasm/wasm-debug.cc',
@@ -1189,6 +1202,8 @@
         'wasm/wasm-opcodes.h',
         'wasm/wasm-result.cc',
         'wasm/wasm-result.h',
+        'wasm/wasm-trap-handler.cc',
+        'wasm/wasm-trap-handler.h',
         'zone.cc',
         'zone.h',
         'zone-allocator.h',
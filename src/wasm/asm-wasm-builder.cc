@@ -29,6 +29,7 @@ namespace wasm {
     DCHECK(!HasStackOverflow());    \
     call;                           \
     if (HasStackOverflow()) return; \
+    if (!valid_) return;            \
   } while (false)
 
 enum AsmScope { kModuleScope, kInitScope, kFuncScope, kExportScope };
@@ -69,7 +70,8 @@ class AsmWasmBuilderImpl : public AstVisitor {
                          ZoneHashMap::kDefaultHashMapCapacity,
                          ZoneAllocationPolicy(zone)),
         imported_function_table_(this),
-        bounds_(typer->bounds()) {
+        bounds_(typer->bounds()),
+        valid_(true) {
     InitializeAstVisitor(isolate);
   }
 
@@ -126,6 +128,15 @@ class AsmWasmBuilderImpl : public AstVisitor {
   void VisitFunctionDeclaration(FunctionDeclaration* decl) override {
     DCHECK_EQ(kModuleScope, scope_);
     DCHECK_NULL(current_function_builder_);
+    // Validate the body right before translating it. Its type bounds live in
+    // a zone of their own, which is freed as soon as the body is translated.
+    Zone function_zone(isolate_->allocator());
+    AstTypeBounds function_bounds(&function_zone);
+    if (!typer_->ValidateFunction(decl, &function_bounds)) {
+      valid_ = false;
+      return;
+    }
+    bounds_ = &function_bounds;
     uint32_t index = LookupOrInsertFunction(decl->proxy()->var());
     current_function_builder_ = builder_->FunctionAt(index);
     scope_ = kFuncScope;
@@ -133,6 +144,7 @@ class AsmWasmBuilderImpl : public AstVisitor {
     scope_ = kModuleScope;
     current_function_builder_ = nullptr;
     local_variables_.Clear();
+    bounds_ = typer_->bounds();
   }
 
   void VisitImportDeclaration(ImportDeclaration* decl) override {}
@@ -1761,6 +1773,7 @@ class AsmWasmBuilderImpl : public AstVisitor {
   ZoneHashMap function_tables_;
   ImportedFunctionTable imported_function_table_;
   const AstTypeBounds* bounds_;
+  bool valid_;
 
   DEFINE_AST_VISITOR_SUBCLASS_MEMBERS();
 
@@ -1777,6 +1790,7 @@ AsmWasmBuilder::AsmWasmBuilder(Isolate* isolate, Zone* zone,
 ZoneBuffer* AsmWasmBuilder::Run(i::Handle<i::FixedArray>* foreign_args) {
   AsmWasmBuilderImpl impl(isolate_, zone_, literal_, typer_);
   impl.Build();
+  if (!impl.valid_ || impl.HasStackOverflow()) return nullptr;
   *foreign_args = impl.GetForeignArgs();
   ZoneBuffer* buffer = new (zone_) ZoneBuffer(zone_);
   impl.builder_->WriteTo(*buffer);
@@ -18,10 +18,16 @@ class FunctionLiteral;
 
 namespace wasm {
 
+// Translates an asm.js module to a wasm module. The {typer} must have
+// validated the module with AsmTyper::ValidateModule. The function bodies are
+// validated one at a time while they are translated, so only the types of one
+// body are kept alive at any time.
 class AsmWasmBuilder {
  public:
   explicit AsmWasmBuilder(Isolate* isolate, Zone* zone, FunctionLiteral* root,
                           AsmTyper* typer);
+  // Returns nullptr if a function body fails to validate, in which case the
+  // typer holds the error message.
   ZoneBuffer* Run(Handle<FixedArray>* foreign_args);
 
  private:
@@ -333,6 +333,17 @@ class Decoder {
     error_msg_.Reset(nullptr);
   }
 
+  // Continues at the same offsets in a copy of the bytes that starts at
+  // {start}.
+  void Rebase(const byte* start) {
+    pc_ = start + (pc_ - start_);
+    limit_ = start + (limit_ - start_);
+    end_ = start + (end_ - start_);
+    if (error_pc_ != nullptr) error_pc_ = start + (error_pc_ - start_);
+    if (error_pt_ != nullptr) error_pt_ = start + (error_pt_ - start_);
+    start_ = start;
+  }
+
   bool ok() const { return error_pc_ == nullptr; }
   bool failed() const { return !error_msg_.is_empty(); }
   bool more() const { return pc_ < limit_; }
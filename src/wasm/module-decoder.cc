@@ -4,8 +4,11 @@
 
 #include "src/wasm/module-decoder.h"
 
+#include "src/base/atomic-utils.h"
 #include "src/base/functional.h"
 #include "src/base/platform/platform.h"
+#include "src/base/platform/semaphore.h"
+#include "src/cancelable-task.h"
 #include "src/macro-assembler.h"
 #include "src/objects.h"
 #include "src/v8.h"
@@ -25,14 +28,15 @@ namespace wasm {
 #define TRACE(...)
 #endif
 
-namespace {
-
 // The main logic for decoding the bytes of a module.
 class ModuleDecoder : public Decoder {
  public:
   ModuleDecoder(Zone* zone, const byte* module_start, const byte* module_end,
                 ModuleOrigin origin)
-      : Decoder(module_start, module_end), module_zone(zone), origin_(origin) {
+      : Decoder(module_start, module_end),
+        module_zone(zone),
+        origin_(origin),
+        current_order_(0) {
     result_.start = start_;
     if (limit_ < start_) {
       error(start_, "end is less than start");
@@ -70,7 +74,28 @@ class ModuleDecoder : public Decoder {
   }
 
   // Decodes an entire module.
-  ModuleResult DecodeModule(WasmModule* module, bool verify_functions = true) {
+  ModuleResult DecodeModule(Isolate* isolate, WasmModule* module,
+                            bool verify_functions = true) {
+    StartDecoding(module);
+    DecodeModuleHeader();
+
+    // Decode the module sections.
+    while (pc_ < limit_) {
+      uint32_t section_length = 0;
+      WasmSection::Code section = DecodeSectionHeader(&section_length);
+      if (!checkAvailable(section_length)) {
+        // The section would extend beyond the end of the module.
+        break;
+      }
+      DecodeSectionPayload(module, section, section_length);
+    }
+
+    if (verify_functions && ok()) VerifyFunctionBodies(isolate, module);
+    return FinishDecoding(module);
+  }
+
+  // Prepares {module} for being decoded from the bytes of this decoder.
+  void StartDecoding(WasmModule* module) {
     pc_ = start_;
     module->module_start = start_;
     module->module_end = limit_;
@@ -79,9 +104,12 @@ class ModuleDecoder : public Decoder {
     module->mem_export = false;
     module->mem_external = false;
     module->origin = origin_;
+    current_order_ = 0;
+  }
 
+  // Decodes the magic word and the version at the start of the module.
+  void DecodeModuleHeader() {
     const byte* pos = pc_;
-    int current_order = 0;
     uint32_t magic_word = consume_u32("wasm magic");
 #define BYTES(x) (x & 0xff), (x >> 8) & 0xff, (x >> 16) & 0xff, (x >> 24) & 0xff
     if (magic_word != kWasmMagic) {
@@ -89,325 +117,342 @@ class ModuleDecoder : public Decoder {
             "expected magic word %02x %02x %02x %02x, "
             "found %02x %02x %02x %02x",
             BYTES(kWasmMagic), BYTES(magic_word));
-      goto done;
+      return;
     }
 
     pos = pc_;
-    {
-      uint32_t magic_version = consume_u32("wasm version");
-      if (magic_version != kWasmVersion) {
-        error(pos, pos,
-              "expected version %02x %02x %02x %02x, "
-              "found %02x %02x %02x %02x",
-              BYTES(kWasmVersion), BYTES(magic_version));
-        goto done;
-      }
+    uint32_t magic_version = consume_u32("wasm version");
+    if (magic_version != kWasmVersion) {
+      error(pos, pos,
+            "expected version %02x %02x %02x %02x, "
+            "found %02x %02x %02x %02x",
+            BYTES(kWasmVersion), BYTES(magic_version));
     }
+#undef BYTES
+  }
 
-    // Decode the module sections.
-    while (pc_ < limit_) {
-      TRACE("DecodeSection\n");
-      pos = pc_;
-
-      // Read the section name.
-      uint32_t string_length = consume_u32v("section name length");
-      const byte* section_name_start = pc_;
-      consume_bytes(string_length);
-      if (failed()) {
-        TRACE("Section name of length %u couldn't be read\n", string_length);
-        break;
-      }
+  // Decodes the name and the length of the next section and checks that the
+  // section is in order. Leaves {pc_} at the start of the section payload.
+  WasmSection::Code DecodeSectionHeader(uint32_t* section_length) {
+    TRACE("DecodeSection\n");
 
-      TRACE("  +%d  section name        : \"%.*s\"\n",
-            static_cast<int>(section_name_start - start_),
-            string_length < 20 ? string_length : 20, section_name_start);
+    // Read the section name.
+    uint32_t string_length = consume_u32v("section name length");
+    const byte* section_name_start = pc_;
+    consume_bytes(string_length);
+    if (failed()) {
+      TRACE("Section name of length %u couldn't be read\n", string_length);
+      return WasmSection::Code::Max;
+    }
 
-      WasmSection::Code section =
-          WasmSection::lookup(section_name_start, string_length);
+    TRACE("  +%d  section name        : \"%.*s\"\n",
+          static_cast<int>(section_name_start - start_),
+          string_length < 20 ? string_length : 20, section_name_start);
 
-      // Read and check the section size.
-      uint32_t section_length = consume_u32v("section length");
-      if (!checkAvailable(section_length)) {
-        // The section would extend beyond the end of the module.
-        break;
+    WasmSection::Code section =
+        WasmSection::lookup(section_name_start, string_length);
+    if (section == WasmSection::Code::Max) {
+      TRACE("Unknown section: '");
+      for (uint32_t i = 0; i != string_length; ++i) {
+        TRACE("%c", *(section_name_start + i));
       }
-      const byte* section_start = pc_;
-      const byte* expected_section_end = pc_ + section_length;
+      TRACE("'\n");
+    }
 
-      current_order = CheckSectionOrder(current_order, section);
+    // Read the section size.
+    *section_length = consume_u32v("section length");
 
-      switch (section) {
-        case WasmSection::Code::End:
-          // Terminate section decoding.
-          limit_ = pc_;
-          break;
-        case WasmSection::Code::Memory: {
-          module->min_mem_pages = consume_u32v("min memory");
-          module->max_mem_pages = consume_u32v("max memory");
-          module->mem_export = consume_u8("export memory") != 0;
-          break;
+    current_order_ = CheckSectionOrder(current_order_, section);
+    return section;
+  }
+
+  // Decodes the payload of a section whose bytes are all available.
+  void DecodeSectionPayload(WasmModule* module, WasmSection::Code section,
+                            uint32_t section_length) {
+    const byte* section_start = pc_;
+    switch (section) {
+      case WasmSection::Code::End:
+        // Terminate section decoding.
+        limit_ = pc_;
+        break;
+      case WasmSection::Code::Memory: {
+        module->min_mem_pages = consume_u32v("min memory");
+        module->max_mem_pages = consume_u32v("max memory");
+        module->mem_export = consume_u8("export memory") != 0;
+        break;
+      }
+      case WasmSection::Code::Signatures: {
+        uint32_t signatures_count = consume_u32v("signatures count");
+        module->signatures.reserve(SafeReserve(signatures_count));
+        // Decode signatures.
+        for (uint32_t i = 0; i < signatures_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeSignature[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+          FunctionSig* s = consume_sig();
+          module->signatures.push_back(s);
+          if (s != nullptr) module->signature_map.FindOrInsert(s);
         }
-        case WasmSection::Code::Signatures: {
-          uint32_t signatures_count = consume_u32v("signatures count");
-          module->signatures.reserve(SafeReserve(signatures_count));
-          // Decode signatures.
-          for (uint32_t i = 0; i < signatures_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeSignature[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-            FunctionSig* s = consume_sig();
-            module->signatures.push_back(s);
-          }
-          break;
+        break;
+      }
+      case WasmSection::Code::FunctionSignatures: {
+        uint32_t functions_count = consume_u32v("functions count");
+        module->functions.reserve(SafeReserve(functions_count));
+        for (uint32_t i = 0; i < functions_count; ++i) {
+          module->functions.push_back({nullptr,  // sig
+                                       i,        // func_index
+                                       0,        // sig_index
+                                       0,        // name_offset
+                                       0,        // name_length
+                                       0,        // code_start_offset
+                                       0});      // code_end_offset
+          WasmFunction* function = &module->functions.back();
+          function->sig_index = consume_sig_index(module, &function->sig);
         }
-        case WasmSection::Code::FunctionSignatures: {
-          uint32_t functions_count = consume_u32v("functions count");
-          module->functions.reserve(SafeReserve(functions_count));
-          for (uint32_t i = 0; i < functions_count; ++i) {
-            module->functions.push_back({nullptr,  // sig
-                                         i,        // func_index
-                                         0,        // sig_index
-                                         0,        // name_offset
-                                         0,        // name_length
-                                         0,        // code_start_offset
-                                         0});      // code_end_offset
-            WasmFunction* function = &module->functions.back();
-            function->sig_index = consume_sig_index(module, &function->sig);
-          }
-          break;
+        break;
+      }
+      case WasmSection::Code::FunctionBodies: {
+        uint32_t functions_count = DecodeFunctionBodiesCount(module);
+        for (uint32_t i = 0; ok() && i < functions_count; ++i) {
+          DecodeFunctionBody(&module->functions[i]);
         }
-        case WasmSection::Code::FunctionBodies: {
-          const byte* pos = pc_;
-          uint32_t functions_count = consume_u32v("functions count");
-          if (functions_count != module->functions.size()) {
-            error(pos, pos, "function body count %u mismatch (%u expected)",
-                  functions_count,
-                  static_cast<uint32_t>(module->functions.size()));
-            break;
-          }
-          for (uint32_t i = 0; i < functions_count; ++i) {
-            WasmFunction* function = &module->functions[i];
-            uint32_t size = consume_u32v("body size");
-            function->code_start_offset = pc_offset();
-            function->code_end_offset = pc_offset() + size;
-
-            TRACE("  +%d  %-20s: (%d bytes)\n", pc_offset(), "function body",
-                  size);
-            pc_ += size;
-            if (pc_ > limit_) {
-              error(pc_, "function body extends beyond end of file");
-            }
-          }
+        break;
+      }
+      case WasmSection::Code::Names: {
+        const byte* pos = pc_;
+        uint32_t functions_count = consume_u32v("functions count");
+        if (functions_count != module->functions.size()) {
+          error(pos, pos, "function name count %u mismatch (%u expected)",
+                functions_count,
+                static_cast<uint32_t>(module->functions.size()));
           break;
         }
-        case WasmSection::Code::Names: {
-          const byte* pos = pc_;
-          uint32_t functions_count = consume_u32v("functions count");
-          if (functions_count != module->functions.size()) {
-            error(pos, pos, "function name count %u mismatch (%u expected)",
-                  functions_count,
-                  static_cast<uint32_t>(module->functions.size()));
-            break;
-          }
 
-          for (uint32_t i = 0; i < functions_count; ++i) {
-            WasmFunction* function = &module->functions[i];
-            function->name_offset =
-                consume_string(&function->name_length, false);
-
-            uint32_t local_names_count = consume_u32v("local names count");
-            for (uint32_t j = 0; j < local_names_count; j++) {
-              uint32_t unused = 0;
-              uint32_t offset = consume_string(&unused, false);
-              USE(unused);
-              USE(offset);
-            }
+        for (uint32_t i = 0; i < functions_count; ++i) {
+          WasmFunction* function = &module->functions[i];
+          function->name_offset =
+              consume_string(&function->name_length, false);
+
+          uint32_t local_names_count = consume_u32v("local names count");
+          for (uint32_t j = 0; j < local_names_count; j++) {
+            uint32_t unused = 0;
+            uint32_t offset = consume_string(&unused, false);
+            USE(unused);
+            USE(offset);
           }
-          break;
         }
-        case WasmSection::Code::Globals: {
-          uint32_t globals_count = consume_u32v("globals count");
-          module->globals.reserve(SafeReserve(globals_count));
-          // Decode globals.
-          for (uint32_t i = 0; i < globals_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeGlobal[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-            module->globals.push_back({0, 0, MachineType::Int32(), 0, false});
-            WasmGlobal* global = &module->globals.back();
-            DecodeGlobalInModule(global);
-          }
-          break;
+        break;
+      }
+      case WasmSection::Code::Globals: {
+        uint32_t globals_count = consume_u32v("globals count");
+        module->globals.reserve(SafeReserve(globals_count));
+        // Decode globals.
+        for (uint32_t i = 0; i < globals_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeGlobal[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+          module->globals.push_back({0, 0, MachineType::Int32(), 0, false});
+          WasmGlobal* global = &module->globals.back();
+          DecodeGlobalInModule(global);
         }
-        case WasmSection::Code::DataSegments: {
-          uint32_t data_segments_count = consume_u32v("data segments count");
-          module->data_segments.reserve(SafeReserve(data_segments_count));
-          // Decode data segments.
-          for (uint32_t i = 0; i < data_segments_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeDataSegment[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-            module->data_segments.push_back({0,        // dest_addr
-                                             0,        // source_offset
-                                             0,        // source_size
-                                             false});  // init
-            WasmDataSegment* segment = &module->data_segments.back();
-            DecodeDataSegmentInModule(module, segment);
-          }
-          break;
+        break;
+      }
+      case WasmSection::Code::DataSegments: {
+        uint32_t data_segments_count = consume_u32v("data segments count");
+        module->data_segments.reserve(SafeReserve(data_segments_count));
+        // Decode data segments.
+        for (uint32_t i = 0; i < data_segments_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeDataSegment[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+          module->data_segments.push_back({0,        // dest_addr
+                                           0,        // source_offset
+                                           0,        // source_size
+                                           false});  // init
+          WasmDataSegment* segment = &module->data_segments.back();
+          DecodeDataSegmentInModule(module, segment);
         }
-        case WasmSection::Code::FunctionTablePad: {
-          if (!FLAG_wasm_jit_prototype) {
-            error("FunctionTablePad section without jiting enabled");
-          }
-          // An indirect function table requires functions first.
-          module->indirect_table_size = consume_u32v("indirect entry count");
-          if (module->indirect_table_size > 0 &&
-              module->indirect_table_size < module->function_table.size()) {
-            error("more predefined indirect entries than table can hold");
-          }
-          break;
+        break;
+      }
+      case WasmSection::Code::FunctionTablePad: {
+        if (!FLAG_wasm_jit_prototype) {
+          error("FunctionTablePad section without jiting enabled");
         }
-        case WasmSection::Code::FunctionTable: {
-          // An indirect function table requires functions first.
-          CheckForFunctions(module, section);
-          uint32_t function_table_count = consume_u32v("function table count");
-          module->function_table.reserve(SafeReserve(function_table_count));
-          // Decode function table.
-          for (uint32_t i = 0; i < function_table_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeFunctionTable[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-            uint16_t index = consume_u32v();
-            if (index >= module->functions.size()) {
-              error(pc_ - 2, "invalid function index");
-              break;
-            }
-            module->function_table.push_back(index);
-          }
-          if (module->indirect_table_size > 0 &&
-              module->indirect_table_size < module->function_table.size()) {
-            error("more predefined indirect entries than table can hold");
-          }
-          break;
+        // An indirect function table requires functions first.
+        module->indirect_table_size = consume_u32v("indirect entry count");
+        if (module->indirect_table_size > 0 &&
+            module->indirect_table_size < module->function_table.size()) {
+          error("more predefined indirect entries than table can hold");
         }
-        case WasmSection::Code::StartFunction: {
-          // Declares a start function for a module.
-          CheckForFunctions(module, section);
-          if (module->start_function_index >= 0) {
-            error("start function already declared");
-            break;
-          }
-          WasmFunction* func;
-          const byte* pos = pc_;
-          module->start_function_index = consume_func_index(module, &func);
-          if (func && func->sig->parameter_count() > 0) {
-            error(pos, "invalid start function: non-zero parameter count");
+        break;
+      }
+      case WasmSection::Code::FunctionTable: {
+        // An indirect function table requires functions first.
+        CheckForFunctions(module, section);
+        uint32_t function_table_count = consume_u32v("function table count");
+        module->function_table.reserve(SafeReserve(function_table_count));
+        // Decode function table.
+        for (uint32_t i = 0; i < function_table_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeFunctionTable[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+          uint16_t index = consume_u32v();
+          if (index >= module->functions.size()) {
+            error(pc_ - 2, "invalid function index");
             break;
           }
-          break;
+          module->function_table.push_back(index);
         }
-        case WasmSection::Code::ImportTable: {
-          uint32_t import_table_count = consume_u32v("import table count");
-          module->import_table.reserve(SafeReserve(import_table_count));
-          // Decode import table.
-          for (uint32_t i = 0; i < import_table_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeImportTable[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-
-            module->import_table.push_back({nullptr,  // sig
-                                            0,        // sig_index
-                                            0,        // module_name_offset
-                                            0,        // module_name_length
-                                            0,        // function_name_offset
-                                            0});      // function_name_length
-            WasmImport* import = &module->import_table.back();
-
-            import->sig_index = consume_sig_index(module, &import->sig);
-            const byte* pos = pc_;
-            import->module_name_offset =
-                consume_string(&import->module_name_length, true);
-            if (import->module_name_length == 0) {
-              error(pos, "import module name cannot be NULL");
-            }
-            import->function_name_offset =
-                consume_string(&import->function_name_length, true);
-          }
+        if (module->indirect_table_size > 0 &&
+            module->indirect_table_size < module->function_table.size()) {
+          error("more predefined indirect entries than table can hold");
+        }
+        break;
+      }
+      case WasmSection::Code::StartFunction: {
+        // Declares a start function for a module.
+        CheckForFunctions(module, section);
+        if (module->start_function_index >= 0) {
+          error("start function already declared");
           break;
         }
-        case WasmSection::Code::ExportTable: {
-          // Declares an export table.
-          CheckForFunctions(module, section);
-          uint32_t export_table_count = consume_u32v("export table count");
-          module->export_table.reserve(SafeReserve(export_table_count));
-          // Decode export table.
-          for (uint32_t i = 0; i < export_table_count; ++i) {
-            if (failed()) break;
-            TRACE("DecodeExportTable[%d] module+%d\n", i,
-                  static_cast<int>(pc_ - start_));
-
-            module->export_table.push_back({0,    // func_index
-                                            0,    // name_offset
-                                            0});  // name_length
-            WasmExport* exp = &module->export_table.back();
-
-            WasmFunction* func;
-            exp->func_index = consume_func_index(module, &func);
-            exp->name_offset = consume_string(&exp->name_length, true);
-          }
-          // Check for duplicate exports.
-          if (ok() && module->export_table.size() > 1) {
-            std::vector<WasmExport> sorted_exports(module->export_table);
-            const byte* base = start_;
-            auto cmp_less = [base](const WasmExport& a, const WasmExport& b) {
-              // Return true if a < b.
-              uint32_t len = a.name_length;
-              if (len != b.name_length) return len < b.name_length;
-              return memcmp(base + a.name_offset, base + b.name_offset, len) <
-                     0;
-            };
-            std::stable_sort(sorted_exports.begin(), sorted_exports.end(),
-                             cmp_less);
-            auto it = sorted_exports.begin();
-            WasmExport* last = &*it++;
-            for (auto end = sorted_exports.end(); it != end; last = &*it++) {
-              DCHECK(!cmp_less(*it, *last));  // Vector must be sorted.
-              if (!cmp_less(*last, *it)) {
-                const byte* pc = start_ + it->name_offset;
-                error(pc, pc,
-                      "Duplicate export name '%.*s' for functions %d and %d",
-                      it->name_length, pc, last->func_index, it->func_index);
-                break;
-              }
-            }
-          }
+        WasmFunction* func;
+        const byte* pos = pc_;
+        module->start_function_index = consume_func_index(module, &func);
+        if (func && func->sig->parameter_count() > 0) {
+          error(pos, "invalid start function: non-zero parameter count");
           break;
         }
-        case WasmSection::Code::Max:
-          // Skip unknown sections.
-          TRACE("Unknown section: '");
-          for (uint32_t i = 0; i != string_length; ++i) {
-            TRACE("%c", *(section_name_start + i));
+        break;
+      }
+      case WasmSection::Code::ImportTable: {
+        uint32_t import_table_count = consume_u32v("import table count");
+        module->import_table.reserve(SafeReserve(import_table_count));
+        // Decode import table.
+        for (uint32_t i = 0; i < import_table_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeImportTable[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+
+          module->import_table.push_back({nullptr,  // sig
+                                          0,        // sig_index
+                                          0,        // module_name_offset
+                                          0,        // module_name_length
+                                          0,        // function_name_offset
+                                          0});      // function_name_length
+          WasmImport* import = &module->import_table.back();
+
+          import->sig_index = consume_sig_index(module, &import->sig);
+          const byte* pos = pc_;
+          import->module_name_offset =
+              consume_string(&import->module_name_length, true);
+          if (import->module_name_length == 0) {
+            error(pos, "import module name cannot be NULL");
           }
-          TRACE("'\n");
-          consume_bytes(section_length);
-          break;
+          import->function_name_offset =
+              consume_string(&import->function_name_length, true);
+        }
+        break;
       }
+      case WasmSection::Code::ExportTable: {
+        // Declares an export table.
+        CheckForFunctions(module, section);
+        uint32_t export_table_count = consume_u32v("export table count");
+        module->export_table.reserve(SafeReserve(export_table_count));
+        // Decode export table.
+        for (uint32_t i = 0; i < export_table_count; ++i) {
+          if (failed()) break;
+          TRACE("DecodeExportTable[%d] module+%d\n", i,
+                static_cast<int>(pc_ - start_));
+
+          module->export_table.push_back({0,    // func_index
+                                          0,    // name_offset
+                                          0});  // name_length
+          WasmExport* exp = &module->export_table.back();
 
-      if (pc_ != expected_section_end) {
-        const char* diff = pc_ < expected_section_end ? "shorter" : "longer";
-        size_t expected_length = static_cast<size_t>(section_length);
-        size_t actual_length = static_cast<size_t>(pc_ - section_start);
-        error(pc_, pc_,
-              "section \"%s\" %s (%zu bytes) than specified (%zu bytes)",
-              WasmSection::getName(section), diff, actual_length,
-              expected_length);
+          WasmFunction* func;
+          exp->func_index = consume_func_index(module, &func);
+          exp->name_offset = consume_string(&exp->name_length, true);
+        }
+        // Check for duplicate exports.
+        if (ok() && module->export_table.size() > 1) {
+          std::vector<WasmExport> sorted_exports(module->export_table);
+          const byte* base = start_;
+          auto cmp_less = [base](const WasmExport& a, const WasmExport& b) {
+            // Return true if a < b.
+            uint32_t len = a.name_length;
+            if (len != b.name_length) return len < b.name_length;
+            return memcmp(base + a.name_offset, base + b.name_offset, len) <
+                   0;
+          };
+          std::stable_sort(sorted_exports.begin(), sorted_exports.end(),
+                           cmp_less);
+          auto it = sorted_exports.begin();
+          WasmExport* last = &*it++;
+          for (auto end = sorted_exports.end(); it != end; last = &*it++) {
+            DCHECK(!cmp_less(*it, *last));  // Vector must be sorted.
+            if (!cmp_less(*last, *it)) {
+              const byte* pc = start_ + it->name_offset;
+              error(pc, pc,
+                    "Duplicate export name '%.*s' for functions %d and %d",
+                    it->name_length, pc, last->func_index, it->func_index);
+              break;
+            }
+          }
+        }
         break;
       }
+      case WasmSection::Code::Max:
+        // Skip unknown sections.
+        consume_bytes(section_length);
+        break;
     }
 
-  done:
+    CheckSectionEnd(section, section_start, section_length);
+  }
+
+  // Checks that a section ends where its header said it would.
+  void CheckSectionEnd(WasmSection::Code section, const byte* section_start,
+                       uint32_t section_length) {
+    const byte* expected_section_end = section_start + section_length;
+    if (ok() && pc_ != expected_section_end) {
+      const char* diff = pc_ < expected_section_end ? "shorter" : "longer";
+      size_t expected_length = static_cast<size_t>(section_length);
+      size_t actual_length = static_cast<size_t>(pc_ - section_start);
+      error(pc_, pc_,
+            "section \"%s\" %s (%zu bytes) than specified (%zu bytes)",
+            WasmSection::getName(section), diff, actual_length,
+            expected_length);
+    }
+  }
+
+  // Decodes the number of function bodies at the start of the code section.
+  uint32_t DecodeFunctionBodiesCount(WasmModule* module) {
+    const byte* pos = pc_;
+    uint32_t functions_count = consume_u32v("functions count");
+    if (functions_count != module->functions.size()) {
+      error(pos, pos, "function body count %u mismatch (%u expected)",
+            functions_count, static_cast<uint32_t>(module->functions.size()));
+      return 0;
+    }
+    return functions_count;
+  }
+
+  // Decodes the size of the body of {function} and skips over the body.
+  void DecodeFunctionBody(WasmFunction* function) {
+    uint32_t size = consume_u32v("body size");
+    function->code_start_offset = pc_offset();
+    function->code_end_offset = pc_offset() + size;
+
+    TRACE("  +%d  %-20s: (%d bytes)\n", pc_offset(), "function body", size);
+    pc_ += size;
+    if (pc_ > limit_) {
+      error(pc_, "function body extends beyond end of file");
+    }
+  }
+
+  // Completes the decoding of {module} once all sections have been decoded.
+  ModuleResult FinishDecoding(WasmModule* module) {
     if (ok()) CalculateGlobalsOffsets(module);
     const WasmModule* finished_module = module;
     ModuleResult result = toResult(finished_module);
@@ -417,6 +462,28 @@ class ModuleDecoder : public Decoder {
     return result;
   }
 
+  // Continues decoding {module} in a copy of its bytes that starts at {start}.
+  void Rebase(const byte* start, WasmModule* module) {
+    if (result_.error_pc != nullptr) {
+      result_.error_pc = start + (result_.error_pc - start_);
+    }
+    if (result_.error_pt != nullptr) {
+      result_.error_pt = start + (result_.error_pt - start_);
+    }
+    result_.start = start;
+    module->module_start = start;
+    module->module_end = start + (module->module_end - start_);
+    Decoder::Rebase(start);
+  }
+
+  // Makes the bytes up to {limit} available to this decoder.
+  void ExtendLimit(const byte* limit) {
+    DCHECK_GE(limit, limit_);
+    if (failed()) return;
+    limit_ = limit;
+    end_ = limit;
+  }
+
   uint32_t SafeReserve(uint32_t count) {
     // Avoid OOM by only reserving up to a certain size.
     const uint32_t kMaxReserve = 20000;
@@ -473,6 +540,7 @@ class ModuleDecoder : public Decoder {
   Zone* module_zone;
   ModuleResult result_;
   ModuleOrigin origin_;
+  int current_order_;
 
   uint32_t off(const byte* ptr) { return static_cast<uint32_t>(ptr - start_); }
 
@@ -549,24 +617,42 @@ class ModuleDecoder : public Decoder {
                          start_ + function->code_start_offset,
                          start_ + function->code_end_offset};
     TreeResult result = VerifyWasmCode(module_zone->allocator(), body);
-    if (result.failed()) {
-      // Wrap the error message from the function decoder.
-      std::ostringstream str;
-      str << "in function " << WasmFunctionName(function, menv) << ": ";
-      str << result;
-      std::string strval = str.str();
-      const char* raw = strval.c_str();
-      size_t len = strlen(raw);
-      char* buffer = new char[len];
-      strncpy(buffer, raw, len);
-      buffer[len - 1] = 0;
+    if (result.failed()) ReportFunctionError(menv, function, result);
+  }
 
-      // Copy error code and location.
-      result_.CopyFrom(result);
-      result_.error_msg.Reset(buffer);
+  // Verifies the bodies of all functions of {module}, in parallel.
+  void VerifyFunctionBodies(Isolate* isolate, WasmModule* module) {
+    ModuleEnv menv;
+    menv.module = module;
+    menv.instance = nullptr;
+    menv.origin = origin_;
+    uint32_t failed_index = 0;
+    TreeResult result =
+        wasm::VerifyFunctionBodies(isolate, &menv, &failed_index);
+    if (result.failed()) {
+      ReportFunctionError(&menv, &module->functions[failed_index], result);
     }
   }
 
+  // Makes the failure of the body of {function} the result of this decoder.
+  void ReportFunctionError(ModuleEnv* menv, WasmFunction* function,
+                           TreeResult& result) {
+    // Wrap the error message from the function decoder.
+    std::ostringstream str;
+    str << "in function " << WasmFunctionName(function, menv) << ": ";
+    str << result;
+    std::string strval = str.str();
+    const char* raw = strval.c_str();
+    size_t len = strlen(raw);
+    char* buffer = new char[len];
+    strncpy(buffer, raw, len);
+    buffer[len - 1] = 0;
+
+    // Copy error code and location.
+    result_.CopyFrom(result);
+    result_.error_msg.Reset(buffer);
+  }
+
   // Reads a single 32-bit unsigned integer interpreted as an offset, checking
   // the offset is within bounds and advances.
   uint32_t consume_offset(const char* name = nullptr) {
@@ -714,6 +800,8 @@ class ModuleDecoder : public Decoder {
   }
 };
 
+namespace {
+
 // Helpers for nice error messages.
 class ModuleError : public ModuleResult {
  public:
@@ -773,8 +861,119 @@ Vector<const byte> FindSection(const byte* module_start, const byte* module_end,
   return Vector<const uint8_t>();
 }
 
+// The state shared by the threads that verify the function bodies of a module.
+class FunctionBodyVerification {
+ public:
+  FunctionBodyVerification(Isolate* isolate, ModuleEnv* module_env)
+      : allocator_(isolate->allocator()),
+        module_env_(module_env),
+        next_function_(0),
+        first_failure_(module_env->module->functions.size()) {}
+
+  // Verifies the next function body that is not yet taken by another thread.
+  // Returns false if there is none left, or if all bodies left come after a
+  // body that is known to fail and therefore cannot change the result.
+  bool VerifyNextFunctionBody() {
+    const WasmModule* module = module_env_->module;
+    size_t index = next_function_.Increment(1) - 1;
+    if (index >= module->functions.size()) return false;
+    if (index > first_failure_.Value()) return false;
+    const WasmFunction& function = module->functions[index];
+    FunctionBody body = {module_env_, function.sig, module->module_start,
+                         module->module_start + function.code_start_offset,
+                         module->module_start + function.code_end_offset};
+    TreeResult result = VerifyWasmCode(allocator_, body);
+    if (result.failed()) {
+      // Keep the index of the first failing function in module order.
+      size_t first = first_failure_.Value();
+      while (index < first && !first_failure_.TrySetValue(first, index)) {
+        first = first_failure_.Value();
+      }
+    }
+    return true;
+  }
+
+  // The index of the first failing function, or the number of functions.
+  size_t first_failure() { return first_failure_.Value(); }
+
+ private:
+  base::AccountingAllocator* allocator_;
+  ModuleEnv* module_env_;
+  base::AtomicNumber<size_t> next_function_;
+  base::AtomicValue<size_t> first_failure_;
+};
+
+class FunctionBodyVerificationTask : public CancelableTask {
+ public:
+  FunctionBodyVerificationTask(Isolate* isolate,
+                               FunctionBodyVerification* verification,
+                               base::Semaphore* on_finished)
+      : CancelableTask(isolate),
+        verification_(verification),
+        on_finished_(on_finished) {}
+
+  void RunInternal() override {
+    while (verification_->VerifyNextFunctionBody()) {
+    }
+    on_finished_->Signal();
+  }
+
+ private:
+  FunctionBodyVerification* verification_;
+  base::Semaphore* on_finished_;
+};
+
 }  // namespace
 
+TreeResult VerifyFunctionBodies(Isolate* isolate, ModuleEnv* module_env,
+                                uint32_t* failed_index) {
+  const WasmModule* module = module_env->module;
+  FunctionBodyVerification verification(isolate, module_env);
+
+  size_t num_tasks = 0;
+  if (FLAG_wasm_parallel_verification && module->functions.size() > 1) {
+    num_tasks =
+        Min(static_cast<size_t>(FLAG_wasm_num_compilation_tasks),
+            V8::GetCurrentPlatform()->NumberOfAvailableBackgroundThreads());
+  }
+  base::Semaphore pending_tasks(0);
+  std::unique_ptr<uint32_t[]> task_ids(new uint32_t[num_tasks]);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    FunctionBodyVerificationTask* task =
+        new FunctionBodyVerificationTask(isolate, &verification,
+                                         &pending_tasks);
+    task_ids[i] = task->id();
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+
+  // Verify on this thread as well until all bodies are taken.
+  while (verification.VerifyNextFunctionBody()) {
+  }
+
+  for (size_t i = 0; i < num_tasks; ++i) {
+    // If the task has not started yet, then we abort it. Otherwise we wait for
+    // it to finish.
+    if (!isolate->cancelable_task_manager()->TryAbort(task_ids[i])) {
+      pending_tasks.Wait();
+    }
+  }
+
+  size_t first_failure = verification.first_failure();
+  if (first_failure == module->functions.size()) return TreeResult();
+
+  // Verify the failing body again to get its error. Only the first failure
+  // is reported, so the error does not depend on the scheduling of the tasks.
+  *failed_index = static_cast<uint32_t>(first_failure);
+  const WasmFunction& function = module->functions[first_failure];
+  FunctionBody body = {module_env, function.sig, module->module_start,
+                       module->module_start + function.code_start_offset,
+                       module->module_start + function.code_end_offset};
+  TreeResult result = VerifyWasmCode(isolate->allocator(), body);
+  DCHECK(result.failed());
+  return result;
+}
+
 ModuleResult DecodeWasmModule(Isolate* isolate, Zone* zone,
                               const byte* module_start, const byte* module_end,
                               bool verify_functions, ModuleOrigin origin) {
@@ -789,13 +988,162 @@ ModuleResult DecodeWasmModule(Isolate* isolate, Zone* zone,
       static_cast<int>(size));
   WasmModule* module = new WasmModule();
   ModuleDecoder decoder(zone, module_start, module_end, origin);
-  ModuleResult result = decoder.DecodeModule(module, verify_functions);
+  ModuleResult result =
+      decoder.DecodeModule(isolate, module, verify_functions);
   // TODO(bradnelson): Improve histogram handling of size_t.
   isolate->counters()->wasm_decode_module_peak_memory_bytes()->AddSample(
       static_cast<int>(zone->allocation_size() - decode_memory_start));
   return result;
 }
 
+StreamingModuleDecoder::StreamingModuleDecoder(Isolate* isolate, Zone* zone,
+                                               const byte* module_start,
+                                               ModuleOrigin origin,
+                                               FunctionBodyListener* listener)
+    : isolate_(isolate),
+      module_(new WasmModule()),
+      decoder_(new ModuleDecoder(zone, module_start, module_start, origin)),
+      listener_(listener),
+      module_start_(module_start),
+      available_end_(module_start),
+      state_(kModuleHeader),
+      section_(WasmSection::Code::Max),
+      section_start_(nullptr),
+      section_length_(0),
+      functions_count_(0),
+      next_function_(0),
+      after_code_section_(false) {
+  decoder_->StartDecoding(module_);
+}
+
+StreamingModuleDecoder::~StreamingModuleDecoder() {
+  // Unless {Finish} has handed it out, the module is owned by the decoder.
+  if (module_ != nullptr) delete module_;
+}
+
+void StreamingModuleDecoder::OnBytesReceived(const byte* available_end) {
+  DCHECK_GE(available_end, available_end_);
+  if (static_cast<size_t>(available_end - module_start_) >= kMaxModuleSize) {
+    // Leave the error to {Finish}.
+    return;
+  }
+  available_end_ = available_end;
+  Decode(false);
+}
+
+ModuleResult StreamingModuleDecoder::Finish(const byte* module_end) {
+  DCHECK_GE(module_end, available_end_);
+  size_t size = module_end - module_start_;
+  if (size >= kMaxModuleSize) return ModuleError("size > maximum module size");
+  isolate_->counters()->wasm_module_size_bytes()->AddSample(
+      static_cast<int>(size));
+  available_end_ = module_end;
+  Decode(true);
+  module_->module_end = module_end;
+  WasmModule* module = module_;
+  module_ = nullptr;
+  return decoder_->FinishDecoding(module);
+}
+
+void StreamingModuleDecoder::Rebase(const byte* module_start) {
+  available_end_ = module_start + (available_end_ - module_start_);
+  if (section_start_ != nullptr) {
+    section_start_ = module_start + (section_start_ - module_start_);
+  }
+  decoder_->Rebase(module_start, module_);
+  module_start_ = module_start;
+}
+
+bool StreamingModuleDecoder::IsComplete(uint32_t size) const {
+  return static_cast<size_t>(available_end_ - decoder_->pc()) >= size;
+}
+
+bool StreamingModuleDecoder::IsSectionHeaderComplete() const {
+  Decoder probe(decoder_->pc(), available_end_);
+  probe.consume_bytes(probe.consume_u32v());
+  probe.consume_u32v();
+  return probe.ok();
+}
+
+bool StreamingModuleDecoder::IsFunctionBodiesCountComplete() const {
+  Decoder probe(decoder_->pc(), available_end_);
+  probe.consume_u32v();
+  return probe.ok();
+}
+
+bool StreamingModuleDecoder::IsFunctionBodyComplete() const {
+  Decoder probe(decoder_->pc(), available_end_);
+  probe.consume_bytes(probe.consume_u32v());
+  return probe.ok();
+}
+
+// Runs the decoder over the bytes that are available. Unless {at_end} is set,
+// decoding stops before the first section header, section payload or
+// function body that is incomplete, to be resumed when more bytes arrive.
+// At the end of the module, incomplete parts are errors.
+void StreamingModuleDecoder::Decode(bool at_end) {
+  decoder_->ExtendLimit(available_end_);
+  while (state_ != kFinished && decoder_->ok()) {
+    switch (state_) {
+      case kModuleHeader:
+        if (!at_end && !IsComplete(8)) return;
+        decoder_->DecodeModuleHeader();
+        state_ = kSectionHeader;
+        break;
+      case kSectionHeader:
+        if (!decoder_->more()) {
+          if (at_end) state_ = kFinished;
+          return;
+        }
+        if (!at_end && !IsSectionHeaderComplete()) return;
+        section_ = decoder_->DecodeSectionHeader(&section_length_);
+        section_start_ = decoder_->pc();
+        if (section_ == WasmSection::Code::FunctionBodies) {
+          state_ = kFunctionBodiesCount;
+          listener_->OnCodeSectionStart(module_, section_length_);
+        } else {
+          state_ = kSectionPayload;
+        }
+        break;
+      case kSectionPayload:
+        if (!at_end && !IsComplete(section_length_)) return;
+        if (!decoder_->checkAvailable(section_length_)) return;
+        if (after_code_section_ &&
+            (section_ == WasmSection::Code::Globals ||
+             section_ == WasmSection::Code::FunctionTablePad)) {
+          listener_->OnCodeInvalidated();
+        }
+        decoder_->DecodeSectionPayload(module_, section_, section_length_);
+        state_ = section_ == WasmSection::Code::End ? kFinished
+                                                    : kSectionHeader;
+        break;
+      case kFunctionBodiesCount:
+        if (!at_end && !IsFunctionBodiesCountComplete()) return;
+        functions_count_ = decoder_->DecodeFunctionBodiesCount(module_);
+        next_function_ = 0;
+        state_ = kFunctionBody;
+        break;
+      case kFunctionBody:
+        if (next_function_ == functions_count_) {
+          decoder_->CheckSectionEnd(section_, section_start_, section_length_);
+          after_code_section_ = true;
+          state_ = kSectionHeader;
+          break;
+        }
+        if (!at_end && !IsFunctionBodyComplete()) return;
+        decoder_->DecodeFunctionBody(&module_->functions[next_function_]);
+        if (decoder_->ok()) {
+          listener_->OnFunctionBody(&module_->functions[next_function_]);
+        }
+        next_function_++;
+        break;
+      case kFinished:
+        UNREACHABLE();
+        break;
+    }
+  }
+}
+
 FunctionSig* DecodeWasmSignatureForTesting(Zone* zone, const byte* start,
                                            const byte* end) {
   ModuleDecoder decoder(zone, start, end, kWasmOrigin);
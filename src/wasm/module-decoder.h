@@ -11,11 +11,93 @@
 namespace v8 {
 namespace internal {
 namespace wasm {
+class ModuleDecoder;
+
 // Decodes the bytes of a WASM module between {module_start} and {module_end}.
 ModuleResult DecodeWasmModule(Isolate* isolate, Zone* zone,
                               const byte* module_start, const byte* module_end,
                               bool verify_functions, ModuleOrigin origin);
 
+// Verifies the bodies of all functions of the module of {module_env}. The
+// bodies are verified in parallel on background threads. If any body fails,
+// the result is the failure of the first failing function in module order,
+// whose index is stored in {failed_index}, independent of the scheduling.
+TreeResult VerifyFunctionBodies(Isolate* isolate, ModuleEnv* module_env,
+                                uint32_t* failed_index);
+
+// Receives the function bodies of a module from a {StreamingModuleDecoder}
+// as soon as their bytes have arrived.
+class FunctionBodyListener {
+ public:
+  virtual ~FunctionBodyListener() {}
+
+  // Called when the code section starts. All sections before it have been
+  // decoded into {module}; {code_size} is the length of the code section.
+  virtual void OnCodeSectionStart(WasmModule* module, uint32_t code_size) = 0;
+
+  // Called when all bytes of the body of {function} have arrived.
+  virtual void OnFunctionBody(WasmFunction* function) = 0;
+
+  // Called before a section after the code section changes the globals or
+  // the size of the function table, which code compiled for the function
+  // bodies so far depends on.
+  virtual void OnCodeInvalidated() = 0;
+};
+
+// Decodes a WASM module whose bytes arrive in chunks. The bytes must be
+// appended to a buffer starting at {module_start} that never moves, since the
+// decoded module refers to them. Sections are decoded as soon as they are
+// complete, and the function bodies of the code section one at a time.
+class StreamingModuleDecoder {
+ public:
+  StreamingModuleDecoder(Isolate* isolate, Zone* zone,
+                         const byte* module_start, ModuleOrigin origin,
+                         FunctionBodyListener* listener);
+  ~StreamingModuleDecoder();
+
+  // Decodes as much as possible of the bytes up to {available_end}.
+  void OnBytesReceived(const byte* available_end);
+
+  // Decodes the rest of the module, which ends at {module_end}.
+  ModuleResult Finish(const byte* module_end);
+
+  // Continues with a copy of the module bytes that starts at {module_start},
+  // after the bytes received so far were moved there.
+  void Rebase(const byte* module_start);
+
+ private:
+  enum State {
+    kModuleHeader,
+    kSectionHeader,
+    kSectionPayload,
+    kFunctionBodiesCount,
+    kFunctionBody,
+    kFinished
+  };
+
+  void Decode(bool at_end);
+  bool IsComplete(uint32_t size) const;
+  bool IsSectionHeaderComplete() const;
+  bool IsFunctionBodiesCountComplete() const;
+  bool IsFunctionBodyComplete() const;
+
+  Isolate* isolate_;
+  WasmModule* module_;
+  base::SmartPointer<ModuleDecoder> decoder_;
+  FunctionBodyListener* listener_;
+  const byte* module_start_;
+  const byte* available_end_;
+  State state_;
+  WasmSection::Code section_;
+  const byte* section_start_;
+  uint32_t section_length_;
+  uint32_t functions_count_;
+  uint32_t next_function_;
+  bool after_code_section_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingModuleDecoder);
+};
+
 // Exposed for testing. Decodes a single function signature, allocating it
 // in the given zone. Returns {nullptr} upon failure.
 FunctionSig* DecodeWasmSignatureForTesting(Zone* zone, const byte* start,
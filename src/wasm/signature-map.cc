@@ -0,0 +1,60 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/wasm/signature-map.h"
+
+#include "src/base/lazy-instance.h"
+#include "src/base/platform/mutex.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+
+namespace {
+
+base::LazyInstance<SignatureMap>::type canonical_signatures =
+    LAZY_INSTANCE_INITIALIZER;
+base::LazyMutex canonical_signatures_mutex = LAZY_MUTEX_INITIALIZER;
+
+}  // namespace
+
+// static
+SignatureMap::Key SignatureMap::KeyFor(const FunctionSig* sig) {
+  Key key;
+  key.reserve(1 + sig->return_count() + sig->parameter_count());
+  key.push_back(static_cast<int>(sig->return_count()));
+  for (size_t i = 0; i < sig->return_count(); ++i) {
+    key.push_back(static_cast<int>(sig->GetReturn(i)));
+  }
+  for (size_t i = 0; i < sig->parameter_count(); ++i) {
+    key.push_back(static_cast<int>(sig->GetParam(i)));
+  }
+  return key;
+}
+
+uint32_t SignatureMap::FindOrInsert(const FunctionSig* sig) {
+  Key key = KeyFor(sig);
+  auto it = ids_.find(key);
+  if (it != ids_.end()) return it->second;
+  uint32_t id = static_cast<uint32_t>(ids_.size());
+  ids_.insert(std::make_pair(key, id));
+  return id;
+}
+
+int32_t SignatureMap::Find(const FunctionSig* sig) const {
+  auto it = ids_.find(KeyFor(sig));
+  if (it == ids_.end()) return -1;
+  return static_cast<int32_t>(it->second);
+}
+
+// static
+int32_t SignatureMap::FindOrInsertCanonical(const FunctionSig* sig) {
+  base::LockGuard<base::Mutex> guard(canonical_signatures_mutex.Pointer());
+  SignatureMap* map = canonical_signatures.Pointer();
+  return static_cast<int32_t>(map->FindOrInsert(sig));
+}
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
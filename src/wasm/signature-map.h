@@ -0,0 +1,55 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_WASM_SIGNATURE_MAP_H_
+#define V8_WASM_SIGNATURE_MAP_H_
+
+#include <map>
+#include <vector>
+
+#include "src/wasm/wasm-opcodes.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+
+// Assigns the same id to structurally equal function signatures of a module.
+// Ids are numbered in the order the signatures are first inserted, so they
+// only depend on the module bytes. Function tables store these ids, so
+// call_indirect checks the signature of the callee with a single comparison,
+// and the code that embeds them stays valid when it is serialized and loaded
+// in another process.
+class SignatureMap {
+ public:
+  SignatureMap() {}
+
+  // Returns the id of {sig}, assigning the next free id to a new signature.
+  uint32_t FindOrInsert(const FunctionSig* sig);
+
+  // Returns the id of {sig}, or -1 if it was never inserted.
+  int32_t Find(const FunctionSig* sig) const;
+
+  // Returns an id of {sig} that is shared by all modules in the process.
+  // These ids depend on the order in which signatures are first seen, so
+  // they may only be compared at run time and must never be embedded in code.
+  // Thread-safe.
+  static int32_t FindOrInsertCanonical(const FunctionSig* sig);
+
+ private:
+  // A signature is keyed by its return count followed by its return and
+  // parameter types.
+  typedef std::vector<int> Key;
+
+  static Key KeyFor(const FunctionSig* sig);
+
+  std::map<Key, uint32_t> ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(SignatureMap);
+};
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_WASM_SIGNATURE_MAP_H_
@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "src/wasm/wasm-interpreter.h"
+
+#include <algorithm>
+
 #include "src/wasm/ast-decoder.h"
 #include "src/wasm/decoder.h"
 #include "src/wasm/wasm-external-refs.h"
@@ -24,6 +27,18 @@ namespace wasm {
 #define TRACE(...)
 #endif
 
+// GCC and clang dispatch the interpreter loop through a table of label
+// addresses; other compilers, i.e. MSVC, use the switch over the opcode.
+#if defined(__GNUC__)
+#define WASM_INTERPRETER_COMPUTED_GOTO 1
+#define OPCODE_CASE(name) \
+  case kExpr##name:       \
+  op_##name:
+#else
+#define WASM_INTERPRETER_COMPUTED_GOTO 0
+#define OPCODE_CASE(name) case kExpr##name:
+#endif
+
 #define FOREACH_INTERNAL_OPCODE(V) V(Breakpoint, 0xFF)
 
 #define FOREACH_SIMPLE_BINOP(V) \
@@ -839,13 +854,193 @@ class ControlTransfers : public ZoneObject {
       pc += OpcodeLength(pc, end);
     }
   }
+};
+
+// A control transfer whose target is resolved to the index of the
+// instruction it lands on.
+struct ResolvedTransfer {
+  uint32_t target;                      // index of the target instruction.
+  spdiff_t spdiff;                      // number of elements to pop.
+  ControlTransfer::StackAction action;  // action to perform.
+};
+
+// A bytecode with its immediates decoded and its control transfer resolved.
+struct DecodedInstruction {
+  pc_t pc;          // offset of the bytecode.
+  uint32_t length;  // length of the bytecode including its immediates.
+  byte opcode;      // original opcode, also if a breakpoint is set.
+  uint32_t arity;   // arity of br, br_if, br_table, return and call_indirect.
+  union {
+    int32_t i32;
+    int64_t i64;
+    float f32;
+    double f64;
+    uint32_t index;   // local, global, function or signature index.
+    uint32_t offset;  // offset of a memory access.
+    struct {
+      uint32_t start;  // first entry in {DecodedCode::branch_tables}.
+      uint32_t count;  // number of entries, not counting the default.
+    } table;
+  } imm;
+  ResolvedTransfer transfer;  // control transfer of if, else, br, br_if, end.
+};
+
+// The bytecodes of a function, decoded once before the function is first
+// executed. Executing them needs neither LEB128 decoding of immediates nor
+// lookups in the {ControlTransfers} map.
+class DecodedCode : public ZoneObject {
+ public:
+  static const uint32_t kNoTarget = 0xffffffff;
+
+  ZoneVector<DecodedInstruction> instructions;
+  ZoneVector<ResolvedTransfer> branch_tables;
+  pc_t limit;  // offset of the end of the code.
+
+  DecodedCode(Zone* zone, size_t locals_encoded_size, const byte* start,
+              const byte* end, ControlTransfers* targets)
+      : instructions(zone),
+        branch_tables(zone),
+        limit(static_cast<pc_t>(end - start)) {
+    Decoder decoder(start, end);  // for reading operands.
+    const byte* pc = start + locals_encoded_size;
+    while (pc < end) {
+      DecodedInstruction instr = {};
+      instr.pc = static_cast<pc_t>(pc - start);
+      instr.length = OpcodeLength(pc, end);
+      instr.opcode = *pc;
+      switch (instr.opcode) {
+        case kExprBr:
+        case kExprBrIf: {
+          BreakDepthOperand operand(&decoder, pc);
+          instr.arity = operand.arity;
+          break;
+        }
+        case kExprBrTable: {
+          BranchTableOperand operand(&decoder, pc);
+          instr.arity = operand.arity;
+          instr.imm.table.start = static_cast<uint32_t>(branch_tables.size());
+          instr.imm.table.count = operand.table_count;
+          // The entries are resolved once all instructions are known.
+          branch_tables.resize(branch_tables.size() + operand.table_count + 1);
+          break;
+        }
+        case kExprReturn: {
+          ReturnArityOperand operand(&decoder, pc);
+          instr.arity = operand.arity;
+          break;
+        }
+        case kExprI8Const: {
+          ImmI8Operand operand(&decoder, pc);
+          instr.imm.i32 = operand.value;
+          break;
+        }
+        case kExprI32Const: {
+          ImmI32Operand operand(&decoder, pc);
+          instr.imm.i32 = operand.value;
+          break;
+        }
+        case kExprI64Const: {
+          ImmI64Operand operand(&decoder, pc);
+          instr.imm.i64 = operand.value;
+          break;
+        }
+        case kExprF32Const: {
+          ImmF32Operand operand(&decoder, pc);
+          instr.imm.f32 = operand.value;
+          break;
+        }
+        case kExprF64Const: {
+          ImmF64Operand operand(&decoder, pc);
+          instr.imm.f64 = operand.value;
+          break;
+        }
+        case kExprGetLocal:
+        case kExprSetLocal: {
+          LocalIndexOperand operand(&decoder, pc);
+          instr.imm.index = operand.index;
+          break;
+        }
+        case kExprCallFunction: {
+          CallFunctionOperand operand(&decoder, pc);
+          instr.imm.index = operand.index;
+          break;
+        }
+        case kExprCallIndirect: {
+          CallIndirectOperand operand(&decoder, pc);
+          instr.arity = operand.arity;
+          instr.imm.index = operand.index;
+          break;
+        }
+        case kExprLoadGlobal:
+        case kExprStoreGlobal: {
+          GlobalIndexOperand operand(&decoder, pc);
+          instr.imm.index = operand.index;
+          break;
+        }
+#define DECODE_MEMORY_ACCESS(name, opcode, sig) \
+  case kExpr##name: {                           \
+    MemoryAccessOperand operand(&decoder, pc);  \
+    instr.imm.offset = operand.offset;          \
+    break;                                      \
+  }
+          FOREACH_LOAD_MEM_OPCODE(DECODE_MEMORY_ACCESS)
+          FOREACH_STORE_MEM_OPCODE(DECODE_MEMORY_ACCESS)
+#undef DECODE_MEMORY_ACCESS
+        default:
+          break;
+      }
+      instructions.push_back(instr);
+      pc += instr.length;
+    }
+
+    for (DecodedInstruction& instr : instructions) {
+      switch (instr.opcode) {
+        case kExprIf:
+        case kExprElse:
+        case kExprBr:
+        case kExprBrIf:
+        case kExprEnd:
+          instr.transfer = Resolve(targets, instr.pc);
+          break;
+        case kExprBrTable:
+          // The transfer of entry {i} is recorded at {pc + i}.
+          for (uint32_t i = 0; i <= instr.imm.table.count; ++i) {
+            branch_tables[instr.imm.table.start + i] =
+                Resolve(targets, instr.pc + i);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  // Returns the index of the instruction at {pc}, or the number of
+  // instructions if {pc} is the end of the code.
+  size_t IndexOf(pc_t pc) const {
+    auto it = std::lower_bound(
+        instructions.begin(), instructions.end(), pc,
+        [](const DecodedInstruction& instr, pc_t pc) { return instr.pc < pc; });
+    DCHECK(it == instructions.end() || it->pc == pc);
+    return static_cast<size_t>(it - instructions.begin());
+  }
+
+  // Returns the offset of the instruction at {index}.
+  pc_t PcOf(size_t index) const {
+    return index < instructions.size() ? instructions[index].pc : limit;
+  }
 
-  ControlTransfer Lookup(pc_t from) {
-    auto result = map_.find(from);
-    if (result == map_.end()) {
-      V8_Fatal(__FILE__, __LINE__, "no control target for pc %zu", from);
+ private:
+  ResolvedTransfer Resolve(ControlTransfers* targets, pc_t from) {
+    auto result = targets->map_.find(from);
+    if (result == targets->map_.end()) {
+      // Only fails if executed, like a lookup in the map would.
+      return {kNoTarget, 0, ControlTransfer::kNoAction};
     }
-    return result->second;
+    ControlTransfer transfer = result->second;
+    pc_t target = static_cast<pc_t>(from + transfer.pcdiff);
+    return {static_cast<uint32_t>(IndexOf(target)), transfer.spdiff,
+            transfer.action};
   }
 };
 
@@ -858,6 +1053,7 @@ struct InterpreterCode {
   byte* start;                   // start of (maybe altered) code
   byte* end;                     // end of (maybe altered) code
   ControlTransfers* targets;     // helper for control flow.
+  DecodedCode* decoded;          // pre-decoded bytecodes.
 
   const byte* at(pc_t pc) { return start + pc; }
 };
@@ -910,6 +1106,9 @@ class CodeMap {
       code->targets =
           new (zone_) ControlTransfers(zone_, code->locals.decls_encoded_size,
                                        code->orig_start, code->orig_end);
+      code->decoded = new (zone_)
+          DecodedCode(zone_, code->locals.decls_encoded_size, code->orig_start,
+                      code->orig_end, code->targets);
     }
     return code;
   }
@@ -919,7 +1118,7 @@ class CodeMap {
     InterpreterCode code = {
         function, AstLocalDecls(zone_),          code_start,
         code_end, const_cast<byte*>(code_start), const_cast<byte*>(code_end),
-        nullptr};
+        nullptr,  nullptr};
 
     DCHECK_EQ(interpreter_code_.size(), function->func_index);
     interpreter_code_.push_back(code);
@@ -931,6 +1130,7 @@ class CodeMap {
     InterpreterCode* code = FindCode(function);
     if (code == nullptr) return false;
     code->targets = nullptr;
+    code->decoded = nullptr;
     code->orig_start = start;
     code->orig_end = end;
     code->start = const_cast<byte*>(start);
@@ -950,7 +1150,11 @@ class ThreadImpl : public WasmInterpreter::Thread {
         frames_(zone),
         state_(WasmInterpreter::STOPPED),
         break_pc_(kInvalidPc),
-        trap_reason_(kTrapCount) {}
+        trap_reason_(kTrapCount) {
+#if WASM_INTERPRETER_COMPUTED_GOTO
+    std::fill_n(dispatch_table_, arraysize(dispatch_table_), nullptr);
+#endif
+  }
 
   virtual ~ThreadImpl() {}
 
@@ -963,6 +1167,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
   virtual void PushFrame(const WasmFunction* function, WasmVal* args) {
     InterpreterCode* code = codemap()->FindCode(function);
     CHECK_NOT_NULL(code);
+    codemap()->Preprocess(code);
     frames_.push_back({code, 0, 0, stack_.size()});
     for (size_t i = 0; i < function->sig->parameter_count(); ++i) {
       stack_.push_back(args[i]);
@@ -1051,6 +1256,9 @@ class ThreadImpl : public WasmInterpreter::Thread {
   WasmInterpreter::State state_;
   pc_t break_pc_;
   TrapReason trap_reason_;
+#if WASM_INTERPRETER_COMPUTED_GOTO
+  void* dispatch_table_[256];  // filled by the first Execute().
+#endif
 
   CodeMap* codemap() { return codemap_; }
   WasmModuleInstance* instance() { return instance_; }
@@ -1116,7 +1324,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
     return false;
   }
 
-  bool DoReturn(InterpreterCode** code, pc_t* pc, pc_t* limit, WasmVal val) {
+  bool DoReturn(InterpreterCode** code, pc_t* pc, WasmVal val) {
     DCHECK_GT(frames_.size(), 0u);
     stack_.resize(frames_.back().sp);
     frames_.pop_back();
@@ -1132,7 +1340,6 @@ class ThreadImpl : public WasmInterpreter::Thread {
       Frame* top = &frames_.back();
       *code = top->code;
       *pc = top->ret_pc;
-      *limit = top->code->end - top->code->start;
       if (top->code->start[top->call_pc] == kExprCallIndirect ||
           (top->code->orig_start &&
            top->code->orig_start[top->call_pc] == kExprCallIndirect)) {
@@ -1147,17 +1354,17 @@ class ThreadImpl : public WasmInterpreter::Thread {
     }
   }
 
-  void DoCall(InterpreterCode* target, pc_t* pc, pc_t ret_pc, pc_t* limit) {
+  void DoCall(InterpreterCode* target, pc_t* pc, pc_t ret_pc) {
     PushFrame(target, *pc, ret_pc);
     *pc = frames_.back().ret_pc;
-    *limit = target->end - target->start;
   }
 
-  // Adjust the program counter {pc} and the stack contents according to the
-  // code's precomputed control transfer map. Returns the different between
-  // the new pc and the old pc.
-  int DoControlTransfer(InterpreterCode* code, pc_t pc) {
-    auto target = code->targets->Lookup(pc);
+  // Adjust the stack contents according to the control transfer {target} of
+  // the instruction at {pc}. Returns the index of the next instruction.
+  size_t DoControlTransfer(const ResolvedTransfer& target, pc_t pc) {
+    if (target.target == DecodedCode::kNoTarget) {
+      V8_Fatal(__FILE__, __LINE__, "no control target for pc %zu", pc);
+    }
     switch (target.action) {
       case ControlTransfer::kNoAction:
         TRACE("  action [sp-%u]\n", target.spdiff);
@@ -1177,34 +1384,87 @@ class ThreadImpl : public WasmInterpreter::Thread {
         Push(pc, WasmVal());
         break;
     }
-    return target.pcdiff;
+    return target.target;
   }
 
   void Execute(InterpreterCode* code, pc_t pc, int max) {
-    Decoder decoder(code->start, code->end);
-    pc_t limit = code->end - code->start;
+    DecodedCode* decoded = code->decoded;
+    size_t ip = decoded->IndexOf(pc);
+#if WASM_INTERPRETER_COMPUTED_GOTO
+    if (dispatch_table_[kExprNop] == nullptr) {
+      std::fill_n(dispatch_table_, arraysize(dispatch_table_), &&op_default);
+#define SET_TARGET(name) dispatch_table_[kExpr##name] = &&op_##name;
+#define SET_LIST_TARGET(name, ...) SET_TARGET(name)
+      SET_TARGET(Nop)
+      SET_TARGET(Block)
+      SET_TARGET(Loop)
+      SET_TARGET(If)
+      SET_TARGET(Else)
+      SET_TARGET(Select)
+      SET_TARGET(Br)
+      SET_TARGET(BrIf)
+      SET_TARGET(BrTable)
+      SET_TARGET(Return)
+      SET_TARGET(Unreachable)
+      SET_TARGET(End)
+      SET_TARGET(I8Const)
+      SET_TARGET(I32Const)
+      SET_TARGET(I64Const)
+      SET_TARGET(F32Const)
+      SET_TARGET(F64Const)
+      SET_TARGET(GetLocal)
+      SET_TARGET(SetLocal)
+      SET_TARGET(CallFunction)
+      SET_TARGET(CallIndirect)
+      SET_TARGET(CallImport)
+      SET_TARGET(LoadGlobal)
+      SET_TARGET(StoreGlobal)
+      SET_TARGET(MemorySize)
+      FOREACH_LOAD_MEM_OPCODE(SET_LIST_TARGET)
+      FOREACH_STORE_MEM_OPCODE(SET_LIST_TARGET)
+      SET_TARGET(I32AsmjsLoadMem8S)
+      SET_TARGET(I32AsmjsLoadMem8U)
+      SET_TARGET(I32AsmjsLoadMem16S)
+      SET_TARGET(I32AsmjsLoadMem16U)
+      SET_TARGET(I32AsmjsLoadMem)
+      SET_TARGET(F32AsmjsLoadMem)
+      SET_TARGET(F64AsmjsLoadMem)
+      SET_TARGET(I32AsmjsStoreMem8)
+      SET_TARGET(I32AsmjsStoreMem16)
+      SET_TARGET(I32AsmjsStoreMem)
+      SET_TARGET(F32AsmjsStoreMem)
+      SET_TARGET(F64AsmjsStoreMem)
+      FOREACH_SIMPLE_BINOP(SET_LIST_TARGET)
+      FOREACH_OTHER_BINOP(SET_LIST_TARGET)
+      FOREACH_OTHER_UNOP(SET_LIST_TARGET)
+#undef SET_LIST_TARGET
+#undef SET_TARGET
+    }
+#endif
     while (true) {
       if (max-- <= 0) {
         // Maximum number of instructions reached.
         state_ = WasmInterpreter::PAUSED;
-        return CommitPc(pc);
+        return CommitPc(decoded->PcOf(ip));
       }
 
-      if (pc >= limit) {
+      if (ip >= decoded->instructions.size()) {
         // Fell off end of code; do an implicit return.
+        pc = decoded->limit;
         TRACE("@%-3zu: ImplicitReturn\n", pc);
         WasmVal val = PopArity(code->function->sig->return_count());
-        if (!DoReturn(&code, &pc, &limit, val)) return;
-        decoder.Reset(code->start, code->end);
+        if (!DoReturn(&code, &pc, val)) return;
+        decoded = code->decoded;
+        ip = decoded->IndexOf(pc);
         continue;
       }
 
+      const DecodedInstruction* instr = &decoded->instructions[ip];
+      pc = instr->pc;
       const char* skip = "        ";
-      int len = 1;
-      byte opcode = code->start[pc];
-      byte orig = opcode;
-      if (opcode == kInternalBreakpoint) {
-        orig = code->orig_start[pc];
+      size_t next = ip + 1;
+      byte orig = instr->opcode;
+      if (code->start[pc] == kInternalBreakpoint) {
         if (SkipBreakpoint(code, pc)) {
           // skip breakpoint by switching on original code.
           skip = "[skip]  ";
@@ -1225,168 +1485,151 @@ class ThreadImpl : public WasmInterpreter::Thread {
       TraceValueStack();
       TRACE("\n");
 
+#if WASM_INTERPRETER_COMPUTED_GOTO
+      goto* dispatch_table_[orig];
+#endif
       switch (orig) {
-        case kExprNop:
+        OPCODE_CASE(Nop)
           Push(pc, WasmVal());
           break;
-        case kExprBlock:
-        case kExprLoop: {
+        OPCODE_CASE(Block)
+        OPCODE_CASE(Loop) {
           // Do nothing.
           break;
         }
-        case kExprIf: {
+        OPCODE_CASE(If) {
           WasmVal cond = Pop();
           bool is_true = cond.to<uint32_t>() != 0;
           if (is_true) {
             // fall through to the true block.
             TRACE("  true => fallthrough\n");
           } else {
-            len = DoControlTransfer(code, pc);
-            TRACE("  false => @%zu\n", pc + len);
+            next = DoControlTransfer(instr->transfer, pc);
+            TRACE("  false => @%zu\n", decoded->PcOf(next));
           }
           break;
         }
-        case kExprElse: {
-          len = DoControlTransfer(code, pc);
-          TRACE("  end => @%zu\n", pc + len);
+        OPCODE_CASE(Else) {
+          next = DoControlTransfer(instr->transfer, pc);
+          TRACE("  end => @%zu\n", decoded->PcOf(next));
           break;
         }
-        case kExprSelect: {
+        OPCODE_CASE(Select) {
           WasmVal cond = Pop();
           WasmVal fval = Pop();
           WasmVal tval = Pop();
           Push(pc, cond.to<int32_t>() != 0 ? tval : fval);
           break;
         }
-        case kExprBr: {
-          BreakDepthOperand operand(&decoder, code->at(pc));
-          WasmVal val = PopArity(operand.arity);
-          len = DoControlTransfer(code, pc);
-          TRACE("  br => @%zu\n", pc + len);
-          if (operand.arity > 0) Push(pc, val);
+        OPCODE_CASE(Br) {
+          WasmVal val = PopArity(instr->arity);
+          next = DoControlTransfer(instr->transfer, pc);
+          TRACE("  br => @%zu\n", decoded->PcOf(next));
+          if (instr->arity > 0) Push(pc, val);
           break;
         }
-        case kExprBrIf: {
-          BreakDepthOperand operand(&decoder, code->at(pc));
+        OPCODE_CASE(BrIf) {
           WasmVal cond = Pop();
-          WasmVal val = PopArity(operand.arity);
+          WasmVal val = PopArity(instr->arity);
           bool is_true = cond.to<uint32_t>() != 0;
           if (is_true) {
-            len = DoControlTransfer(code, pc);
-            TRACE("  br_if => @%zu\n", pc + len);
-            if (operand.arity > 0) Push(pc, val);
+            next = DoControlTransfer(instr->transfer, pc);
+            TRACE("  br_if => @%zu\n", decoded->PcOf(next));
+            if (instr->arity > 0) Push(pc, val);
           } else {
             TRACE("  false => fallthrough\n");
-            len = 1 + operand.length;
             Push(pc, WasmVal());
           }
           break;
         }
-        case kExprBrTable: {
-          BranchTableOperand operand(&decoder, code->at(pc));
+        OPCODE_CASE(BrTable) {
           uint32_t key = Pop().to<uint32_t>();
-          WasmVal val = PopArity(operand.arity);
-          if (key >= operand.table_count) key = operand.table_count;
-          len = DoControlTransfer(code, pc + key) + key;
-          TRACE("  br[%u] => @%zu\n", key, pc + len);
-          if (operand.arity > 0) Push(pc, val);
+          WasmVal val = PopArity(instr->arity);
+          if (key >= instr->imm.table.count) key = instr->imm.table.count;
+          next = DoControlTransfer(
+              decoded->branch_tables[instr->imm.table.start + key], pc);
+          TRACE("  br[%u] => @%zu\n", key, decoded->PcOf(next));
+          if (instr->arity > 0) Push(pc, val);
           break;
         }
-        case kExprReturn: {
-          ReturnArityOperand operand(&decoder, code->at(pc));
-          WasmVal val = PopArity(operand.arity);
-          if (!DoReturn(&code, &pc, &limit, val)) return;
-          decoder.Reset(code->start, code->end);
+        OPCODE_CASE(Return) {
+          WasmVal val = PopArity(instr->arity);
+          if (!DoReturn(&code, &pc, val)) return;
+          decoded = code->decoded;
+          ip = decoded->IndexOf(pc);
           continue;
         }
-        case kExprUnreachable: {
+        OPCODE_CASE(Unreachable) {
           DoTrap(kTrapUnreachable, pc);
           return CommitPc(pc);
         }
-        case kExprEnd: {
-          len = DoControlTransfer(code, pc);
-          DCHECK_EQ(1, len);
+        OPCODE_CASE(End) {
+          next = DoControlTransfer(instr->transfer, pc);
+          DCHECK_EQ(ip + 1, next);
           break;
         }
-        case kExprI8Const: {
-          ImmI8Operand operand(&decoder, code->at(pc));
-          Push(pc, WasmVal(operand.value));
-          len = 1 + operand.length;
-          break;
-        }
-        case kExprI32Const: {
-          ImmI32Operand operand(&decoder, code->at(pc));
-          Push(pc, WasmVal(operand.value));
-          len = 1 + operand.length;
+        OPCODE_CASE(I8Const)
+        OPCODE_CASE(I32Const) {
+          Push(pc, WasmVal(instr->imm.i32));
           break;
         }
-        case kExprI64Const: {
-          ImmI64Operand operand(&decoder, code->at(pc));
-          Push(pc, WasmVal(operand.value));
-          len = 1 + operand.length;
+        OPCODE_CASE(I64Const) {
+          Push(pc, WasmVal(instr->imm.i64));
           break;
         }
-        case kExprF32Const: {
-          ImmF32Operand operand(&decoder, code->at(pc));
-          Push(pc, WasmVal(operand.value));
-          len = 1 + operand.length;
+        OPCODE_CASE(F32Const) {
+          Push(pc, WasmVal(instr->imm.f32));
           break;
         }
-        case kExprF64Const: {
-          ImmF64Operand operand(&decoder, code->at(pc));
-          Push(pc, WasmVal(operand.value));
-          len = 1 + operand.length;
+        OPCODE_CASE(F64Const) {
+          Push(pc, WasmVal(instr->imm.f64));
           break;
         }
-        case kExprGetLocal: {
-          LocalIndexOperand operand(&decoder, code->at(pc));
-          Push(pc, stack_[frames_.back().sp + operand.index]);
-          len = 1 + operand.length;
+        OPCODE_CASE(GetLocal) {
+          Push(pc, stack_[frames_.back().sp + instr->imm.index]);
           break;
         }
-        case kExprSetLocal: {
-          LocalIndexOperand operand(&decoder, code->at(pc));
+        OPCODE_CASE(SetLocal) {
           WasmVal val = Pop();
-          stack_[frames_.back().sp + operand.index] = val;
+          stack_[frames_.back().sp + instr->imm.index] = val;
           Push(pc, val);
-          len = 1 + operand.length;
           break;
         }
-        case kExprCallFunction: {
-          CallFunctionOperand operand(&decoder, code->at(pc));
-          InterpreterCode* target = codemap()->GetCode(operand.index);
-          DoCall(target, &pc, pc + 1 + operand.length, &limit);
+        OPCODE_CASE(CallFunction) {
+          InterpreterCode* target = codemap()->GetCode(instr->imm.index);
+          DoCall(target, &pc, pc + instr->length);
           code = target;
-          decoder.Reset(code->start, code->end);
+          decoded = code->decoded;
+          ip = decoded->IndexOf(pc);
           continue;
         }
-        case kExprCallIndirect: {
-          CallIndirectOperand operand(&decoder, code->at(pc));
-          size_t index = stack_.size() - operand.arity - 1;
-          DCHECK_LT(index, stack_.size());
-          uint32_t table_index = stack_[index].to<uint32_t>();
+        OPCODE_CASE(CallIndirect) {
+          size_t function_index_slot = stack_.size() - instr->arity - 1;
+          DCHECK_LT(function_index_slot, stack_.size());
+          uint32_t table_index = stack_[function_index_slot].to<uint32_t>();
           if (table_index >= module()->function_table.size()) {
             return DoTrap(kTrapFuncInvalid, pc);
           }
           uint16_t function_index = module()->function_table[table_index];
           InterpreterCode* target = codemap()->GetCode(function_index);
           DCHECK(target);
-          if (target->function->sig_index != operand.index) {
+          if (!target->function->sig->Equals(
+                  module()->signatures[instr->imm.index])) {
             return DoTrap(kTrapFuncSigMismatch, pc);
           }
 
-          DoCall(target, &pc, pc + 1 + operand.length, &limit);
+          DoCall(target, &pc, pc + instr->length);
           code = target;
-          decoder.Reset(code->start, code->end);
+          decoded = code->decoded;
+          ip = decoded->IndexOf(pc);
           continue;
         }
-        case kExprCallImport: {
+        OPCODE_CASE(CallImport) {
           UNIMPLEMENTED();
           break;
         }
-        case kExprLoadGlobal: {
-          GlobalIndexOperand operand(&decoder, code->at(pc));
-          const WasmGlobal* global = &module()->globals[operand.index];
+        OPCODE_CASE(LoadGlobal) {
+          const WasmGlobal* global = &module()->globals[instr->imm.index];
           byte* ptr = instance()->globals_start + global->offset;
           MachineType type = global->type;
           WasmVal val;
@@ -1418,12 +1661,10 @@ class ThreadImpl : public WasmInterpreter::Thread {
             UNREACHABLE();
           }
           Push(pc, val);
-          len = 1 + operand.length;
           break;
         }
-        case kExprStoreGlobal: {
-          GlobalIndexOperand operand(&decoder, code->at(pc));
-          const WasmGlobal* global = &module()->globals[operand.index];
+        OPCODE_CASE(StoreGlobal) {
+          const WasmGlobal* global = &module()->globals[instr->imm.index];
           byte* ptr = instance()->globals_start + global->offset;
           MachineType type = global->type;
           WasmVal val = Pop();
@@ -1455,23 +1696,21 @@ class ThreadImpl : public WasmInterpreter::Thread {
             UNREACHABLE();
           }
           Push(pc, val);
-          len = 1 + operand.length;
           break;
         }
 
 #define LOAD_CASE(name, ctype, mtype)                                    \
-  case kExpr##name: {                                                    \
-    MemoryAccessOperand operand(&decoder, code->at(pc));                 \
+  OPCODE_CASE(name) {                                                    \
+    uint32_t offset = instr->imm.offset;                                 \
     uint32_t index = Pop().to<uint32_t>();                               \
     size_t effective_mem_size = instance()->mem_size - sizeof(mtype);    \
-    if (operand.offset > effective_mem_size ||                           \
-        index > (effective_mem_size - operand.offset)) {                 \
+    if (offset > effective_mem_size ||                                   \
+        index > (effective_mem_size - offset)) {                         \
       return DoTrap(kTrapMemOutOfBounds, pc);                            \
     }                                                                    \
-    byte* addr = instance()->mem_start + operand.offset + index;         \
+    byte* addr = instance()->mem_start + offset + index;                 \
     WasmVal result(static_cast<ctype>(ReadUnalignedValue<mtype>(addr))); \
     Push(pc, result);                                                    \
-    len = 1 + operand.length;                                            \
     break;                                                               \
   }
 
@@ -1492,19 +1731,18 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef LOAD_CASE
 
 #define STORE_CASE(name, ctype, mtype)                                     \
-  case kExpr##name: {                                                      \
-    MemoryAccessOperand operand(&decoder, code->at(pc));                   \
+  OPCODE_CASE(name) {                                                      \
+    uint32_t offset = instr->imm.offset;                                   \
     WasmVal val = Pop();                                                   \
     uint32_t index = Pop().to<uint32_t>();                                 \
     size_t effective_mem_size = instance()->mem_size - sizeof(mtype);      \
-    if (operand.offset > effective_mem_size ||                             \
-        index > (effective_mem_size - operand.offset)) {                   \
+    if (offset > effective_mem_size ||                                     \
+        index > (effective_mem_size - offset)) {                           \
       return DoTrap(kTrapMemOutOfBounds, pc);                              \
     }                                                                      \
-    byte* addr = instance()->mem_start + operand.offset + index;           \
+    byte* addr = instance()->mem_start + offset + index;                   \
     WriteUnalignedValue<mtype>(addr, static_cast<mtype>(val.to<ctype>())); \
     Push(pc, val);                                                         \
-    len = 1 + operand.length;                                              \
     break;                                                                 \
   }
 
@@ -1520,7 +1758,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef STORE_CASE
 
 #define ASMJS_LOAD_CASE(name, ctype, mtype, defval)                 \
-  case kExpr##name: {                                               \
+  OPCODE_CASE(name) {                                               \
     uint32_t index = Pop().to<uint32_t>();                          \
     ctype result;                                                   \
     if (index >= (instance()->mem_size - sizeof(mtype))) {          \
@@ -1545,7 +1783,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef ASMJS_LOAD_CASE
 
 #define ASMJS_STORE_CASE(name, ctype, mtype)                                   \
-  case kExpr##name: {                                                          \
+  OPCODE_CASE(name) {                                                          \
     WasmVal val = Pop();                                                       \
     uint32_t index = Pop().to<uint32_t>();                                     \
     if (index < (instance()->mem_size - sizeof(mtype))) {                      \
@@ -1564,12 +1802,12 @@ class ThreadImpl : public WasmInterpreter::Thread {
           ASMJS_STORE_CASE(F64AsmjsStoreMem, double, double);
 #undef ASMJS_STORE_CASE
 
-        case kExprMemorySize: {
+        OPCODE_CASE(MemorySize) {
           Push(pc, WasmVal(static_cast<uint32_t>(instance()->mem_size)));
           break;
         }
 #define EXECUTE_SIMPLE_BINOP(name, ctype, op)             \
-  case kExpr##name: {                                     \
+  OPCODE_CASE(name) {                                     \
     WasmVal rval = Pop();                                 \
     WasmVal lval = Pop();                                 \
     WasmVal result(lval.to<ctype>() op rval.to<ctype>()); \
@@ -1580,7 +1818,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef EXECUTE_SIMPLE_BINOP
 
 #define EXECUTE_OTHER_BINOP(name, ctype)              \
-  case kExpr##name: {                                 \
+  OPCODE_CASE(name) {                                 \
     TrapReason trap = kTrapCount;                     \
     volatile ctype rval = Pop().to<ctype>();          \
     volatile ctype lval = Pop().to<ctype>();          \
@@ -1593,7 +1831,7 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef EXECUTE_OTHER_BINOP
 
 #define EXECUTE_OTHER_UNOP(name, ctype)              \
-  case kExpr##name: {                                \
+  OPCODE_CASE(name) {                                \
     TrapReason trap = kTrapCount;                    \
     volatile ctype val = Pop().to<ctype>();          \
     WasmVal result(Execute##name(val, &trap));       \
@@ -1605,12 +1843,15 @@ class ThreadImpl : public WasmInterpreter::Thread {
 #undef EXECUTE_OTHER_UNOP
 
         default:
+#if WASM_INTERPRETER_COMPUTED_GOTO
+        op_default:
+#endif
           V8_Fatal(__FILE__, __LINE__, "Unknown or unimplemented opcode #%d:%s",
-                   code->start[pc], OpcodeName(code->start[pc]));
+                   orig, OpcodeName(orig));
           UNREACHABLE();
       }
 
-      pc += len;
+      ip = next;
     }
     UNREACHABLE();  // above decoding loop should run forever.
   }
@@ -7,6 +7,7 @@
 #include "src/assert-scope.h"
 #include "src/ast/ast.h"
 #include "src/ast/scopes.h"
+#include "src/base/platform/elapsed-timer.h"
 #include "src/execution.h"
 #include "src/factory.h"
 #include "src/handles.h"
@@ -132,6 +133,8 @@ v8::internal::wasm::ZoneBuffer* TranslateAsmModule(
   info->set_allow_lazy_parsing(false);
   info->set_toplevel(true);
 
+  base::ElapsedTimer parse_timer;
+  if (i::FLAG_trace_asm_time) parse_timer.Start();
   if (!i::Compiler::ParseAndAnalyze(info)) {
     return nullptr;
   }
@@ -149,15 +152,46 @@ v8::internal::wasm::ZoneBuffer* TranslateAsmModule(
   if (i::FLAG_enable_simd_asmjs) {
     typer.set_allow_simd(true);
   }
-  if (!typer.Validate()) {
+  base::TimeDelta parse_time;
+  base::ElapsedTimer validate_timer;
+  if (i::FLAG_trace_asm_time) {
+    parse_time = parse_timer.Elapsed();
+    validate_timer.Start();
+  }
+  // The function bodies are validated while they are translated.
+  if (!typer.ValidateModule()) {
     thrower->Error("Asm.js validation failed: %s", typer.error_message());
     return nullptr;
   }
 
+  base::TimeDelta validate_time;
+  base::ElapsedTimer translate_timer;
+  if (i::FLAG_trace_asm_time) {
+    validate_time = validate_timer.Elapsed();
+    translate_timer.Start();
+  }
   v8::internal::wasm::AsmWasmBuilder builder(info->isolate(), info->zone(),
                                              info->literal(), &typer);
+  v8::internal::wasm::ZoneBuffer* module = builder.Run(foreign_args);
+  if (module == nullptr) {
+    thrower->Error("Asm.js validation failed: %s", typer.error_message());
+    return nullptr;
+  }
 
-  return builder.Run(foreign_args);
+  if (i::FLAG_trace_asm_time) {
+    double translate_ms = translate_timer.Elapsed().InMillisecondsF();
+    int source_length = info->script()->source()->IsString()
+                            ? i::String::cast(info->script()->source())->length()
+                            : 0;
+    i::PrintF(
+        "[asm.js translation: parse %0.3f ms, validate module %0.3f ms, "
+        "validate and translate functions %0.3f ms, %d source chars, "
+        "%zu wasm bytes, %0.1f KB/ms]\n",
+        parse_time.InMillisecondsF(), validate_time.InMillisecondsF(),
+        translate_ms, source_length, module->size(),
+        translate_ms > 0 ? source_length / 1024.0 / translate_ms : 0.0);
+  }
+  return module;
 }
 
 i::MaybeHandle<i::JSObject> InstantiateModuleCommon(
@@ -480,9 +514,9 @@ void WasmJs::InstallWasmFunctionMap(Isolate* isolate, Handle<Context> context) {
         prev_map->GetInObjectProperties() - prev_map->unused_property_fields();
     int instance_size;
     int in_object_properties;
-    JSFunction::CalculateInstanceSizeHelper(instance_type, internal_fields + 1,
-                                            0, &instance_size,
-                                            &in_object_properties);
+    JSFunction::CalculateInstanceSizeHelper(
+        instance_type, internal_fields + wasm::kWasmExportInternalFieldCount, 0,
+        &instance_size, &in_object_properties);
 
     int unused_property_fields = in_object_properties - pre_allocated;
     Handle<Map> map = Map::CopyInitialMap(
@@ -3,19 +3,23 @@
 // found in the LICENSE file.
 
 #include "src/base/atomic-utils.h"
+#include "src/frames-inl.h"
 #include "src/macro-assembler.h"
 #include "src/objects.h"
 #include "src/property-descriptor.h"
 #include "src/v8.h"
 
 #include "src/simulator.h"
+#include "src/snapshot/code-serializer.h"
 
 #include "src/wasm/ast-decoder.h"
 #include "src/wasm/module-decoder.h"
+#include "src/wasm/signature-map.h"
 #include "src/wasm/wasm-debug.h"
 #include "src/wasm/wasm-function-name-table.h"
 #include "src/wasm/wasm-module.h"
 #include "src/wasm/wasm-result.h"
+#include "src/wasm/wasm-trap-handler.h"
 
 #include "src/compiler/wasm-compiler.h"
 
@@ -122,7 +126,13 @@ const int kWasmGlobalsArrayBuffer = 3;
 const int kWasmFunctionNamesArray = 4;
 const int kWasmModuleBytesString = 5;
 const int kWasmDebugInfo = 6;
-const int kWasmModuleInternalFieldCount = 7;
+const int kWasmLazyCompilationData = 7;
+const int kWasmModuleInternalFieldCount = 8;
+
+// Internal constants for the layout of the lazy compilation data.
+const int kLazyCompilationState = 0;
+const int kLazyCompilationImportCode = 1;
+const int kLazyCompilationDataSize = 2;
 
 uint32_t GetMinModuleMemSize(const WasmModule* module) {
   return WasmModule::kPageSize * module->min_mem_pages;
@@ -150,24 +160,63 @@ Handle<FixedArray> BuildFunctionTable(Isolate* isolate,
     return Handle<FixedArray>::null();
   }
 
-  Handle<FixedArray> fixed = isolate->factory()->NewFixedArray(2 * table_size);
+  Handle<FixedArray> fixed = isolate->factory()->NewFixedArray(
+      WasmModule::kFunctionTableEntrySize * table_size);
   for (uint32_t i = 0;
        i < static_cast<uint32_t>(module->function_table.size());
        ++i) {
     const WasmFunction* function =
         &module->functions[module->function_table[i]];
-    fixed->set(i, Smi::FromInt(function->sig_index));
+    int32_t sig_id = module->signature_map.Find(function->sig);
+    fixed->set(i * WasmModule::kFunctionTableEntrySize +
+                   WasmModule::kFunctionTableSignatureOffset,
+               Smi::FromInt(sig_id));
   }
   return fixed;
 }
 
+void FreeGuardedArrayBuffer(const v8::WeakCallbackInfo<void>& data) {
+  Object** location = reinterpret_cast<Object**>(data.GetParameter());
+  JSArrayBuffer* buffer = JSArrayBuffer::cast(*location);
+  size_t size = static_cast<size_t>(buffer->byte_length()->Number());
+  GuardRegions::Free(buffer->backing_store());
+  data.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64_t>(size));
+  GlobalHandles::Destroy(location);
+}
+
+// Allocates the backing store of a wasm memory inside a guard region. The
+// buffer is external, so the region is released by a weak callback once the
+// buffer dies.
+Handle<JSArrayBuffer> NewGuardedArrayBuffer(Isolate* isolate, size_t size,
+                                            byte** backing_store) {
+  void* memory = GuardRegions::Allocate(size);
+  if (memory == nullptr) return Handle<JSArrayBuffer>::null();
+  *backing_store = reinterpret_cast<byte*>(memory);
+
+  Handle<JSArrayBuffer> buffer = isolate->factory()->NewJSArrayBuffer();
+  JSArrayBuffer::Setup(buffer, isolate, true, memory, static_cast<int>(size));
+  buffer->set_is_neuterable(false);
+  Handle<Object> global = isolate->global_handles()->Create(*buffer);
+  GlobalHandles::MakeWeak(global.location(), global.location(),
+                          &FreeGuardedArrayBuffer,
+                          v8::WeakCallbackType::kParameter);
+  reinterpret_cast<v8::Isolate*>(isolate)
+      ->AdjustAmountOfExternalAllocatedMemory(static_cast<int64_t>(size));
+  return buffer;
+}
+
 Handle<JSArrayBuffer> NewArrayBuffer(Isolate* isolate, size_t size,
-                                     byte** backing_store) {
+                                     byte** backing_store,
+                                     bool use_guard_regions = false) {
   *backing_store = nullptr;
   if (size > (WasmModule::kMaxMemPages * WasmModule::kPageSize)) {
     // TODO(titzer): lift restriction on maximum memory allocated here.
     return Handle<JSArrayBuffer>::null();
   }
+  if (use_guard_regions) {
+    return NewGuardedArrayBuffer(isolate, size, backing_store);
+  }
   void* memory = isolate->array_buffer_allocator()->Allocate(size);
   if (memory == nullptr) {
     return Handle<JSArrayBuffer>::null();
@@ -224,7 +273,8 @@ bool AllocateMemory(ErrorThrower* thrower, Isolate* isolate,
   }
   instance->mem_size = GetMinModuleMemSize(instance->module);
   instance->mem_buffer =
-      NewArrayBuffer(isolate, instance->mem_size, &instance->mem_start);
+      NewArrayBuffer(isolate, instance->mem_size, &instance->mem_start,
+                     instance->mem_has_guard_regions);
   if (instance->mem_start == nullptr) {
     thrower->Error("Out of memory: wasm memory");
     instance->mem_size = 0;
@@ -493,6 +543,25 @@ struct CodeStats {
   }
 };
 
+// Returns the wasm code behind {function} if it is an exported wasm function
+// with the signature {sig}, so that the import can call it without going
+// through JavaScript.
+MaybeHandle<Code> LookupDirectImport(Handle<JSFunction> function,
+                                     FunctionSig* sig) {
+  if (function->code()->kind() != Code::JS_TO_WASM_FUNCTION) {
+    return MaybeHandle<Code>();
+  }
+  if (function->GetInternalFieldCount() != kWasmExportInternalFieldCount) {
+    return MaybeHandle<Code>();
+  }
+  Object* sig_id = function->GetInternalField(kWasmExportSignatureId);
+  if (!sig_id->IsSmi() ||
+      Smi::cast(sig_id)->value() != SignatureMap::FindOrInsertCanonical(sig)) {
+    return MaybeHandle<Code>();
+  }
+  return handle(function->shared()->code());
+}
+
 bool CompileWrappersToImportedFunctions(
     Isolate* isolate, const WasmModule* module, const Handle<JSReceiver> ffi,
     WasmModuleInstance* instance, ErrorThrower* thrower, Factory* factory) {
@@ -508,9 +577,13 @@ bool CompileWrappersToImportedFunctions(
           *thrower, factory, ffi, index, module_name, function_name);
       if (function.is_null()) return false;
 
-      Handle<Code> code = compiler::CompileWasmToJSWrapper(
-          isolate, function.ToHandleChecked(), import.sig, module_name,
-          function_name);
+      Handle<Code> code;
+      if (!LookupDirectImport(function.ToHandleChecked(), import.sig)
+               .ToHandle(&code)) {
+        code = compiler::CompileWasmToJSWrapper(
+            isolate, function.ToHandleChecked(), import.sig, module_name,
+            function_name);
+      }
       instance->import_code[index] = code;
     }
   }
@@ -673,60 +746,353 @@ void CompileSequentially(Isolate* isolate, const WasmModule* module,
 void PopulateFunctionTable(WasmModuleInstance* instance) {
   if (!instance->function_table.is_null()) {
     uint32_t table_size = instance->module->FunctionTableSize();
-    DCHECK_EQ(table_size * 2, instance->function_table->length());
+    DCHECK_EQ(table_size * WasmModule::kFunctionTableEntrySize,
+              instance->function_table->length());
     uint32_t populated_table_size =
         static_cast<uint32_t>(instance->module->function_table.size());
     for (uint32_t i = 0; i < populated_table_size; ++i) {
-    instance->function_table->set(
-        i + table_size,
-        *instance->function_code[instance->module->function_table[i]]);
+      instance->function_table->set(
+          i * WasmModule::kFunctionTableEntrySize +
+              WasmModule::kFunctionTableCodeOffset,
+          *instance->function_code[instance->module->function_table[i]]);
+    }
+  }
+}
+
+// Out-of-bounds accesses to memory allocated with guard regions fault
+// instead of being checked explicitly. An imported buffer has no guard
+// regions, and asm.js code relies on out-of-bounds accesses being ignored.
+bool MemoryHasGuardRegions(ModuleOrigin origin, Handle<JSArrayBuffer> memory) {
+  return GuardRegions::IsEnabled() && origin == kWasmOrigin &&
+         memory.is_null();
+}
+
+// Sets up {instance} and {module_env} for compiling the functions of {module}
+// ahead of instantiation. Memory, globals and imports are not known yet and
+// are patched in when the module is instantiated.
+void PrepareCompilation(Isolate* isolate, const WasmModule* module,
+                        bool use_guard_regions,
+                        WasmModuleInstance* instance, ModuleEnv* module_env) {
+  Factory* factory = isolate->factory();
+  instance->mem_has_guard_regions = use_guard_regions;
+  instance->function_table = BuildFunctionTable(isolate, module);
+  instance->context = isolate->native_context();
+  instance->mem_size = GetMinModuleMemSize(module);
+  instance->mem_start = nullptr;
+  instance->globals_start = nullptr;
+
+  module_env->module = module;
+  module_env->instance = instance;
+  module_env->origin = module->origin;
+  InitializePlaceholders(factory, &module_env->placeholders,
+                         module->functions.size());
+
+  instance->import_code.resize(module->import_table.size());
+  for (uint32_t i = 0; i < module->import_table.size(); ++i) {
+    instance->import_code[i] =
+        CreatePlaceholder(factory, i, Code::WASM_TO_JS_FUNCTION);
+  }
+}
+
+// Links the compiled functions of {instance} to each other and returns them
+// as the code table of the module.
+Handle<FixedArray> LinkCodeTable(Isolate* isolate,
+                                 WasmModuleInstance* instance) {
+  Handle<FixedArray> ret = isolate->factory()->NewFixedArray(
+      static_cast<int>(instance->function_code.size()), TENURED);
+
+  LinkModuleFunctions(isolate, instance->function_code);
+
+  // At this point, compilation has completed. Update the code table
+  // and record sizes.
+  for (size_t i = FLAG_skip_compiling_wasm_funcs;
+       i < instance->function_code.size(); ++i) {
+    Code* code = *instance->function_code[i];
+    ret->set(static_cast<int>(i), code);
+  }
+
+  PopulateFunctionTable(instance);
+
+  return ret;
+}
+
+// Records the instance and the function index of a wasm function in its
+// deoptimization data, where the stack frame of the function finds them.
+void SetFunctionDeoptimizationData(Factory* factory, Handle<JSObject> js_object,
+                                   Handle<Code> code, uint32_t index) {
+  DCHECK(code->deoptimization_data() == nullptr ||
+         code->deoptimization_data()->length() == 0);
+  Handle<FixedArray> deopt_data = factory->NewFixedArray(2, TENURED);
+  if (!js_object.is_null()) {
+    deopt_data->set(0, *js_object);
+  }
+  deopt_data->set(1, Smi::FromInt(static_cast<int>(index)));
+  deopt_data->set_length(2);
+  code->set_deoptimization_data(*deopt_data);
+}
+
+// Validates the function bodies of the module of {instance} and returns a code
+// table in which every function is a stub that compiles the function on its
+// first call. Stubs are compiled once per signature and copied for each
+// function, since the stub finds the function index in its deoptimization
+// data.
+Handle<FixedArray> CreateLazyCompileStubs(Isolate* isolate,
+                                          WasmModuleInstance* instance,
+                                          ErrorThrower* thrower) {
+  const WasmModule* module = instance->module;
+  ModuleEnv module_env;
+  module_env.module = module;
+  module_env.instance = instance;
+  module_env.origin = module->origin;
+  uint32_t failed_index = 0;
+  TreeResult result = VerifyFunctionBodies(isolate, &module_env, &failed_index);
+  if (result.failed()) {
+    const WasmFunction& func = module->functions[failed_index];
+    WasmName str = module->GetName(func.name_offset, func.name_length);
+    ScopedVector<char> buffer(128);
+    SNPrintF(buffer, "Validating WASM function #%d:%.*s failed:",
+             func.func_index, str.length(), str.start());
+    thrower->Failed(buffer.start(), result);
+    return Handle<FixedArray>::null();
+  }
+
+  Factory* factory = isolate->factory();
+  std::vector<Handle<Code>> stubs(module->signatures.size());
+  Handle<FixedArray> code_table = factory->NewFixedArray(
+      static_cast<int>(module->functions.size()), TENURED);
+  for (const WasmFunction& func : module->functions) {
+    Handle<Code>& stub = stubs[func.sig_index];
+    if (stub.is_null()) {
+      stub = compiler::CompileWasmLazyCompileStub(isolate, instance->context,
+                                                  func.sig);
+    }
+    code_table->set(static_cast<int>(func.func_index),
+                    *factory->CopyCode(stub));
+  }
+  return code_table;
+}
+
+// The state of lazy compilation that does not live on the heap. The module
+// passed to Instantiate does not outlive the instantiation, so the module is
+// decoded again from a copy of its bytes. Deleted when the instance dies.
+class LazyCompilationState {
+ public:
+  LazyCompilationState(Isolate* isolate, const WasmModuleInstance* instance)
+      : zone_(isolate->allocator()),
+        module_bytes_(instance->module->module_start,
+                      instance->module->module_end),
+        mem_has_guard_regions_(instance->mem_has_guard_regions),
+        location_(nullptr) {
+    ModuleResult result = DecodeWasmModule(
+        isolate, &zone_, module_bytes_.data(),
+        module_bytes_.data() + module_bytes_.size(), false,
+        instance->module->origin);
+    CHECK(result.ok());
+    module_.reset(result.val);
+  }
+
+  const WasmModule* module() const { return module_.get(); }
+  bool mem_has_guard_regions() const { return mem_has_guard_regions_; }
+
+  Object** location() const { return location_; }
+  void set_location(Object** location) { location_ = location; }
+
+ private:
+  Zone zone_;
+  std::vector<byte> module_bytes_;
+  std::unique_ptr<const WasmModule> module_;
+  bool mem_has_guard_regions_;
+  Object** location_;  // Weak global handle to the instance.
+};
+
+void DeleteLazyCompilationState(const v8::WeakCallbackInfo<void>& data) {
+  LazyCompilationState* state =
+      reinterpret_cast<LazyCompilationState*>(data.GetParameter());
+  GlobalHandles::Destroy(state->location());
+  delete state;
+}
+
+// Attaches what CompileLazy needs to compile the functions of {instance}
+// later to its JS object.
+void InitializeLazyCompilation(Isolate* isolate,
+                               WasmModuleInstance* instance) {
+  Factory* factory = isolate->factory();
+  LazyCompilationState* state = new LazyCompilationState(isolate, instance);
+  Handle<Object> global =
+      isolate->global_handles()->Create(*instance->js_object);
+  state->set_location(global.location());
+  GlobalHandles::MakeWeak(global.location(), state, &DeleteLazyCompilationState,
+                          v8::WeakCallbackType::kParameter);
+
+  Handle<FixedArray> import_code = factory->NewFixedArray(
+      static_cast<int>(instance->import_code.size()), TENURED);
+  for (size_t i = 0; i < instance->import_code.size(); ++i) {
+    import_code->set(static_cast<int>(i), *instance->import_code[i]);
+  }
+  Handle<FixedArray> data =
+      factory->NewFixedArray(kLazyCompilationDataSize, TENURED);
+  data->set(kLazyCompilationState,
+            *factory->NewForeign(reinterpret_cast<Address>(state), TENURED));
+  data->set(kLazyCompilationImportCode, *import_code);
+  instance->js_object->SetInternalField(kWasmLazyCompilationData, *data);
+}
+
+// Compiles the function {index} of the instance {js_object} and installs it
+// in the code table and the function table of the instance.
+MaybeHandle<Code> CompileLazyFunction(Isolate* isolate,
+                                      Handle<JSObject> js_object,
+                                      uint32_t index) {
+  Handle<FixedArray> data(
+      FixedArray::cast(js_object->GetInternalField(kWasmLazyCompilationData)),
+      isolate);
+  LazyCompilationState* state = reinterpret_cast<LazyCompilationState*>(
+      Foreign::cast(data->get(kLazyCompilationState))->foreign_address());
+  FixedArray* import_code =
+      FixedArray::cast(data->get(kLazyCompilationImportCode));
+  Handle<FixedArray> code_table(
+      FixedArray::cast(js_object->GetInternalField(kWasmModuleCodeTable)),
+      isolate);
+  const WasmModule* module = state->module();
+
+  // Recreate the instance as it was at the end of instantiation.
+  WasmModuleInstance instance(module);
+  instance.js_object = js_object;
+  instance.context = isolate->native_context();
+  instance.mem_has_guard_regions = state->mem_has_guard_regions();
+  instance.mem_buffer = handle(
+      JSArrayBuffer::cast(js_object->GetInternalField(kWasmMemArrayBuffer)),
+      isolate);
+  instance.mem_start =
+      reinterpret_cast<byte*>(instance.mem_buffer->backing_store());
+  instance.mem_size =
+      static_cast<uint32_t>(instance.mem_buffer->byte_length()->Number());
+  Object* globals = js_object->GetInternalField(kWasmGlobalsArrayBuffer);
+  if (globals->IsJSArrayBuffer()) {
+    instance.globals_buffer = handle(JSArrayBuffer::cast(globals), isolate);
+    instance.globals_start =
+        reinterpret_cast<byte*>(instance.globals_buffer->backing_store());
+  }
+  Object* function_table =
+      js_object->GetInternalField(kWasmModuleFunctionTable);
+  if (function_table->IsFixedArray()) {
+    instance.function_table =
+        handle(FixedArray::cast(function_table), isolate);
+  }
+  for (uint32_t i = 0; i < module->functions.size(); ++i) {
+    instance.function_code[i] =
+        handle(Code::cast(code_table->get(static_cast<int>(i))), isolate);
+  }
+  for (uint32_t i = 0; i < module->import_table.size(); ++i) {
+    instance.import_code[i] =
+        handle(Code::cast(import_code->get(static_cast<int>(i))), isolate);
+  }
+
+  ModuleEnv module_env;
+  module_env.module = module;
+  module_env.instance = &instance;
+  module_env.origin = module->origin;
+
+  ErrorThrower thrower(isolate, "WasmModule::CompileLazy()");
+  const WasmFunction& func = module->functions[index];
+  Handle<Code> code = compiler::WasmCompilationUnit::CompileWasmFunction(
+      &thrower, isolate, &module_env, &func);
+  if (code.is_null()) {
+    if (!thrower.error()) {
+      WasmName str = module->GetName(func.name_offset, func.name_length);
+      thrower.Error("Compilation of #%d:%.*s failed.", index, str.length(),
+                    str.start());
+    }
+    isolate->Throw(*thrower.Reify());
+    return MaybeHandle<Code>();
+  }
+  SetFunctionDeoptimizationData(isolate->factory(), js_object, code, index);
+  ProtectedCode::Register(isolate, *code);
+  ProtectedCode::Publish();
+
+  code_table->set(static_cast<int>(index), *code);
+  if (!instance.function_table.is_null()) {
+    for (uint32_t i = 0; i < module->function_table.size(); ++i) {
+      if (module->function_table[i] != index) continue;
+      instance.function_table->set(
+          static_cast<int>(i * WasmModule::kFunctionTableEntrySize +
+                           WasmModule::kFunctionTableCodeOffset),
+          *code);
     }
   }
+
+  isolate->counters()->wasm_lazily_compiled_functions()->Increment();
+  if (FLAG_trace_wasm_lazy_compilation) {
+    WasmName str = module->GetName(func.name_offset, func.name_length);
+    PrintF("[wasm lazy compilation of #%u:%.*s]\n", index, str.length(),
+           str.start());
+  }
+  return code;
+}
+
+// Makes the direct calls from {caller} to {stub} call {code} instead.
+void PatchCallsToStub(Isolate* isolate, Handle<Code> caller, Handle<Code> stub,
+                      Handle<Code> code) {
+  bool modified = false;
+  for (RelocIterator it(*caller, RelocInfo::kCodeTargetMask); !it.done();
+       it.next()) {
+    Code* target = Code::GetCodeFromTargetAddress(it.rinfo()->target_address());
+    if (target != *stub) continue;
+    it.rinfo()->set_target_address(code->instruction_start(),
+                                   UPDATE_WRITE_BARRIER, SKIP_ICACHE_FLUSH);
+    modified = true;
+  }
+  if (modified) {
+    Assembler::FlushICache(isolate, caller->instruction_start(),
+                           caller->instruction_size());
+  }
 }
 }  // namespace
 
 void SetDeoptimizationData(Factory* factory, Handle<JSObject> js_object,
                            std::vector<Handle<Code>>& functions) {
   for (size_t i = FLAG_skip_compiling_wasm_funcs; i < functions.size(); ++i) {
-    Handle<Code> code = functions[i];
-    DCHECK(code->deoptimization_data() == nullptr ||
-           code->deoptimization_data()->length() == 0);
-    Handle<FixedArray> deopt_data = factory->NewFixedArray(2, TENURED);
-    if (!js_object.is_null()) {
-      deopt_data->set(0, *js_object);
-    }
-    deopt_data->set(1, Smi::FromInt(static_cast<int>(i)));
-    deopt_data->set_length(2);
-    code->set_deoptimization_data(*deopt_data);
+    SetFunctionDeoptimizationData(factory, js_object, functions[i],
+                                  static_cast<uint32_t>(i));
   }
 }
 
-Handle<FixedArray> WasmModule::CompileFunctions(Isolate* isolate) const {
-  Factory* factory = isolate->factory();
+MaybeHandle<Code> CompileLazy(Isolate* isolate) {
+  // The runtime is called from the stub, which was called by the caller.
+  StackFrameIterator it(isolate);
+  DCHECK(it.frame()->is_exit());
+  it.Advance();
+  DCHECK(it.frame()->is_wasm());
+  WasmFrame* stub_frame = WasmFrame::cast(it.frame());
+  Handle<Code> stub(stub_frame->LookupCode(), isolate);
+  Handle<JSObject> js_object(JSObject::cast(stub_frame->wasm_obj()), isolate);
+  uint32_t index = stub_frame->function_index();
+  it.Advance();
+  Handle<Code> caller(it.frame()->LookupCode(), isolate);
+  DCHECK(caller->kind() == Code::WASM_FUNCTION ||
+         caller->kind() == Code::JS_TO_WASM_FUNCTION);
+
+  // Another caller may have compiled the function already.
+  FixedArray* code_table =
+      FixedArray::cast(js_object->GetInternalField(kWasmModuleCodeTable));
+  Handle<Code> code(Code::cast(code_table->get(static_cast<int>(index))),
+                    isolate);
+  if (*code == *stub &&
+      !CompileLazyFunction(isolate, js_object, index).ToHandle(&code)) {
+    return MaybeHandle<Code>();
+  }
+  PatchCallsToStub(isolate, caller, stub, code);
+  return code;
+}
+
+Handle<FixedArray> WasmModule::CompileFunctions(Isolate* isolate,
+                                                bool use_guard_regions) const {
   ErrorThrower thrower(isolate, "WasmModule::CompileFunctions()");
 
   WasmModuleInstance temp_instance_for_compilation(this);
-  temp_instance_for_compilation.function_table =
-      BuildFunctionTable(isolate, this);
-  temp_instance_for_compilation.context = isolate->native_context();
-  temp_instance_for_compilation.mem_size = GetMinModuleMemSize(this);
-  temp_instance_for_compilation.mem_start = nullptr;
-  temp_instance_for_compilation.globals_start = nullptr;
-
   ModuleEnv module_env;
-  module_env.module = this;
-  module_env.instance = &temp_instance_for_compilation;
-  module_env.origin = origin;
-  InitializePlaceholders(factory, &module_env.placeholders, functions.size());
+  PrepareCompilation(isolate, this, use_guard_regions,
+                     &temp_instance_for_compilation, &module_env);
 
-  Handle<FixedArray> ret =
-      factory->NewFixedArray(static_cast<int>(functions.size()), TENURED);
-
-  temp_instance_for_compilation.import_code.resize(import_table.size());
-  for (uint32_t i = 0; i < import_table.size(); ++i) {
-    temp_instance_for_compilation.import_code[i] =
-        CreatePlaceholder(factory, i, Code::WASM_TO_JS_FUNCTION);
-  }
   isolate->counters()->wasm_functions_per_module()->AddSample(
       static_cast<int>(functions.size()));
   if (FLAG_wasm_num_compilation_tasks != 0) {
@@ -742,19 +1108,7 @@ Handle<FixedArray> WasmModule::CompileFunctions(Isolate* isolate) const {
     return Handle<FixedArray>::null();
   }
 
-  LinkModuleFunctions(isolate, temp_instance_for_compilation.function_code);
-
-  // At this point, compilation has completed. Update the code table
-  // and record sizes.
-  for (size_t i = FLAG_skip_compiling_wasm_funcs;
-       i < temp_instance_for_compilation.function_code.size(); ++i) {
-    Code* code = *temp_instance_for_compilation.function_code[i];
-    ret->set(static_cast<int>(i), code);
-  }
-
-  PopulateFunctionTable(&temp_instance_for_compilation);
-
-  return ret;
+  return LinkCodeTable(isolate, &temp_instance_for_compilation);
 }
 
 // Instantiates a wasm module as a JSObject.
@@ -763,8 +1117,8 @@ Handle<FixedArray> WasmModule::CompileFunctions(Isolate* isolate) const {
 //  * installs named properties on the object for exported functions
 //  * compiles wasm code to machine code
 MaybeHandle<JSObject> WasmModule::Instantiate(
-    Isolate* isolate, Handle<JSReceiver> ffi,
-    Handle<JSArrayBuffer> memory) const {
+    Isolate* isolate, Handle<JSReceiver> ffi, Handle<JSArrayBuffer> memory,
+    Handle<FixedArray> code_table) const {
   HistogramTimerScope wasm_instantiate_module_time_scope(
       isolate->counters()->wasm_instantiate_module_time());
   ErrorThrower thrower(isolate, "WasmModule::Instantiate()");
@@ -780,8 +1134,24 @@ MaybeHandle<JSObject> WasmModule::Instantiate(
   instance.context = isolate->native_context();
   instance.js_object = factory->NewJSObjectFromMap(map, TENURED);
 
-  Handle<FixedArray> code_table = CompileFunctions(isolate);
-  if (code_table.is_null()) return Handle<JSObject>::null();
+  instance.mem_has_guard_regions = MemoryHasGuardRegions(origin, memory);
+  bool lazy_compilation = code_table.is_null() && FLAG_wasm_lazy_compilation;
+  if (lazy_compilation) {
+    code_table = CreateLazyCompileStubs(isolate, &instance, &thrower);
+    if (code_table.is_null()) return MaybeHandle<JSObject>();
+  } else if (code_table.is_null()) {
+    code_table = CompileFunctions(isolate, instance.mem_has_guard_regions);
+    if (code_table.is_null()) return Handle<JSObject>::null();
+  } else if (!instance.mem_has_guard_regions) {
+    // Code compiled for guard regions, e.g. deserialized from a code cache,
+    // omits the bounds checks and cannot run on a plain memory.
+    for (uint32_t i = 0; i < functions.size(); ++i) {
+      if (Code::cast(code_table->get(i))->has_protected_instructions()) {
+        thrower.Error("Code table requires memory with guard regions");
+        return MaybeHandle<JSObject>();
+      }
+    }
+  }
 
   instance.js_object->SetInternalField(kWasmModuleCodeTable, *code_table);
   size_t module_bytes_len =
@@ -798,7 +1168,9 @@ MaybeHandle<JSObject> WasmModule::Instantiate(
   for (uint32_t i = 0; i < functions.size(); ++i) {
     Handle<Code> code = Handle<Code>(Code::cast(code_table->get(i)));
     instance.function_code[i] = code;
+    ProtectedCode::Register(isolate, *code);
   }
+  ProtectedCode::Publish();
 
   //-------------------------------------------------------------------------
   // Allocate and initialize the linear memory.
@@ -855,8 +1227,21 @@ MaybeHandle<JSObject> WasmModule::Instantiate(
   }
 
   {
-    instance.js_object->SetInternalField(kWasmModuleFunctionTable,
-                                         Smi::FromInt(0));
+    if (lazy_compilation) {
+      // Eagerly compiled code embeds its own function table. Lazily compiled
+      // code embeds this one, whose entries are replaced as functions are
+      // compiled.
+      instance.function_table = BuildFunctionTable(isolate, this);
+      PopulateFunctionTable(&instance);
+      InitializeLazyCompilation(isolate, &instance);
+    }
+    if (instance.function_table.is_null()) {
+      instance.js_object->SetInternalField(kWasmModuleFunctionTable,
+                                           Smi::FromInt(0));
+    } else {
+      instance.js_object->SetInternalField(kWasmModuleFunctionTable,
+                                           *instance.function_table);
+    }
     LinkImports(isolate, instance.function_code, instance.import_code);
 
     SetDeoptimizationData(factory, instance.js_object, instance.function_code);
@@ -944,6 +1329,299 @@ MaybeHandle<JSObject> WasmModule::Instantiate(
   return instance.js_object;
 }
 
+namespace {
+// Collects the bytes of a streamed module. The buffer doubles its capacity
+// when it runs out of space, which moves the bytes; see
+// StreamingModuleDecoder::Rebase. Earlier copies are kept until the buffer
+// dies, because compilation units refer to function names in them.
+class StreamedModuleBuffer {
+ public:
+  StreamedModuleBuffer() : capacity_(0), length_(0) {}
+
+  byte* start() { return blocks_.empty() ? nullptr : blocks_.back().get(); }
+  byte* end() { return start() + length_; }
+  size_t length() const { return length_; }
+
+  // Whether {length} more bytes fit without moving the buffer.
+  bool HasSpace(size_t length) const { return length <= capacity_ - length_; }
+
+  // Moves the bytes into a larger buffer with space for {length} more bytes.
+  void Grow(size_t length) {
+    size_t capacity = Max(Max(kInitialCapacity, 2 * capacity_),
+                          RoundUp(length_ + length, kInitialCapacity));
+    byte* block = NewArray<byte>(capacity);
+    if (length_ > 0) MemCopy(block, start(), length_);
+    blocks_.push_back(std::unique_ptr<byte[]>(block));
+    capacity_ = capacity;
+  }
+
+  // Appends {length} bytes, for which there must be space.
+  void Append(const byte* chunk, size_t length) {
+    DCHECK(HasSpace(length));
+    MemCopy(end(), chunk, length);
+    length_ += length;
+  }
+
+ private:
+  static const size_t kInitialCapacity = 64 * KB;
+
+  std::vector<std::unique_ptr<byte[]>> blocks_;
+  size_t capacity_;
+  size_t length_;
+};
+
+// Compiles the functions of a streamed module while the rest of the module
+// arrives. The main thread creates a compilation unit for each function body
+// that the decoder reports and queues it. Background tasks execute the queued
+// units and exit when the queue runs dry; new tasks are spawned as more units
+// are queued. The main thread finishes the executed units between chunks.
+class StreamingCompiler : public FunctionBodyListener {
+ public:
+  StreamingCompiler(Isolate* isolate, ErrorThrower* thrower,
+                    bool use_guard_regions)
+      : isolate_(isolate),
+        thrower_(thrower),
+        use_guard_regions_(use_guard_regions),
+        module_(nullptr),
+        invalidated_(false),
+        max_tasks_(
+            Min(static_cast<size_t>(FLAG_wasm_num_compilation_tasks),
+                V8::GetCurrentPlatform()->NumberOfAvailableBackgroundThreads())),
+        running_tasks_(0) {}
+
+  ~StreamingCompiler() {
+    CHECK(pending_units_.empty());
+    CHECK(executed_units_.empty());
+    CHECK(task_ids_.empty());
+    CHECK_EQ(0u, running_tasks_);
+  }
+
+  void OnCodeSectionStart(WasmModule* module, uint32_t code_size) override {
+    module_ = module;
+    instance_.Reset(new WasmModuleInstance(module));
+    PrepareCompilation(isolate_, module, use_guard_regions_, instance_.get(),
+                       &module_env_);
+    isolate_->counters()->wasm_functions_per_module()->AddSample(
+        static_cast<int>(module->functions.size()));
+  }
+
+  void OnFunctionBody(WasmFunction* function) override {
+    if (invalidated_) return;
+    uint32_t index = function->func_index;
+    if (index < static_cast<uint32_t>(FLAG_skip_compiling_wasm_funcs)) return;
+    compiler::WasmCompilationUnit* unit = new compiler::WasmCompilationUnit(
+        thrower_, isolate_, &module_env_, function, index);
+    bool start_task = false;
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      pending_units_.push(unit);
+      if (running_tasks_ < max_tasks_) {
+        running_tasks_++;
+        start_task = true;
+      }
+    }
+    if (start_task) StartTask();
+  }
+
+  void OnCodeInvalidated() override {
+    if (module_ == nullptr || invalidated_) return;
+    invalidated_ = true;
+    DiscardUnits();
+  }
+
+  // Waits until no background task reads the module bytes, before they move.
+  void OnBytesMoving() { WaitForTasks(); }
+
+  // Resumes the background compilation of the queued units after the module
+  // bytes moved.
+  void OnBytesMoved() {
+    size_t new_tasks = 0;
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      DCHECK_EQ(0u, running_tasks_);
+      new_tasks = Min(pending_units_.size(), max_tasks_);
+      running_tasks_ = new_tasks;
+    }
+    for (size_t i = 0; i < new_tasks; i++) StartTask();
+  }
+
+  // Finishes the units that have been executed so far.
+  void FinishExecutedUnits() {
+    if (module_ == nullptr || invalidated_) return;
+    FinishCompilationUnits(executed_units_, instance_->function_code, mutex_);
+  }
+
+  // Completes the compilation and returns the linked code table. Returns a
+  // null handle if no code can be used: because nothing was compiled, the
+  // module failed to decode ({decoded} is false), or the code was
+  // invalidated, in which case the module is compiled again as a whole.
+  Handle<FixedArray> Finish(bool decoded) {
+    if (module_ == nullptr || invalidated_) return Handle<FixedArray>::null();
+    if (!decoded) {
+      DiscardUnits();
+      return Handle<FixedArray>::null();
+    }
+    // The main thread helps with the units that are left.
+    while (ExecutePendingUnit(false)) {
+      FinishExecutedUnits();
+    }
+    WaitForTasks();
+    FinishExecutedUnits();
+    if (thrower_->error()) return Handle<FixedArray>::null();
+    return LinkCodeTable(isolate_, instance_.get());
+  }
+
+ private:
+  class CompilationTask : public CancelableTask {
+   public:
+    CompilationTask(Isolate* isolate, StreamingCompiler* compiler)
+        : CancelableTask(isolate), compiler_(compiler) {}
+
+    void RunInternal() override {
+      while (compiler_->ExecutePendingUnit(true)) {
+      }
+      compiler_->module_->pending_tasks->Signal();
+    }
+
+   private:
+    StreamingCompiler* compiler_;
+  };
+
+  void StartTask() {
+    CompilationTask* task = new CompilationTask(isolate_, this);
+    task_ids_.push_back(task->id());
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+
+  // Executes the parallel phase of the next queued unit. Returns false if the
+  // queue is empty, which ends a task if called {on_task}.
+  bool ExecutePendingUnit(bool on_task) {
+    DisallowHeapAllocation no_allocation;
+    DisallowHandleAllocation no_handles;
+    DisallowHandleDereference no_deref;
+    DisallowCodeDependencyChange no_dependency_change;
+
+    compiler::WasmCompilationUnit* unit = nullptr;
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      if (pending_units_.empty()) {
+        if (on_task) running_tasks_--;
+        return false;
+      }
+      unit = pending_units_.front();
+      pending_units_.pop();
+    }
+    unit->ExecuteCompilation();
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      executed_units_.push(unit);
+    }
+    return true;
+  }
+
+  void WaitForTasks() {
+    for (uint32_t task_id : task_ids_) {
+      // If the task has not started yet, then we abort it. Otherwise we wait
+      // for it to finish.
+      if (isolate_->cancelable_task_manager()->TryAbort(task_id)) {
+        base::LockGuard<base::Mutex> guard(&mutex_);
+        running_tasks_--;
+      } else {
+        module_->pending_tasks->Wait();
+      }
+    }
+    task_ids_.clear();
+  }
+
+  void DiscardUnits() {
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      while (!pending_units_.empty()) {
+        delete pending_units_.front();
+        pending_units_.pop();
+      }
+    }
+    WaitForTasks();
+    while (!executed_units_.empty()) {
+      delete executed_units_.front();
+      executed_units_.pop();
+    }
+  }
+
+  Isolate* isolate_;
+  ErrorThrower* thrower_;
+  bool use_guard_regions_;
+  WasmModule* module_;
+  bool invalidated_;
+  base::SmartPointer<WasmModuleInstance> instance_;
+  ModuleEnv module_env_;
+
+  // Objects for the synchronization with the background tasks.
+  base::Mutex mutex_;
+  std::queue<compiler::WasmCompilationUnit*> pending_units_;
+  std::queue<compiler::WasmCompilationUnit*> executed_units_;
+  const size_t max_tasks_;
+  size_t running_tasks_;
+  std::vector<uint32_t> task_ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingCompiler);
+};
+
+}  // namespace
+
+MaybeHandle<JSObject> CompileAndInstantiateStreamedModule(
+    Isolate* isolate, ModuleByteStream* stream, ErrorThrower* thrower,
+    ModuleOrigin origin, Handle<JSReceiver> ffi, Handle<JSArrayBuffer> memory) {
+  StreamedModuleBuffer buffer;
+  buffer.Grow(0);
+
+  Zone zone(isolate->allocator());
+  ModuleResult result;
+  Handle<FixedArray> code_table;
+  {
+    // Turn on the {CanonicalHandleScope} so that the background threads can
+    // use the node cache.
+    CanonicalHandleScope canonical(isolate);
+    StreamingCompiler compiler(isolate, thrower,
+                               MemoryHasGuardRegions(origin, memory));
+    StreamingModuleDecoder decoder(isolate, &zone, buffer.start(), origin,
+                                   &compiler);
+
+    const byte* chunk = nullptr;
+    while (size_t length = stream->GetMoreData(&chunk)) {
+      if (length >= kMaxModuleSize - buffer.length()) {
+        thrower->Error("size > maximum module size");
+        break;
+      }
+      if (!buffer.HasSpace(length)) {
+        compiler.OnBytesMoving();
+        buffer.Grow(length);
+        decoder.Rebase(buffer.start());
+        compiler.OnBytesMoved();
+      }
+      buffer.Append(chunk, length);
+      decoder.OnBytesReceived(buffer.end());
+      compiler.FinishExecutedUnits();
+    }
+    if (thrower->error()) {
+      compiler.Finish(false);
+      return MaybeHandle<JSObject>();
+    }
+
+    result = decoder.Finish(buffer.end());
+    code_table = compiler.Finish(result.ok());
+  }
+
+  std::unique_ptr<const WasmModule> module(result.val);
+  if (result.failed()) {
+    thrower->Failed("", result);
+    return MaybeHandle<JSObject>();
+  }
+  if (thrower->error()) return MaybeHandle<JSObject>();
+  return module->Instantiate(isolate, ffi, memory, code_table);
+}
+
 // TODO(mtrofin): remove this once we move to WASM_DIRECT_CALL
 Handle<Code> ModuleEnv::GetCodeOrPlaceholder(uint32_t index) const {
   DCHECK(IsValidFunction(index));
@@ -1028,6 +1706,64 @@ WasmDebugInfo* GetDebugInfo(JSObject* wasm) {
 
 namespace testing {
 
+namespace {
+// Hands out the bytes of a module in chunks of a fixed size.
+class ChunkedModuleByteStream : public ModuleByteStream {
+ public:
+  ChunkedModuleByteStream(const byte* start, const byte* end,
+                          size_t chunk_size)
+      : pos_(start), end_(end), chunk_size_(chunk_size) {}
+
+  size_t GetMoreData(const byte** chunk) override {
+    size_t length = Min(chunk_size_, static_cast<size_t>(end_ - pos_));
+    *chunk = pos_;
+    pos_ += length;
+    return length;
+  }
+
+ private:
+  const byte* pos_;
+  const byte* end_;
+  size_t chunk_size_;
+};
+
+// Calls the function exported as "main" by {instance}.
+int32_t CallMain(Isolate* isolate, Handle<JSObject> instance,
+                 ErrorThrower* thrower) {
+  Handle<Name> exports = isolate->factory()->InternalizeUtf8String("exports");
+  Handle<JSObject> exports_object = Handle<JSObject>::cast(
+      JSObject::GetProperty(instance, exports).ToHandleChecked());
+  Handle<Name> main_name = isolate->factory()->NewStringFromStaticChars("main");
+  PropertyDescriptor desc;
+  Maybe<bool> property_found = JSReceiver::GetOwnPropertyDescriptor(
+      isolate, exports_object, main_name, &desc);
+  if (!property_found.FromMaybe(false)) return -1;
+
+  Handle<JSFunction> main_export = Handle<JSFunction>::cast(desc.value());
+
+  // Call the JS function.
+  Handle<Object> undefined = isolate->factory()->undefined_value();
+  MaybeHandle<Object> retval =
+      Execution::Call(isolate, main_export, undefined, 0, nullptr);
+
+  // The result should be a number.
+  if (retval.is_null()) {
+    thrower->Error("WASM.compileRun() failed: Invocation was null");
+    return -1;
+  }
+  Handle<Object> result = retval.ToHandleChecked();
+  if (result->IsSmi()) {
+    return Smi::cast(*result)->value();
+  }
+  if (result->IsHeapNumber()) {
+    return static_cast<int32_t>(HeapNumber::cast(*result)->value());
+  }
+  thrower->Error("WASM.compileRun() failed: Return value should be number");
+  return -1;
+}
+
+}  // namespace
+
 int32_t CompileAndRunWasmModule(Isolate* isolate, const byte* module_start,
                                 const byte* module_end, bool asm_js) {
   HandleScope scope(isolate);
@@ -1063,36 +1799,61 @@ int32_t CompileAndRunWasmModule(Isolate* isolate, const byte* module_start,
                         Handle<JSArrayBuffer>::null())
           .ToHandleChecked();
 
-  Handle<Name> exports = isolate->factory()->InternalizeUtf8String("exports");
-  Handle<JSObject> exports_object = Handle<JSObject>::cast(
-      JSObject::GetProperty(instance, exports).ToHandleChecked());
-  Handle<Name> main_name = isolate->factory()->NewStringFromStaticChars("main");
-  PropertyDescriptor desc;
-  Maybe<bool> property_found = JSReceiver::GetOwnPropertyDescriptor(
-      isolate, exports_object, main_name, &desc);
-  if (!property_found.FromMaybe(false)) return -1;
+  return CallMain(isolate, instance, &thrower);
+}
 
-  Handle<JSFunction> main_export = Handle<JSFunction>::cast(desc.value());
+int32_t CompileAndRunStreamedWasmModule(Isolate* isolate,
+                                        const byte* module_start,
+                                        const byte* module_end,
+                                        size_t chunk_size) {
+  HandleScope scope(isolate);
+  ErrorThrower thrower(isolate, "CompileAndRunStreamedWasmModule");
+  ChunkedModuleByteStream stream(module_start, module_end, chunk_size);
+  MaybeHandle<JSObject> instance = CompileAndInstantiateStreamedModule(
+      isolate, &stream, &thrower, kWasmOrigin, Handle<JSReceiver>::null(),
+      Handle<JSArrayBuffer>::null());
+  if (instance.is_null()) return -1;
+  return CallMain(isolate, instance.ToHandleChecked(), &thrower);
+}
 
-  // Call the JS function.
-  Handle<Object> undefined = isolate->factory()->undefined_value();
-  MaybeHandle<Object> retval =
-      Execution::Call(isolate, main_export, undefined, 0, nullptr);
+int32_t CompileAndRunCachedWasmModule(Isolate* isolate,
+                                      const byte* module_start,
+                                      const byte* module_end) {
+  HandleScope scope(isolate);
+  Zone zone(isolate->allocator());
+  ErrorThrower thrower(isolate, "CompileAndRunCachedWasmModule");
 
-  // The result should be a number.
-  if (retval.is_null()) {
-    thrower.Error("WASM.compileRun() failed: Invocation was null");
+  ModuleResult decoding_result = DecodeWasmModule(
+      isolate, &zone, module_start, module_end, false, kWasmOrigin);
+  std::unique_ptr<const WasmModule> module(decoding_result.val);
+  if (decoding_result.failed()) {
+    thrower.Error("WASM.compileRun() failed: %s",
+                  decoding_result.error_msg.get());
     return -1;
   }
-  Handle<Object> result = retval.ToHandleChecked();
-  if (result->IsSmi()) {
-    return Smi::cast(*result)->value();
+
+  Vector<const byte> module_bytes(
+      module_start, static_cast<int>(module_end - module_start));
+  ScriptData* data;
+  {
+    HandleScope compile_scope(isolate);
+    Handle<FixedArray> code_table = module->CompileFunctions(isolate);
+    if (code_table.is_null()) return -1;
+    data = WasmCodeSerializer::Serialize(isolate, code_table, module_bytes);
   }
-  if (result->IsHeapNumber()) {
-    return static_cast<int32_t>(HeapNumber::cast(*result)->value());
+  MaybeHandle<FixedArray> code_table =
+      WasmCodeSerializer::Deserialize(isolate, data, module_bytes);
+  delete data;
+  if (code_table.is_null()) {
+    thrower.Error("WASM.compileRun() failed: Cached code was rejected");
+    return -1;
   }
-  thrower.Error("WASM.compileRun() failed: Return value should be number");
-  return -1;
+
+  MaybeHandle<JSObject> instance = module->Instantiate(
+      isolate, Handle<JSReceiver>::null(), Handle<JSArrayBuffer>::null(),
+      code_table.ToHandleChecked());
+  if (instance.is_null()) return -1;
+  return CallMain(isolate, instance.ToHandleChecked(), &thrower);
 }
 
 }  // namespace testing
@@ -7,6 +7,7 @@
 
 #include "src/api.h"
 #include "src/handles.h"
+#include "src/wasm/signature-map.h"
 #include "src/wasm/wasm-opcodes.h"
 #include "src/wasm/wasm-result.h"
 
@@ -159,6 +160,13 @@ struct WasmModule {
   static const uint32_t kMinMemPages = 1;       // Minimum memory size = 64kb
   static const uint32_t kMaxMemPages = 16384;   // Maximum memory size =  1gb
 
+  // The function table of an instance holds one entry per slot: the signature
+  // id of the function in {signature_map} as a Smi, followed by its code.
+  // Keeping both in one entry lets call_indirect address them together.
+  static const int kFunctionTableEntrySize = 2;
+  static const int kFunctionTableSignatureOffset = 0;
+  static const int kFunctionTableCodeOffset = 1;
+
   const byte* module_start;   // starting address for the module bytes.
   const byte* module_end;     // end address for the module bytes.
   uint32_t min_mem_pages;     // minimum size of the memory in 64k pages.
@@ -173,6 +181,7 @@ struct WasmModule {
   uint32_t indirect_table_size;                // size of indirect function
                                                //     table (includes padding).
   std::vector<FunctionSig*> signatures;        // signatures in this module.
+  SignatureMap signature_map;                  // ids of the signatures.
   std::vector<WasmFunction> functions;         // functions in this module.
   std::vector<WasmDataSegment> data_segments;  // data segments in this module.
   std::vector<uint16_t> function_table;        // function table.
@@ -223,11 +232,19 @@ struct WasmModule {
     return start <= size && end <= size;
   }
 
-  // Creates a new instantiation of the module in the given isolate.
-  MaybeHandle<JSObject> Instantiate(Isolate* isolate, Handle<JSReceiver> ffi,
-                                    Handle<JSArrayBuffer> memory) const;
+  // Creates a new instantiation of the module in the given isolate. Unless a
+  // {code_table} from an earlier compilation of the functions is given, the
+  // functions are compiled first.
+  MaybeHandle<JSObject> Instantiate(
+      Isolate* isolate, Handle<JSReceiver> ffi, Handle<JSArrayBuffer> memory,
+      Handle<FixedArray> code_table = Handle<FixedArray>::null()) const;
 
-  Handle<FixedArray> CompileFunctions(Isolate* isolate) const;
+  // Compiles all functions of the module. If {use_guard_regions} is set, the
+  // code omits explicit bounds checks and expects the memory to be allocated
+  // with guard regions. The resulting code table can be stored with
+  // WasmCodeSerializer and, once deserialized, passed to Instantiate once.
+  Handle<FixedArray> CompileFunctions(Isolate* isolate,
+                                      bool use_guard_regions = false) const;
 
   uint32_t FunctionTableSize() const {
     if (indirect_table_size > 0) {
@@ -252,6 +269,7 @@ struct WasmModuleInstance {
   // -- raw memory ------------------------------------------------------------
   byte* mem_start;  // start of linear memory.
   uint32_t mem_size;  // size of the linear memory.
+  bool mem_has_guard_regions;  // out-of-bounds accesses fault.
   // -- raw globals -----------------------------------------------------------
   byte* globals_start;  // start of the globals area.
 
@@ -261,6 +279,7 @@ struct WasmModuleInstance {
         import_code(m->import_table.size()),
         mem_start(nullptr),
         mem_size(0),
+        mem_has_guard_regions(false),
         globals_start(nullptr) {}
 };
 
@@ -335,6 +354,41 @@ typedef Result<WasmFunction*> FunctionResult;
 typedef std::vector<std::pair<int, int>> FunctionOffsets;
 typedef Result<FunctionOffsets> FunctionOffsetsResult;
 
+// The bytes of a module that arrive over time, e.g. from the network.
+// Similar to ScriptCompiler::ExternalSourceStream, the stream is pulled on
+// the main thread and GetMoreData may block until more bytes are available.
+class ModuleByteStream {
+ public:
+  virtual ~ModuleByteStream() {}
+
+  // Points {chunk} to the next bytes of the module and returns their number.
+  // The bytes stay valid until the next call. Returns 0 at the end of the
+  // module.
+  virtual size_t GetMoreData(const byte** chunk) = 0;
+};
+
+// Decodes, compiles and instantiates the module read from {stream}. Each
+// function is compiled in the background as soon as its body has arrived, so
+// that compilation overlaps with the arrival of the rest of the module.
+MaybeHandle<JSObject> CompileAndInstantiateStreamedModule(
+    Isolate* isolate, ModuleByteStream* stream, ErrorThrower* thrower,
+    ModuleOrigin origin, Handle<JSReceiver> ffi, Handle<JSArrayBuffer> memory);
+
+// Compiles the function behind the lazy compile stub that called into the
+// runtime, installs it in its instance and patches the direct calls from the
+// stub's caller to call it. Returns the compiled code, or an empty handle with
+// a pending exception if compilation failed. Used with
+// --wasm-lazy-compilation.
+MaybeHandle<Code> CompileLazy(Isolate* isolate);
+
+// Internal fields of the JSFunctions created for exported wasm functions. The
+// signature id is the process-wide id of the function's signature (see
+// SignatureMap::FindOrInsertCanonical), which lets an importing instance call
+// the wasm code directly.
+const int kWasmExportModuleObject = 0;
+const int kWasmExportSignatureId = 1;
+const int kWasmExportInternalFieldCount = 2;
+
 // Extract a function name from the given wasm object.
 // Returns "<WASM UNNAMED>" if the function is unnamed or the name is not a
 // valid UTF-8 string.
@@ -368,6 +422,19 @@ namespace testing {
 int32_t CompileAndRunWasmModule(Isolate* isolate, const byte* module_start,
                                 const byte* module_end, bool asm_js = false);
 
+// Like CompileAndRunWasmModule, but compiles the module while streaming it in
+// chunks of {chunk_size} bytes.
+int32_t CompileAndRunStreamedWasmModule(Isolate* isolate,
+                                        const byte* module_start,
+                                        const byte* module_end,
+                                        size_t chunk_size);
+
+// Like CompileAndRunWasmModule, but instantiates the module from a code table
+// that went through a round trip of serialization and deserialization.
+int32_t CompileAndRunCachedWasmModule(Isolate* isolate,
+                                      const byte* module_start,
+                                      const byte* module_end);
+
 }  // namespace testing
 
 }  // namespace wasm
@@ -0,0 +1,320 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/wasm/wasm-trap-handler.h"
+
+#if V8_OS_LINUX && V8_TARGET_ARCH_X64 && V8_HOST_ARCH_X64
+#define V8_WASM_GUARD_REGIONS 1
+#include <signal.h>
+#include <ucontext.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "src/base/atomicops.h"
+#include "src/base/lazy-instance.h"
+#include "src/base/once.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/platform.h"
+#include "src/flags.h"
+#include "src/global-handles.h"
+#include "src/isolate.h"
+#include "src/objects-inl.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+
+namespace {
+
+// Start addresses of the live guard regions, or 0 for free slots. Slots are
+// only written under {regions_mutex}, but read from the signal handler
+// without locking.
+base::AtomicWord regions[GuardRegions::kMaxRegions];
+base::LazyMutex regions_mutex = LAZY_MUTEX_INITIALIZER;
+
+bool AddRegion(void* start) {
+  base::LockGuard<base::Mutex> guard(regions_mutex.Pointer());
+  for (int i = 0; i < GuardRegions::kMaxRegions; i++) {
+    if (base::NoBarrier_Load(&regions[i]) != 0) continue;
+    base::Release_Store(&regions[i], reinterpret_cast<base::AtomicWord>(start));
+    return true;
+  }
+  return false;
+}
+
+void RemoveRegion(void* start) {
+  base::LockGuard<base::Mutex> guard(regions_mutex.Pointer());
+  for (int i = 0; i < GuardRegions::kMaxRegions; i++) {
+    if (base::NoBarrier_Load(&regions[i]) ==
+        reinterpret_cast<base::AtomicWord>(start)) {
+      base::Release_Store(&regions[i], 0);
+      return;
+    }
+  }
+  UNREACHABLE();
+}
+
+// A copy of the protected instructions of a code object.
+struct ProtectedCodeEntry {
+  Address start;    // Instruction start of the code, updated when it moves.
+  int size;         // Instruction size of the code.
+  int length;       // Number of ints in {table}.
+  int* table;       // See Code::protected_instructions.
+  Object** handle;  // Weak handle that releases the entry.
+};
+
+void DeleteEntry(ProtectedCodeEntry* entry) {
+  delete[] entry->table;
+  delete entry;
+}
+
+// The signal handler looks up entries in an immutable table, which is sorted
+// by the instruction start of the code. ProtectedCode::Publish() replaces it
+// after entries were added, moved or released.
+struct LookupEntry {
+  Address start;
+  const ProtectedCodeEntry* entry;
+};
+typedef std::vector<LookupEntry> LookupTable;
+
+// The published LookupTable, read by the signal handler without locking.
+base::AtomicWord lookup_table = 0;
+base::LazyMutex entries_mutex = LAZY_MUTEX_INITIALIZER;
+
+// The following are protected by {entries_mutex}. Released entries stay alive
+// until they are no longer in the published table, and replaced tables and
+// entries are deleted once no signal handler can still be reading them.
+typedef std::map<Address, ProtectedCodeEntry*> Entries;
+base::LazyInstance<Entries>::type entries = LAZY_INSTANCE_INITIALIZER;
+bool entries_changed = false;
+base::LazyInstance<std::vector<ProtectedCodeEntry*>>::type released_entries =
+    LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<std::vector<ProtectedCodeEntry*>>::type retired_entries =
+    LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<std::vector<LookupTable*>>::type retired_tables =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Number of signal handlers that are looking up entries.
+base::Atomic32 active_lookups = 0;
+
+void ReleaseEntry(const v8::WeakCallbackInfo<void>& data) {
+  ProtectedCodeEntry* entry =
+      reinterpret_cast<ProtectedCodeEntry*>(data.GetParameter());
+  base::LockGuard<base::Mutex> guard(entries_mutex.Pointer());
+  entries.Pointer()->erase(entry->start);
+  entries_changed = true;
+  GlobalHandles::Destroy(entry->handle);
+  released_entries.Pointer()->push_back(entry);
+}
+
+bool StartsBefore(Address pc, const LookupEntry& entry) {
+  return pc < entry.start;
+}
+
+Address FindLandingPadInTable(Address pc) {
+  const LookupTable* table =
+      reinterpret_cast<const LookupTable*>(base::Acquire_Load(&lookup_table));
+  if (table == nullptr) return nullptr;
+  // The code containing {pc} is the last one that starts at or before it.
+  auto it = std::upper_bound(table->begin(), table->end(), pc, &StartsBefore);
+  if (it == table->begin()) return nullptr;
+  --it;
+  const ProtectedCodeEntry* entry = it->entry;
+  if (pc >= it->start + entry->size) return nullptr;
+  int offset = static_cast<int>(pc - it->start);
+  // Protected instructions are recorded in code order, so their ranges are
+  // sorted and disjoint.
+  int low = 0;
+  int high = entry->length / Code::kProtectedInstructionEntrySize;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    const int* instruction =
+        &entry->table[mid * Code::kProtectedInstructionEntrySize];
+    if (offset < instruction[Code::kProtectedInstructionStart]) {
+      high = mid;
+    } else if (offset >= instruction[Code::kProtectedInstructionEnd]) {
+      low = mid + 1;
+    } else {
+      return it->start + instruction[Code::kProtectedInstructionLanding];
+    }
+  }
+  return nullptr;
+}
+
+#if V8_WASM_GUARD_REGIONS
+
+struct sigaction previous_action;
+base::OnceType install_handler_once = V8_ONCE_INIT;
+
+// Passes a fault that is not a wasm out-of-bounds access on to the action
+// that was installed before ours, which stays installed for later faults.
+void CallPreviousHandler(int signal, siginfo_t* info, void* context) {
+  if (previous_action.sa_flags & SA_SIGINFO) {
+    previous_action.sa_sigaction(signal, info, context);
+  } else if (previous_action.sa_handler != SIG_DFL &&
+             previous_action.sa_handler != SIG_IGN) {
+    previous_action.sa_handler(signal);
+  } else {
+    // A fault cannot be ignored. Returning re-executes the faulting
+    // instruction, which then terminates the process as usual.
+    ::signal(SIGSEGV, SIG_DFL);
+  }
+}
+
+void HandleSignal(int signal, siginfo_t* info, void* context) {
+  ucontext_t* ucontext = reinterpret_cast<ucontext_t*>(context);
+  Address fault_address = reinterpret_cast<Address>(info->si_addr);
+  if (GuardRegions::Contains(fault_address)) {
+    Address pc =
+        reinterpret_cast<Address>(ucontext->uc_mcontext.gregs[REG_RIP]);
+    Address landing = ProtectedCode::FindLandingPad(pc);
+    if (landing != nullptr) {
+      ucontext->uc_mcontext.gregs[REG_RIP] =
+          reinterpret_cast<greg_t>(landing);
+      return;
+    }
+  }
+  CallPreviousHandler(signal, info, context);
+}
+
+void InstallHandler() {
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = &HandleSignal;
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+  CHECK_EQ(0, sigaction(SIGSEGV, &action, &previous_action));
+}
+
+#endif  // V8_WASM_GUARD_REGIONS
+
+}  // namespace
+
+bool GuardRegions::IsSupported() {
+#if V8_WASM_GUARD_REGIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool GuardRegions::IsEnabled() {
+  return FLAG_wasm_guard_pages && IsSupported();
+}
+
+void* GuardRegions::Allocate(size_t size) {
+  DCHECK(IsEnabled());
+  DCHECK_LE(size, kRegionSize);
+  void* memory = base::VirtualMemory::ReserveRegion(kRegionSize);
+  if (memory == nullptr) return nullptr;
+  if ((size > 0 && !base::VirtualMemory::CommitRegion(memory, size, false)) ||
+      !AddRegion(memory)) {
+    base::VirtualMemory::ReleaseRegion(memory, kRegionSize);
+    return nullptr;
+  }
+#if V8_WASM_GUARD_REGIONS
+  base::CallOnce(&install_handler_once, &InstallHandler);
+#endif
+  return memory;
+}
+
+void GuardRegions::Free(void* memory) {
+  RemoveRegion(memory);
+  CHECK(base::VirtualMemory::ReleaseRegion(memory, kRegionSize));
+}
+
+bool GuardRegions::Contains(Address address) {
+  for (int i = 0; i < kMaxRegions; i++) {
+    Address start = reinterpret_cast<Address>(base::Acquire_Load(&regions[i]));
+    if (start == nullptr) continue;
+    if (address >= start && address < start + kRegionSize) return true;
+  }
+  return false;
+}
+
+void ProtectedCode::Register(Isolate* isolate, Code* code) {
+  if (!GuardRegions::IsSupported()) return;
+  if (code->kind() != Code::WASM_FUNCTION) return;
+  if (!code->has_protected_instructions()) return;
+  Address start = code->instruction_start();
+  base::LockGuard<base::Mutex> guard(entries_mutex.Pointer());
+  Entries* map = entries.Pointer();
+  if (map->find(start) != map->end()) return;
+
+  ByteArray* instructions = code->protected_instructions();
+  ProtectedCodeEntry* entry = new ProtectedCodeEntry;
+  entry->start = start;
+  entry->size = code->instruction_size();
+  entry->length = instructions->length() / kIntSize;
+  entry->table = new int[entry->length];
+  for (int i = 0; i < entry->length; i++) {
+    entry->table[i] = instructions->get_int(i);
+  }
+  entry->handle = isolate->global_handles()->Create(code).location();
+  GlobalHandles::MakeWeak(entry->handle, entry, &ReleaseEntry,
+                          v8::WeakCallbackType::kParameter);
+  map->insert(std::make_pair(start, entry));
+  entries_changed = true;
+}
+
+void ProtectedCode::Move(Code* code, intptr_t delta) {
+  Address start = code->instruction_start();
+  base::LockGuard<base::Mutex> guard(entries_mutex.Pointer());
+  Entries* map = entries.Pointer();
+  auto it = map->find(start - delta);
+  if (it == map->end()) return;
+  ProtectedCodeEntry* entry = it->second;
+  map->erase(it);
+  entry->start = start;
+  map->insert(std::make_pair(start, entry));
+  entries_changed = true;
+}
+
+void ProtectedCode::Publish() {
+  base::LockGuard<base::Mutex> guard(entries_mutex.Pointer());
+  if (!entries_changed) return;
+  entries_changed = false;
+  LookupTable* table = new LookupTable();
+  table->reserve(entries.Pointer()->size());
+  for (const auto& it : *entries.Pointer()) {
+    table->push_back({it.first, it.second});
+  }
+  LookupTable* old_table =
+      reinterpret_cast<LookupTable*>(base::NoBarrier_Load(&lookup_table));
+  base::Release_Store(&lookup_table, reinterpret_cast<base::AtomicWord>(table));
+
+  // The old table and the entries released before this point are out of
+  // reach for lookups that start from now on.
+  std::vector<ProtectedCodeEntry*>* released = released_entries.Pointer();
+  std::vector<ProtectedCodeEntry*>* retired = retired_entries.Pointer();
+  retired->insert(retired->end(), released->begin(), released->end());
+  released->clear();
+  if (old_table != nullptr) retired_tables.Pointer()->push_back(old_table);
+  // Pairs with the increment in FindLandingPad: a handler that did not see
+  // the new table is counted in {active_lookups}.
+  base::MemoryBarrier();
+  if (base::NoBarrier_Load(&active_lookups) != 0) return;
+  for (ProtectedCodeEntry* retired_entry : *retired) {
+    DeleteEntry(retired_entry);
+  }
+  retired->clear();
+  for (LookupTable* retired_table : *retired_tables.Pointer()) {
+    delete retired_table;
+  }
+  retired_tables.Pointer()->clear();
+}
+
+Address ProtectedCode::FindLandingPad(Address pc) {
+  base::Barrier_AtomicIncrement(&active_lookups, 1);
+  Address landing = FindLandingPadInTable(pc);
+  base::Barrier_AtomicIncrement(&active_lookups, -1);
+  return landing;
+}
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,74 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_WASM_TRAP_HANDLER_H_
+#define V8_WASM_TRAP_HANDLER_H_
+
+#include "src/allocation.h"
+#include "src/globals.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+
+// Guard regions replace the explicit bounds checks on wasm memory accesses.
+// Each memory is placed at the start of a reservation that is large enough
+// for any 32-bit index plus any 32-bit offset, and everything behind the
+// committed memory stays inaccessible. Out-of-bounds accesses therefore fault,
+// and a signal handler resumes execution at the out-of-line trap that the
+// code generator emitted for the faulting instruction (see
+// Code::protected_instructions).
+class GuardRegions : public AllStatic {
+ public:
+  // Whether the platform supports guard regions: x64 Linux only.
+  static bool IsSupported();
+
+  // Whether new wasm memories are allocated with guard regions.
+  static bool IsEnabled();
+
+  // Reserves a guard region and commits the first {size} bytes of it as
+  // zero-initialized memory. Installs the signal handler on first use.
+  // Returns nullptr if the address space cannot be reserved.
+  static void* Allocate(size_t size);
+
+  // Releases the guard region of a memory returned by Allocate.
+  static void Free(void* memory);
+
+  // Whether {address} is within a guard region. Async-signal-safe.
+  static bool Contains(Address address);
+
+  // Size of the reservation per memory, including the memory itself. Covers
+  // the largest index plus the largest offset plus the access size.
+  static const size_t kRegionSize = (static_cast<size_t>(1) << 33) + MB;
+
+  // Maximum number of memories with guard regions alive at the same time.
+  static const int kMaxRegions = 1024;
+};
+
+// Protected instructions of live wasm code, copied out of the heap so that the
+// signal handler can find the landing pad of a faulting pc without locks or
+// allocation. Entries follow their code when the GC moves it and are released
+// when it dies. The signal handler only sees these changes after Publish().
+class ProtectedCode : public AllStatic {
+ public:
+  // Adds the protected instructions of {code}, unless they were added before.
+  static void Register(Isolate* isolate, Code* code);
+
+  // Called by the GC after it moved the wasm function {code} by {delta} bytes.
+  static void Move(Code* code, intptr_t delta);
+
+  // Makes the changes since the last call visible to the signal handler. Must
+  // be called before registered or moved code runs again.
+  static void Publish();
+
+  // Returns the landing pad for a fault at {pc}, or nullptr if {pc} is not a
+  // protected instruction. Async-signal-safe.
+  static Address FindLandingPad(Address pc);
+};
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_WASM_TRAP_HANDLER_H_
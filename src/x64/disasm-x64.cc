@@ -1659,6 +1659,9 @@ int DisassemblerX64::TwoByteOpcodeInstruction(byte* data) {
       } else if (opcode == 0x50) {
         AppendToBuffer("movmskpd %s,", NameOfCPURegister(regop));
         current += PrintRightXMMOperand(current);
+      } else if (opcode == 0xD7) {
+        AppendToBuffer("pmovmskb %s,", NameOfCPURegister(regop));
+        current += PrintRightXMMOperand(current);
       } else if (opcode == 0x70) {
         AppendToBuffer("pshufd %s,", NameOfXMMRegister(regop));
         current += PrintRightXMMOperand(current);
@@ -1721,6 +1724,10 @@ int DisassemblerX64::TwoByteOpcodeInstruction(byte* data) {
           mnemonic = "ucomisd";
         } else if (opcode == 0x2F) {
           mnemonic = "comisd";
+        } else if (opcode == 0x74) {
+          mnemonic = "pcmpeqb";
+        } else if (opcode == 0x75) {
+          mnemonic = "pcmpeqw";
         } else if (opcode == 0x76) {
           mnemonic = "pcmpeqd";
         } else if (opcode == 0x62) {
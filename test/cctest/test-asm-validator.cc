@@ -2513,3 +2513,59 @@ TEST(NegateDouble) {
   }
   CHECK_FUNC_TYPES_END
 }
+
+TEST(ValidateFunctionBodiesSeparately) {
+  const char test_function[] =
+      "function Module(stdlib, foreign, buffer) {\n"
+      "  \"use asm\";\n"
+      "  function add(a, b) {\n"
+      "    a = a|0;\n"
+      "    b = b|0;\n"
+      "    return (a + b)|0;\n"
+      "  }\n"
+      "  function bad() {\n"
+      "    var x = 0;\n"
+      "    x = 1.5;\n"
+      "  }\n"
+      "  return { add: add, bad: bad };\n"
+      "}\n";
+  v8::V8::Initialize();
+  HandleAndZoneScope handles;
+  Zone* zone = handles.main_zone();
+  i::Isolate* isolate = CcTest::i_isolate();
+  i::Factory* factory = isolate->factory();
+  TypeCache const& cache = TypeCache::Get();
+
+  i::Handle<i::String> source_code =
+      factory->NewStringFromUtf8(i::CStrVector(test_function))
+          .ToHandleChecked();
+  i::Handle<i::Script> script = factory->NewScript(source_code);
+  i::ParseInfo info(zone, script);
+  i::Parser parser(&info);
+  info.set_global();
+  info.set_lazy(false);
+  info.set_allow_lazy_parsing(false);
+  info.set_toplevel(true);
+  CHECK(i::Compiler::ParseAndAnalyze(&info));
+
+  FunctionLiteral* root =
+      info.scope()->declarations()->at(0)->AsFunctionDeclaration()->fun();
+  AsmTyper typer(isolate, zone, *script, root);
+  CHECK(typer.ValidateModule());
+
+  ZoneList<Declaration*>* decls = root->scope()->declarations();
+  FunctionDeclaration* add = decls->at(0)->AsFunctionDeclaration();
+  FunctionDeclaration* bad = decls->at(1)->AsFunctionDeclaration();
+  Expression* add_return =
+      add->fun()->body()->last()->AsReturnStatement()->expression();
+
+  // The types of a body go to the bounds passed in, not to the module bounds.
+  AstTypeBounds add_bounds(zone);
+  CHECK(typer.ValidateFunction(add, &add_bounds));
+  CHECK(add_bounds.get(add_return).upper->Is(cache.kAsmSigned));
+  CHECK(Type::Any()->Is(typer.bounds()->get(add_return).upper));
+
+  AstTypeBounds bad_bounds(zone);
+  CHECK(!typer.ValidateFunction(bad, &bad_bounds));
+  CHECK(strlen(typer.error_message()) > 0);
+}
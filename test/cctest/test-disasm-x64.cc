@@ -455,7 +455,11 @@ TEST(DisasmX64) {
     __ psllq(xmm0, 6);
     __ psrlq(xmm0, 6);
 
+    __ pcmpeqb(xmm1, xmm0);
+    __ pcmpeqw(xmm9, xmm2);
     __ pcmpeqd(xmm1, xmm0);
+    __ pmovmskb(rax, xmm1);
+    __ pmovmskb(r11, xmm12);
 
     __ punpckldq(xmm1, xmm11);
     __ punpckldq(xmm5, Operand(rdx, 4));
@@ -607,7 +607,7 @@ static RegExpNode* Compile(const char* input, bool multiline, bool unicode,
   Handle<String> sample_subject =
       isolate->factory()->NewStringFromUtf8(CStrVector("")).ToHandleChecked();
   RegExpEngine::Compile(isolate, zone, &compile_data, flags, pattern,
-                        sample_subject, is_one_byte);
+                        sample_subject, is_one_byte, false);
   return compile_data.node;
 }
 
@@ -2030,3 +2030,42 @@ TEST(UncachedExternalString) {
   CompileRun("var re = /y(.)/; re.test('ab');");
   ExpectString("external.substring(1).match(re)[1]", "z");
 }
+
+static int regexp_exec_cache_hits = 0;
+
+static int* LookupRegExpExecCacheCounter(const char* name) {
+  if (strcmp(name, "c:V8.RegExpExecCacheHits") == 0) {
+    return &regexp_exec_cache_hits;
+  }
+  return NULL;
+}
+
+TEST(RegExpExecCacheHitAfterTierUp) {
+  i::FLAG_regexp_exec_cache = true;
+  i::FLAG_regexp_tier_up = true;
+  i::FLAG_regexp_tier_up_ticks = 1;
+  LocalContext env;
+  env->GetIsolate()->SetCounterFunction(LookupRegExpExecCacheCounter);
+  v8::HandleScope scope(env->GetIsolate());
+  CompileRun(
+      "var re = /\\/users\\/(\\d+)/;"
+      "function route(path) { return re.exec(path)[1]; }"
+      "route('/api/users/42');"
+      "route('/api/users/7');");
+
+  // The regexp runs as native code by now.
+  i::Handle<i::JSRegExp> re = i::Handle<i::JSRegExp>::cast(
+      v8::Utils::OpenHandle(*CompileRun("re")));
+  CHECK_EQ(i::JSRegExp::IRREGEXP, re->TypeTag());
+#ifndef V8_INTERPRETED_REGEXP
+  CHECK(re->DataAt(i::JSRegExp::kIrregexpLatin1CodeIndex)->IsCode());
+#endif
+
+  int hits = regexp_exec_cache_hits;
+  ExpectString(
+      "var id;"
+      "for (var i = 0; i < 10; i++) id = route('/api/users/42');"
+      "id",
+      "42");
+  CHECK_EQ(hits + 10, regexp_exec_cache_hits);
+}
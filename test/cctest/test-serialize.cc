@@ -44,6 +44,7 @@
 #include "src/snapshot/deserializer.h"
 #include "src/snapshot/natives.h"
 #include "src/snapshot/partial-serializer.h"
+#include "src/snapshot/snapshot-compression.h"
 #include "src/snapshot/snapshot.h"
 #include "src/snapshot/startup-serializer.h"
 #include "test/cctest/cctest.h"
@@ -654,6 +655,115 @@ TEST(CustomSnapshotDataBlob) {
 }
 
 
+TEST(SnapshotDataBlobChecksum) {
+  v8::StartupData data = v8::V8::CreateSnapshotDataBlob();
+  CHECK(Snapshot::VerifyChecksum(&data));
+  // Flip a bit in the startup snapshot payload.
+  const_cast<char*>(data.data)[data.raw_size / 2] ^= 1;
+  CHECK(!Snapshot::VerifyChecksum(&data));
+  delete[] data.data;
+}
+
+TEST(DefaultSnapshotChecksum) {
+  // The default blob is verified in the background and the result is cached.
+  CHECK(v8::V8::VerifySnapshotChecksum());
+  CHECK(v8::V8::VerifySnapshotChecksum());
+}
+
+TEST(SnapshotCompressionRoundTrip) {
+  // Repetitive data with overlapping matches, long literal runs and long
+  // matches, followed by a tail of incompressible bytes.
+  List<byte> input;
+  for (int i = 0; i < 1000; i++) input.Add(static_cast<byte>(i % 7));
+  for (int i = 0; i < 300; i++) input.Add(static_cast<byte>(i * 31 + 5));
+  for (int i = 0; i < 2000; i++) input.Add(0);
+  for (int i = 0; i < 3; i++) input.Add(static_cast<byte>(i + 1));
+
+  List<byte> compressed;
+  SnapshotCompression::Compress(input.ToConstVector(), &compressed);
+  CHECK_LT(compressed.length(), input.length());
+
+  List<byte> output;
+  output.AddBlock(0, input.length());
+  CHECK(SnapshotCompression::Decompress(compressed.ToConstVector(),
+                                        output.ToVector()));
+  for (int i = 0; i < input.length(); i++) CHECK_EQ(input[i], output[i]);
+
+  // Output of the wrong size and truncated input are rejected.
+  CHECK(!SnapshotCompression::Decompress(compressed.ToConstVector(),
+                                         output.ToVector().SubVector(1, 100)));
+  CHECK(!SnapshotCompression::Decompress(
+      compressed.ToConstVector().SubVector(0, compressed.length() - 1),
+      output.ToVector()));
+}
+
+TEST(CompressedSnapshotDataBlob) {
+  DisableTurbofan();
+  const char* source = "function f() { return 42; }";
+
+  v8::StartupData uncompressed = v8::V8::CreateSnapshotDataBlob(source);
+  FLAG_compress_snapshot = true;
+  v8::StartupData data = v8::V8::CreateSnapshotDataBlob(source);
+  FLAG_compress_snapshot = false;
+  CHECK_LT(data.raw_size, uncompressed.raw_size);
+  CHECK(Snapshot::VerifyChecksum(&data));
+  delete[] uncompressed.data;
+
+  v8::Isolate::CreateParams params;
+  params.snapshot_blob = &data;
+  params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(params);
+  {
+    v8::Isolate::Scope i_scope(isolate);
+    v8::HandleScope h_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    delete[] data.data;  // We can dispose of the snapshot blob now.
+    v8::Context::Scope c_scope(context);
+    v8::Maybe<int32_t> result =
+        CompileRun("f()")->Int32Value(isolate->GetCurrentContext());
+    CHECK_EQ(42, result.FromJust());
+  }
+  isolate->Dispose();
+}
+
+TEST(SnapshotDuplicateMap) {
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Factory* factory = isolate->factory();
+  HandleScope scope(isolate);
+
+  Handle<String> internalized = factory->InternalizeUtf8String("duplicate");
+  Handle<String> string1 = factory->NewStringFromAsciiChecked("duplicate");
+  Handle<String> string2 = factory->NewStringFromAsciiChecked("duplicate");
+  Handle<String> string3 = factory->NewStringFromAsciiChecked("different");
+
+  Handle<FixedArray> elements = factory->NewFixedArray(2);
+  elements->set(0, Smi::FromInt(42));
+  elements->set(1, *internalized);
+  Handle<Map> cow_map = factory->fixed_cow_array_map();
+  Handle<FixedArray> array1 = factory->CopyFixedArrayWithMap(elements, cow_map);
+  Handle<FixedArray> array2 = factory->CopyFixedArrayWithMap(elements, cow_map);
+  elements->set(0, Smi::FromInt(43));
+  Handle<FixedArray> array3 = factory->CopyFixedArrayWithMap(elements, cow_map);
+
+  DisallowHeapAllocation no_gc;
+  CHECK(!StartupSerializer::DuplicateMap::CanBeDeduplicated(*internalized));
+  CHECK(!StartupSerializer::DuplicateMap::CanBeDeduplicated(*elements));
+  CHECK(StartupSerializer::DuplicateMap::CanBeDeduplicated(*string1));
+  CHECK(StartupSerializer::DuplicateMap::CanBeDeduplicated(*array1));
+
+  // Later copies with equal contents map to the first one; different
+  // contents are recorded as new entries.
+  StartupSerializer::DuplicateMap map;
+  CHECK_NULL(map.LookupOrInsert(*string1));
+  CHECK_EQ(*string1, map.LookupOrInsert(*string2));
+  CHECK_NULL(map.LookupOrInsert(*string3));
+  CHECK_NULL(map.LookupOrInsert(*array1));
+  CHECK_EQ(*array1, map.LookupOrInsert(*array2));
+  CHECK_NULL(map.LookupOrInsert(*array3));
+  CHECK_NULL(map.LookupOrInsert(*string1));
+}
+
 static void SerializationFunctionTemplate(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
   args.GetReturnValue().Set(args[0]);
@@ -1585,6 +1695,215 @@ TEST(CodeSerializerBitFlip) {
   isolate2->Dispose();
 }
 
+static bool ConsumeCacheIsRejected(const char* source,
+                                   v8::ScriptCompiler::CachedData* cache) {
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  bool rejected;
+  {
+    v8::Isolate::Scope iscope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::String> source_str = v8_str(source);
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source source(source_str, origin, cache);
+    v8::ScriptCompiler::CompileUnboundScript(
+        isolate, &source, v8::ScriptCompiler::kConsumeCodeCache)
+        .ToLocalChecked();
+    rejected = cache->rejected;
+  }
+  isolate->Dispose();
+  return rejected;
+}
+
+TEST(CodeSerializerVerifyCachedData) {
+  FLAG_serialize_toplevel = true;
+
+  const char* source = "function f() { return 'abc'; }; f() + 'def'";
+  v8::ScriptCompiler::CachedData* cache = ProduceCache(source);
+  CHECK(!cache->checksum_verified());
+
+  v8::ScriptCompiler::VerifyCachedDataTask* task =
+      v8::ScriptCompiler::StartVerifyingCachedData(cache);
+  task->Run();
+  delete task;
+  CHECK(cache->checksum_verified());
+  CHECK(!ConsumeCacheIsRejected(source, cache));
+}
+
+TEST(CodeSerializerVerifyCachedDataBitFlip) {
+  FLAG_serialize_toplevel = true;
+
+  const char* source = "function f() { return 'abc'; }; f() + 'def'";
+  v8::ScriptCompiler::CachedData* cache = ProduceCache(source);
+
+  // Random bit flip.
+  const_cast<uint8_t*>(cache->data)[337] ^= 0x40;
+
+  v8::ScriptCompiler::VerifyCachedDataTask* task =
+      v8::ScriptCompiler::StartVerifyingCachedData(cache);
+  task->Run();
+  delete task;
+  CHECK(!cache->checksum_verified());
+  CHECK(ConsumeCacheIsRejected(source, cache));
+}
+
+static v8::ScriptCompiler::CachedData* ProduceWarmCache(const char* source,
+                                                        int max_size) {
+  v8::ScriptCompiler::CachedData* cache;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate1 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate1);
+    v8::HandleScope scope(isolate1);
+    v8::Local<v8::Context> context = v8::Context::New(isolate1);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::String> source_str = v8_str(source);
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source source(source_str, origin);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate1, &source, v8::ScriptCompiler::kProduceCodeCache)
+            .ToLocalChecked();
+    script->BindToCurrentContext()
+        ->Run(isolate1->GetCurrentContext())
+        .ToLocalChecked();
+    cache = v8::ScriptCompiler::CreateCodeCache(script, max_size);
+    CHECK(cache);
+    // The lazily compiled function is included unless it is over budget.
+    CHECK_EQ(max_size == 0, cache->length > source.GetCachedData()->length);
+  }
+  isolate1->Dispose();
+  return cache;
+}
+
+static bool HasCompiledInnerFunction(v8::Local<v8::UnboundScript> script) {
+  Handle<SharedFunctionInfo> toplevel =
+      Handle<SharedFunctionInfo>::cast(v8::Utils::OpenHandle(*script));
+  WeakFixedArray::Iterator iterator(
+      Script::cast(toplevel->script())->shared_function_infos());
+  SharedFunctionInfo* shared;
+  while ((shared = iterator.Next<SharedFunctionInfo>())) {
+    if (!shared->is_toplevel() && shared->is_compiled()) return true;
+  }
+  return false;
+}
+
+static void CheckWarmCache(const char* source, int max_size) {
+  v8::ScriptCompiler::CachedData* cache = ProduceWarmCache(source, max_size);
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::String> source_str = v8_str(source);
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source source(source_str, origin, cache);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate2, &source, v8::ScriptCompiler::kConsumeCodeCache)
+            .ToLocalChecked();
+    CHECK(!cache->rejected);
+    CHECK_EQ(max_size == 0, HasCompiledInnerFunction(script));
+    v8::Local<v8::Value> result = script->BindToCurrentContext()
+                                      ->Run(isolate2->GetCurrentContext())
+                                      .ToLocalChecked();
+    CHECK(result->ToString(isolate2->GetCurrentContext())
+              .ToLocalChecked()
+              ->Equals(isolate2->GetCurrentContext(), v8_str("abcdef"))
+              .FromJust());
+  }
+  isolate2->Dispose();
+}
+
+TEST(CodeSerializerCreateCodeCacheAfterExecution) {
+  FLAG_serialize_toplevel = true;
+  CheckWarmCache("function f() { return 'abc'; }; f() + 'def'", 0);
+}
+
+TEST(CodeSerializerCreateCodeCacheSizeBudget) {
+  FLAG_serialize_toplevel = true;
+  CheckWarmCache("function f() { return 'abc'; }; f() + 'def'", 1);
+}
+
+static void CompileInNewIsolate(const char* source, bool expect_shared,
+                                const char* source_map_url = NULL) {
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Value> url;
+    if (source_map_url != NULL) url = v8_str(source_map_url);
+    v8::ScriptOrigin origin(v8_str("test"), v8::Local<v8::Integer>(),
+                            v8::Local<v8::Integer>(), v8::Local<v8::Boolean>(),
+                            v8::Local<v8::Integer>(), v8::Local<v8::Boolean>(),
+                            url);
+    v8::ScriptCompiler::Source script_source(v8_str(source), origin);
+    v8::Local<v8::UnboundScript> script;
+    {
+      v8::base::SmartPointer<DisallowCompilation> no_compile;
+      if (expect_shared) {
+        no_compile.Reset(
+            new DisallowCompilation(reinterpret_cast<Isolate*>(isolate)));
+      }
+      script = v8::ScriptCompiler::CompileUnboundScript(isolate, &script_source)
+                   .ToLocalChecked();
+    }
+    Handle<SharedFunctionInfo> shared =
+        Handle<SharedFunctionInfo>::cast(v8::Utils::OpenHandle(*script));
+    CHECK_EQ(expect_shared, shared->deserialized());
+    v8::Local<v8::Value> result =
+        script->BindToCurrentContext()->Run(context).ToLocalChecked();
+    CHECK(result->ToString(context).ToLocalChecked()->Equals(
+        context, v8_str("abcdef")).FromJust());
+  }
+  isolate->Dispose();
+}
+
+TEST(SharedCompilationCache) {
+  FLAG_serialize_toplevel = true;
+  FLAG_shared_compilation_cache_size = 1024;
+
+  // Isolates hash strings with different seeds, which must not matter.
+  const char* source = "function f() { return 'abc'; }; f() + 'def'";
+  CompileInNewIsolate(source, false);
+  CHECK_LT(0u, SharedCompilationCache::Size());
+  CompileInNewIsolate(source, true);
+
+  // The source map URL is part of the deserialized script.
+  CompileInNewIsolate(source, false, "a.map");
+  CompileInNewIsolate(source, true, "a.map");
+  CompileInNewIsolate(source, false, "b.map");
+  CompileInNewIsolate(source, true);
+
+  // Scripts are matched on their full source.
+  const char* other = "function f() { return 'abc'; }; f() + 'd' + 'ef'";
+  CompileInNewIsolate(other, false);
+  CompileInNewIsolate(other, true);
+
+  SharedCompilationCache::Clear();
+  CHECK_EQ(0u, SharedCompilationCache::Size());
+  CompileInNewIsolate(source, false);
+
+  SharedCompilationCache::Clear();
+  FLAG_shared_compilation_cache_size = 0;
+}
+
 TEST(CodeSerializerWithHarmonyScoping) {
   FLAG_serialize_toplevel = true;
 
@@ -1947,6 +2266,132 @@ TEST(SnapshotCreatorMultipleContexts) {
   delete[] blob.data;
 }
 
+static bool HasMonomorphicCallFeedback(Handle<JSFunction> function) {
+  Handle<TypeFeedbackVector> vector(function->feedback_vector());
+  TypeFeedbackMetadataIterator iter(vector->metadata());
+  while (iter.HasNext()) {
+    FeedbackVectorSlot slot = iter.Next();
+    if (iter.kind() != FeedbackVectorSlotKind::CALL_IC) continue;
+    CallICNexus nexus(vector, slot);
+    if (nexus.StateFromFeedback() == MONOMORPHIC) return true;
+  }
+  return false;
+}
+
+TEST(SnapshotCreatorKeepTypeFeedback) {
+  DisableTurbofan();
+  const char* source =
+      "function callee() { return 1; }"
+      "function caller() { return callee(); }"
+      "for (var i = 0; i < 10; i++) caller();";
+  v8::StartupData blobs[2];
+  v8::SnapshotCreator::FunctionCodeHandling handlings[2] = {
+      v8::SnapshotCreator::FunctionCodeHandling::kKeep,
+      v8::SnapshotCreator::FunctionCodeHandling::kKeepWithTypeFeedback};
+  for (int i = 0; i < 2; i++) {
+    v8::SnapshotCreator creator;
+    v8::Isolate* isolate = creator.GetIsolate();
+    {
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      CompileRun(source);
+      Handle<JSFunction> caller = Handle<JSFunction>::cast(
+          v8::Utils::OpenHandle(*CompileRun("caller")));
+      CHECK(HasMonomorphicCallFeedback(caller));
+      CHECK_EQ(0, creator.AddContext(context));
+    }
+    blobs[i] = creator.CreateBlob(handlings[i]);
+  }
+
+  for (int i = 0; i < 2; i++) {
+    v8::Isolate::CreateParams params;
+    params.snapshot_blob = &blobs[i];
+    params.array_buffer_allocator = CcTest::array_buffer_allocator();
+    v8::Isolate* isolate = v8::Isolate::New(params);
+    {
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      Handle<JSFunction> caller = Handle<JSFunction>::cast(
+          v8::Utils::OpenHandle(*CompileRun("caller")));
+      // Only kKeepWithTypeFeedback preserves the call target.
+      CHECK_EQ(i == 1, HasMonomorphicCallFeedback(caller));
+      ExpectInt32("caller()", 1);
+    }
+    isolate->Dispose();
+    delete[] blobs[i].data;
+  }
+}
+
+static bool IsFunctionCompiled(const char* name) {
+  Handle<JSFunction> function =
+      Handle<JSFunction>::cast(v8::Utils::OpenHandle(*CompileRun(name)));
+  return function->shared()->is_compiled();
+}
+
+TEST(SnapshotCreatorCompileEagerly) {
+  DisableTurbofan();
+  const char* source =
+      "function hot() {"
+      "  function inner() { return 1; }"
+      "  return inner;"
+      "}"
+      "function cold() { return 2; }"
+      "var anonymous = (function() { return function() { return 3; }; })();";
+  // The empty name must not match anonymous functions.
+  const char* cold_functions[] = {"cold", ""};
+  v8::StartupData blob;
+  {
+    v8::SnapshotCreator creator;
+    v8::Isolate* isolate = creator.GetIsolate();
+    {
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      v8::ScriptCompiler::Source script_source(v8_str(source));
+      v8::Local<v8::UnboundScript> script =
+          creator.CompileEagerly(&script_source, 2, cold_functions)
+              .ToLocalChecked();
+      script->BindToCurrentContext()->Run(context).ToLocalChecked();
+      CHECK(IsFunctionCompiled("hot"));
+      CHECK(!IsFunctionCompiled("cold"));
+      CHECK(IsFunctionCompiled("anonymous"));
+      CHECK_EQ(0, creator.AddContext(context));
+    }
+    blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+  }
+
+  v8::Isolate::CreateParams params;
+  params.snapshot_blob = &blob;
+  params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(params);
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    CHECK(IsFunctionCompiled("hot"));
+    CHECK(!IsFunctionCompiled("cold"));
+    v8::Local<v8::Function> hot = CompileRun("hot").As<v8::Function>();
+    {
+      // The inner function does not need to be compiled either.
+      DisallowCompilation no_compile(reinterpret_cast<Isolate*>(isolate));
+      v8::Local<v8::Value> inner =
+          hot->Call(context, context->Global(), 0, nullptr).ToLocalChecked();
+      v8::Local<v8::Value> result =
+          inner.As<v8::Function>()
+              ->Call(context, context->Global(), 0, nullptr)
+              .ToLocalChecked();
+      CHECK_EQ(1, result->Int32Value(context).FromJust());
+    }
+    ExpectInt32("cold()", 2);
+  }
+  isolate->Dispose();
+  delete[] blob.data;
+}
+
 static void SerializedCallback(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
   args.GetReturnValue().Set(v8_num(42));
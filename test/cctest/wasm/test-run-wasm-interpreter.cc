@@ -284,6 +284,44 @@ TEST(Breakpoint_I32And_disable) {
   }
 }
 
+TEST(Breakpoint_I32Sub_loop) {
+  static const int kLocalsDeclSize = 1;
+  static const int kNumBreakpoints = 1;
+  // while (p0) p0 = p0 - 1; return 99
+  byte code[] = {
+      WASM_WHILE(WASM_GET_LOCAL(0),
+                 WASM_SET_LOCAL(0, WASM_I32_SUB(WASM_GET_LOCAL(0), WASM_I8(1)))),
+      WASM_I8(99)};
+  SmartArrayPointer<int> offsets =
+      Find(code, sizeof(code), kNumBreakpoints, kExprI32Sub);
+
+  WasmRunner<int32_t> r(kExecuteInterpreted, MachineType::Uint32());
+
+  r.Build(code, code + arraysize(code));
+
+  WasmInterpreter* interpreter = r.interpreter();
+  WasmInterpreter::Thread* thread = interpreter->GetThread(0);
+  interpreter->SetBreakpoint(r.function(), kLocalsDeclSize + offsets[0], true);
+
+  for (uint32_t iterations = 0; iterations < 5; iterations++) {
+    thread->Reset();
+    WasmVal args[] = {WasmVal(iterations)};
+    thread->PushFrame(r.function(), args);
+
+    // The loop body hits the breakpoint once per iteration.
+    for (uint32_t i = 0; i < iterations; i++) {
+      thread->Run();
+      CHECK_EQ(WasmInterpreter::PAUSED, thread->state());
+      CHECK_EQ(kLocalsDeclSize + offsets[0], thread->GetBreakpointPc());
+    }
+
+    thread->Run();  // run to completion
+
+    CHECK_EQ(WasmInterpreter::FINISHED, thread->state());
+    CHECK_EQ(99, thread->GetReturnValue().to<int32_t>());
+  }
+}
+
 }  // namespace wasm
 }  // namespace internal
 }  // namespace v8
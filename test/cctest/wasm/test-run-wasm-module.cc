@@ -5,7 +5,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "src/snapshot/code-serializer.h"
 #include "src/wasm/encoder.h"
+#include "src/wasm/module-decoder.h"
 #include "src/wasm/wasm-js.h"
 #include "src/wasm/wasm-macro-gen.h"
 #include "src/wasm/wasm-module.h"
@@ -33,6 +35,50 @@ void TestModule(Zone* zone, WasmModuleBuilder* builder,
   CHECK_EQ(expected_result, result);
 }
 
+// Runs the module once for each of a few chunk sizes, compiling it while
+// streaming it in.
+void TestStreamedModule(Zone* zone, WasmModuleBuilder* builder,
+                        int32_t expected_result) {
+  ZoneBuffer buffer(zone);
+  builder->WriteTo(buffer);
+
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  WasmJs::InstallWasmFunctionMap(isolate, isolate->native_context());
+  size_t chunk_sizes[] = {1, 3, 16, buffer.size()};
+  for (size_t chunk_size : chunk_sizes) {
+    int32_t result = testing::CompileAndRunStreamedWasmModule(
+        isolate, buffer.begin(), buffer.end(), chunk_size);
+    CHECK_EQ(expected_result, result);
+  }
+}
+
+// Streams the module bytes in chunks of a few sizes and checks that each
+// attempt fails with an error. ~StreamingCompiler checks that no compilation
+// unit or background task is left behind.
+void TestStreamedModuleFails(const std::vector<byte>& bytes) {
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  WasmJs::InstallWasmFunctionMap(isolate, isolate->native_context());
+  size_t chunk_sizes[] = {1, 3, 16, bytes.size()};
+  for (size_t chunk_size : chunk_sizes) {
+    int32_t result = testing::CompileAndRunStreamedWasmModule(
+        isolate, bytes.data(), bytes.data() + bytes.size(), chunk_size);
+    CHECK_EQ(-1, result);
+    CHECK(isolate->has_scheduled_exception());
+    isolate->clear_scheduled_exception();
+  }
+}
+
+// Runs the module with its functions compiled on their first call.
+void TestLazyModule(Zone* zone, WasmModuleBuilder* builder,
+                    int32_t expected_result) {
+  bool lazy_compilation = FLAG_wasm_lazy_compilation;
+  FLAG_wasm_lazy_compilation = true;
+  TestModule(zone, builder, expected_result);
+  FLAG_wasm_lazy_compilation = lazy_compilation;
+}
+
 void ExportAsMain(WasmFunctionBuilder* f) {
   static const char kMainName[] = "main";
   f->SetExported();
@@ -81,6 +127,259 @@ TEST(Run_WasmModule_CallAdd) {
   TestModule(&zone, builder, 99);
 }
 
+TEST(Run_WasmModule_Streamed_CallAdd) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  TestSignatures sigs;
+
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+
+  uint16_t f1_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f1_index);
+  f->SetSignature(sigs.i_ii());
+  byte code1[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1))};
+  f->EmitCode(code1, sizeof(code1));
+
+  uint16_t f2_index = builder->AddFunction();
+  f = builder->FunctionAt(f2_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  byte code2[] = {WASM_CALL_FUNCTION2(
+      f1_index, WASM_LOAD_MEM(MachineType::Int32(), WASM_I8(16)), WASM_I8(22))};
+  f->EmitCode(code2, sizeof(code2));
+
+  byte data[] = {77, 0, 0, 0};
+  builder->AddDataSegment(
+      new (&zone) WasmDataSegmentEncoder(&zone, data, sizeof(data), 16));
+  TestStreamedModule(&zone, builder, 99);
+}
+
+TEST(Run_WasmModule_Streamed_Global) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  TestSignatures sigs;
+
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+  uint32_t global = builder->AddGlobal(MachineType::Int32(), 0);
+  uint16_t f_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  byte code[] = {WASM_STORE_GLOBAL(global, WASM_I32V_1(56)),
+                 WASM_I32_ADD(WASM_LOAD_GLOBAL(global), WASM_I8(41))};
+  f->EmitCode(code, sizeof(code));
+  TestStreamedModule(&zone, builder, 97);
+}
+
+namespace {
+WasmModuleBuilder* BuildCallAddModule(Zone* zone) {
+  TestSignatures sigs;
+  WasmModuleBuilder* builder = new (zone) WasmModuleBuilder(zone);
+
+  uint16_t f1_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f1_index);
+  f->SetSignature(sigs.i_ii());
+  byte code1[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1))};
+  f->EmitCode(code1, sizeof(code1));
+
+  uint16_t f2_index = builder->AddFunction();
+  f = builder->FunctionAt(f2_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  byte code2[] = {WASM_CALL_FUNCTION2(f1_index, WASM_I8(77), WASM_I8(22))};
+  f->EmitCode(code2, sizeof(code2));
+  return builder;
+}
+}  // namespace
+
+TEST(Run_WasmModule_Streamed_LargeModule) {
+  // The data segment is larger than the initial streaming buffer, which thus
+  // moves while the functions are compiled.
+  static const size_t kDataSize = 256 * KB;
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  WasmModuleBuilder* builder = BuildCallAddModule(&zone);
+  std::vector<byte> data(kDataSize, 0);
+  builder->AddDataSegment(
+      new (&zone) WasmDataSegmentEncoder(&zone, data.data(), kDataSize, 0));
+  TestStreamedModule(&zone, builder, 99);
+}
+
+TEST(Run_WasmModule_Streamed_Truncated) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  ZoneBuffer buffer(&zone);
+  BuildCallAddModule(&zone)->WriteTo(buffer);
+
+  // Cut the module in the middle of the last function body, after the other
+  // functions have been queued for compilation.
+  FunctionOffsetsResult offsets =
+      DecodeWasmFunctionOffsets(buffer.begin(), buffer.end());
+  CHECK(offsets.ok());
+  const std::pair<int, int>& last = offsets.val.back();
+  std::vector<byte> bytes(buffer.begin(),
+                          buffer.begin() + last.first + last.second / 2);
+  TestStreamedModuleFails(bytes);
+}
+
+TEST(Run_WasmModule_Streamed_CorruptFunctionBody) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  ZoneBuffer buffer(&zone);
+  BuildCallAddModule(&zone)->WriteTo(buffer);
+
+  // Replace the last opcode of the first function body by an invalid one, so
+  // that its compilation fails while the rest of the module streams in.
+  FunctionOffsetsResult offsets =
+      DecodeWasmFunctionOffsets(buffer.begin(), buffer.end());
+  CHECK(offsets.ok());
+  const std::pair<int, int>& first = offsets.val.front();
+  std::vector<byte> bytes(buffer.begin(), buffer.end());
+  bytes[first.first + first.second - 1] = 0xff;
+  TestStreamedModuleFails(bytes);
+}
+
+TEST(Run_WasmModule_CodeCache_CallAdd) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  ZoneBuffer buffer(&zone);
+  BuildCallAddModule(&zone)->WriteTo(buffer);
+
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  WasmJs::InstallWasmFunctionMap(isolate, isolate->native_context());
+  CHECK_EQ(99, testing::CompileAndRunCachedWasmModule(isolate, buffer.begin(),
+                                                      buffer.end()));
+}
+
+TEST(Run_WasmModule_CodeCache_RejectsOtherModule) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  ZoneBuffer buffer(&zone);
+  BuildCallAddModule(&zone)->WriteTo(buffer);
+
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  ModuleResult result = DecodeWasmModule(isolate, &zone, buffer.begin(),
+                                         buffer.end(), false, kWasmOrigin);
+  CHECK(result.ok());
+  std::unique_ptr<const WasmModule> module(result.val);
+
+  int length = static_cast<int>(buffer.size());
+  Vector<const byte> module_bytes(buffer.begin(), length);
+  ScriptData* data = WasmCodeSerializer::Serialize(
+      isolate, module->CompileFunctions(isolate), module_bytes);
+  CHECK(!WasmCodeSerializer::Deserialize(isolate, data, module_bytes)
+             .is_null());
+
+  // Flip a bit in the last byte of the module.
+  Vector<byte> other_bytes = Vector<byte>::New(length);
+  MemCopy(other_bytes.start(), buffer.begin(), length);
+  other_bytes[length - 1] ^= 1;
+  CHECK(WasmCodeSerializer::Deserialize(
+            isolate, data, Vector<const byte>(other_bytes.start(), length))
+            .is_null());
+  other_bytes.Dispose();
+  delete data;
+}
+
+TEST(Run_WasmModule_CodeCache_CallIndirect) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  TestSignatures sigs;
+
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+  // The signature ids in the cached code must match the function table of
+  // the module they are loaded for, whatever signatures were seen before.
+  uint32_t f_ff = builder->AddSignature(sigs.f_ff());
+  uint32_t i_ii = builder->AddSignature(sigs.i_ii());
+  CHECK_NE(f_ff, i_ii);
+
+  uint16_t add_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(add_index);
+  f->SetSignature(sigs.i_ii());
+  byte add_code[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1))};
+  f->EmitCode(add_code, sizeof(add_code));
+
+  uint16_t sub_index = builder->AddFunction();
+  f = builder->FunctionAt(sub_index);
+  f->SetSignature(sigs.i_ii());
+  byte sub_code[] = {WASM_I32_SUB(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1))};
+  f->EmitCode(sub_code, sizeof(sub_code));
+
+  builder->AddIndirectFunction(add_index);
+  builder->AddIndirectFunction(sub_index);
+
+  uint16_t main_index = builder->AddFunction();
+  f = builder->FunctionAt(main_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  byte main_code[] = {WASM_I32_ADD(
+      WASM_CALL_INDIRECT2(i_ii, WASM_I8(0), WASM_I8(77), WASM_I8(22)),
+      WASM_CALL_INDIRECT2(i_ii, WASM_I8(1), WASM_I8(10), WASM_I8(3)))};
+  f->EmitCode(main_code, sizeof(main_code));
+
+  ZoneBuffer buffer(&zone);
+  builder->WriteTo(buffer);
+
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  WasmJs::InstallWasmFunctionMap(isolate, isolate->native_context());
+  CHECK_EQ(106, testing::CompileAndRunCachedWasmModule(isolate, buffer.begin(),
+                                                       buffer.end()));
+}
+
+TEST(Run_WasmModule_Lazy_CallAdd) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  TestSignatures sigs;
+
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+
+  uint16_t f1_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f1_index);
+  f->SetSignature(sigs.i_ii());
+  byte code1[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1))};
+  f->EmitCode(code1, sizeof(code1));
+
+  uint16_t f2_index = builder->AddFunction();
+  f = builder->FunctionAt(f2_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  // The first call compiles {f1} through its stub, the second one calls the
+  // compiled code directly.
+  byte code2[] = {WASM_CALL_FUNCTION2(
+      f1_index, WASM_CALL_FUNCTION2(f1_index, WASM_I8(77), WASM_I8(0)),
+      WASM_I8(22))};
+  f->EmitCode(code2, sizeof(code2));
+  TestLazyModule(&zone, builder, 99);
+}
+
+TEST(Run_WasmModule_Lazy_Global) {
+  v8::base::AccountingAllocator allocator;
+  Zone zone(&allocator);
+  TestSignatures sigs;
+
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+  uint32_t global1 = builder->AddGlobal(MachineType::Int32(), 0);
+  uint32_t global2 = builder->AddGlobal(MachineType::Int32(), 0);
+  uint16_t f1_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f1_index);
+  f->SetSignature(sigs.i_v());
+  byte code1[] = {
+      WASM_I32_ADD(WASM_LOAD_GLOBAL(global1), WASM_LOAD_GLOBAL(global2))};
+  f->EmitCode(code1, sizeof(code1));
+  uint16_t f2_index = builder->AddFunction();
+  f = builder->FunctionAt(f2_index);
+  f->SetSignature(sigs.i_v());
+  ExportAsMain(f);
+  byte code2[] = {WASM_STORE_GLOBAL(global1, WASM_I32V_1(56)),
+                  WASM_STORE_GLOBAL(global2, WASM_I32V_1(41)),
+                  WASM_RETURN1(WASM_CALL_FUNCTION0(f1_index))};
+  f->EmitCode(code2, sizeof(code2));
+  TestLazyModule(&zone, builder, 97);
+}
+
 TEST(Run_WasmModule_ReadLoadedDataSegment) {
   static const byte kDataSegmentDest0 = 12;
   v8::base::AccountingAllocator allocator;
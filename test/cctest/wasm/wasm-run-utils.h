@@ -21,6 +21,7 @@
 #include "src/compiler/zone-pool.h"
 
 #include "src/wasm/ast-decoder.h"
+#include "src/wasm/signature-map.h"
 #include "src/wasm/wasm-interpreter.h"
 #include "src/wasm/wasm-js.h"
 #include "src/wasm/wasm-macro-gen.h"
@@ -119,6 +120,7 @@ class TestingModule : public ModuleEnv {
 
   byte AddSignature(FunctionSig* sig) {
     module_.signatures.push_back(sig);
+    module_.signature_map.FindOrInsert(sig);
     size_t size = module->signatures.size();
     CHECK(size < 127);
     return static_cast<byte>(size - 1);
@@ -209,8 +211,8 @@ class TestingModule : public ModuleEnv {
   }
 
   void AddIndirectFunctionTable(int* functions, int table_size) {
-    Handle<FixedArray> fixed =
-        isolate_->factory()->NewFixedArray(2 * table_size);
+    Handle<FixedArray> fixed = isolate_->factory()->NewFixedArray(
+        WasmModule::kFunctionTableEntrySize * table_size);
     instance->function_table = fixed;
     DCHECK_EQ(0u, module->function_table.size());
     for (int i = 0; i < table_size; i++) {
@@ -224,9 +226,13 @@ class TestingModule : public ModuleEnv {
     for (int i = 0; i < table_size; i++) {
       int function_index = module->function_table[i];
       const WasmFunction* function = &module->functions[function_index];
-      instance->function_table->set(i, Smi::FromInt(function->sig_index));
-      instance->function_table->set(i + table_size,
-                                    *instance->function_code[function_index]);
+      int entry = i * WasmModule::kFunctionTableEntrySize;
+      instance->function_table->set(
+          entry + WasmModule::kFunctionTableSignatureOffset,
+          Smi::FromInt(module->signature_map.Find(function->sig)));
+      instance->function_table->set(
+          entry + WasmModule::kFunctionTableCodeOffset,
+          *instance->function_code[function_index]);
     }
   }
   WasmFunction* GetFunctionAt(int index) { return &module_.functions[index]; }
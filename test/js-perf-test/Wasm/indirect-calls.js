@@ -0,0 +1,78 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+new BenchmarkSuite('IndirectCalls', [1000], [
+  new Benchmark('IndirectCalls-Loop', false, false, 0,
+                IndirectCalls, IndirectCallsSetup, IndirectCallsTearDown),
+]);
+
+var kCallsPerRun = 10000;
+var module;
+var result;
+var expected;
+
+function IndirectCallsSetup() {
+  var builder = new WasmModuleBuilder();
+
+  // Four callees, each declaring its own copy of the signature, as
+  // separately compiled C++ virtual methods would.
+  builder.addFunction("add", kSig_i_i)
+    .addBody([kExprGetLocal, 0, kExprI8Const, 3, kExprI32Add]);
+  builder.addFunction("sub", kSig_i_i)
+    .addBody([kExprGetLocal, 0, kExprI8Const, 1, kExprI32Sub]);
+  builder.addFunction("xor", kSig_i_i)
+    .addBody([kExprGetLocal, 0, kExprI8Const, 5, kExprI32Xor]);
+  builder.addFunction("shl", kSig_i_i)
+    .addBody([kExprGetLocal, 0, kExprI8Const, 1, kExprI32Shl]);
+  builder.appendToTable([0, 1, 2, 3]);
+
+  // main(n): calls the table entry n & 3 with the accumulated value until n
+  // is 0.
+  var sig_index = builder.addType(kSig_i_i);
+  builder.addFunction("main", kSig_i_i)
+    .addLocals({i32_count: 1})
+    .addBody([
+      kExprLoop,
+        kExprGetLocal, 0,
+        kExprIf,
+              kExprGetLocal, 0,
+              kExprI8Const, 3,
+            kExprI32And,
+            kExprGetLocal, 1,
+          kExprCallIndirect, kArity1, sig_index,
+          kExprSetLocal, 1,
+              kExprGetLocal, 0,
+              kExprI8Const, 1,
+            kExprI32Sub,
+          kExprSetLocal, 0,
+        kExprBr, kArity1, 1,
+        kExprEnd,
+      kExprEnd,
+      kExprGetLocal, 1
+    ])
+    .exportFunc();
+
+  module = builder.instantiate();
+  result = undefined;
+
+  var callees = [
+    function(x) { return (x + 3) | 0; },
+    function(x) { return (x - 1) | 0; },
+    function(x) { return x ^ 5; },
+    function(x) { return x << 1; }
+  ];
+  expected = 0;
+  for (var n = kCallsPerRun; n != 0; n--) {
+    expected = callees[n & 3](expected);
+  }
+}
+
+function IndirectCalls() {
+  result = module.exports.main(kCallsPerRun);
+}
+
+function IndirectCallsTearDown() {
+  module = undefined;
+  return result === expected;
+}
@@ -0,0 +1,50 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+new BenchmarkSuite('Verify', [1000], [
+  new Benchmark('Verify-LargeModule', false, false, 0,
+                Verify, VerifySetup, VerifyTearDown),
+]);
+
+var kNumFunctions = 2000;
+var kLoopsPerFunction = 20;
+var buffer;
+
+function VerifySetup() {
+  // A synthetic module of many functions with sizeable bodies, which is
+  // dominated by the verification of the function bodies.
+  var builder = new WasmModuleBuilder();
+  var body = [];
+  for (var i = 0; i < kLoopsPerFunction; i++) {
+    body.push(kExprLoop,
+                kExprGetLocal, 0,
+                kExprIf,
+                      kExprGetLocal, 1,
+                      kExprGetLocal, 0,
+                    kExprI32Add,
+                  kExprSetLocal, 1,
+                      kExprGetLocal, 0,
+                      kExprI8Const, 1,
+                    kExprI32Sub,
+                  kExprSetLocal, 0,
+                kExprBr, kArity0, 1,
+                kExprEnd,
+              kExprEnd);
+  }
+  body.push(kExprGetLocal, 1);
+  for (var i = 0; i < kNumFunctions; i++) {
+    builder.addFunction("f" + i, kSig_i_i)
+      .addLocals({i32_count: 1})
+      .addBody(body);
+  }
+  buffer = builder.toBuffer();
+}
+
+function Verify() {
+  Wasm.verifyModule(buffer);
+}
+
+function VerifyTearDown() {
+  buffer = undefined;
+}
@@ -0,0 +1,98 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --regexp-exec-cache --expose-gc
+
+// Results of regexp executions on short subjects are cached. Cached results
+// must be indistinguishable from running the matcher again.
+
+(function RepeatedExec() {
+  var re = /\/users\/(\d+)(\/posts)?/;
+  for (var i = 0; i < 5; i++) {
+    var m = re.exec("/api/users/42/posts");
+    assertEquals(["/users/42/posts", "42", "/posts"], m);
+    assertEquals(4, m.index);
+    assertEquals("/api/users/42/posts", m.input);
+    assertEquals("42", RegExp.$1);
+    assertNull(re.exec("/api/groups/42"));
+    // The last match info is updated by cache hits, too.
+    assertEquals("42", RegExp.$1);
+    assertEquals(["/users/7", "7", undefined], re.exec("/users/7"));
+    assertEquals("7", RegExp.$1);
+  }
+})();
+
+(function EqualSubjects() {
+  var re = /b(c+)/;
+  for (var i = 0; i < 5; i++) {
+    // A new string object with the same contents every time.
+    var subject = ["a", "b", "cc", "d"].join("");
+    var m = re.exec(subject);
+    assertEquals(["bcc", "cc"], m);
+    assertSame(subject, m.input);
+  }
+})();
+
+(function LastIndex() {
+  var re = /o/g;
+  for (var i = 0; i < 3; i++) {
+    assertEquals(0, re.lastIndex);
+    assertEquals(1, re.exec("foo bar boo").index);
+    assertEquals(2, re.exec("foo bar boo").index);
+    assertEquals(9, re.exec("foo bar boo").index);
+    assertEquals(10, re.exec("foo bar boo").index);
+    assertNull(re.exec("foo bar boo"));
+  }
+  var sticky = /o/y;
+  for (var i = 0; i < 3; i++) {
+    sticky.lastIndex = 1;
+    assertTrue(sticky.test("foo"));
+    assertFalse(sticky.test("fox"));
+  }
+})();
+
+(function Recompile() {
+  var re = /a(b)/;
+  assertEquals(["ab", "b"], re.exec("xab"));
+  re.compile("x(a)");
+  assertEquals(["xa", "a"], re.exec("xab"));
+  re.compile("a(b)");
+  assertEquals(["ab", "b"], re.exec("xab"));
+})();
+
+(function SameSourceDifferentFlags() {
+  for (var i = 0; i < 3; i++) {
+    assertNull(/abc/.exec("ABC"));
+    assertEquals(["ABC"], /abc/i.exec("ABC"));
+  }
+})();
+
+(function ManySubjects() {
+  // More subjects than fit in the cache, which then has to start over.
+  var re = /(\d+)$/;
+  var padding = new Array(900).join("x");
+  for (var round = 0; round < 2; round++) {
+    for (var i = 0; i < 600; i++) {
+      assertEquals(String(i), re.exec(padding + i)[1]);
+    }
+    gc();
+  }
+  var long_subject = new Array(5000).join("y") + "12";
+  assertEquals("12", re.exec(long_subject)[1]);
+  assertEquals("12", re.exec(long_subject)[1]);
+})();
+
+(function SlicedSubjects() {
+  // Slices of a long string are entered as copies, so that the cache does
+  // not keep the long string alive. Results must not change.
+  var re = /(\d+)-(\d+)/;
+  var parent = new Array(2000).join("z") + "12-34" + new Array(100).join("z");
+  for (var i = 0; i < 5; i++) {
+    var slice = parent.substring(1990, 2010);
+    var m = re.exec(slice);
+    assertEquals(["12-34", "12", "34"], m);
+    assertEquals(9, m.index);
+    assertSame(slice, m.input);
+  }
+})();
@@ -0,0 +1,30 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --regexp-backtracks-before-fallback=1000
+
+// Regexps that backtrack too much switch to the linear-time NFA engine
+// instead of taking exponential time.
+
+(function Fallback() {
+  var re = /^(a+)+$/;
+  var subject = new Array(40).join("a");
+  assertEquals([subject, subject], re.exec(subject));
+  assertNull(re.exec(subject + "!"));
+  // The regexp keeps working after the switch.
+  assertEquals(["aa", "aa"], re.exec("aa"));
+  assertNull(re.exec("ab"));
+})();
+
+(function GlobalFallback() {
+  var subject = new Array(30).join("x") + "y" + new Array(30).join("x");
+  var re = /(x+x+)+y/g;
+  assertEquals(1, subject.match(re).length);
+  assertEquals("-" + new Array(30).join("x"), subject.replace(re, "-"));
+})();
+
+(function NoFallbackWithBackReferences() {
+  var re = /(a)\1/;
+  assertEquals(["aa", "a"], re.exec("baa"));
+})();
@@ -0,0 +1,77 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --regexp-linear
+
+// Regexps without back references and lookarounds are matched by the
+// linear-time NFA engine. Results must be those of the backtracking engine.
+
+(function Basics() {
+  assertEquals(["abc"], /abc/.exec("xxabcxx"));
+  assertEquals(2, /b+c/.exec("aabbbc").index);
+  assertNull(/abd/.exec("abcabc"));
+  assertEquals(["a1"], /[a-c]\d/.exec("--a1--"));
+  assertEquals(["-"], /[^\w]/.exec("ab-cd"));
+  assertEquals(["AbC"], /abc/i.exec("xAbCx"));
+  assertEquals(["\u00e5"], /\u00c5/i.exec("\u00e5"));
+})();
+
+(function Priorities() {
+  // Alternatives are tried in order, greedy quantifiers prefer more.
+  assertEquals(["a", "a"], /(a|ab)/.exec("abc"));
+  assertEquals(["ab", "ab"], /(ab|a)/.exec("abc"));
+  assertEquals(["aaa"], /a+/.exec("aaa"));
+  assertEquals(["a"], /a+?/.exec("aaa"));
+  assertEquals(["<a><b>"], /<.*>/.exec("<a><b>"));
+  assertEquals(["<a>"], /<.*?>/.exec("<a><b>"));
+  assertEquals(["aa", "a"], /(a){2}/.exec("aaa"));
+  assertEquals(["aaa"], /a{1,3}/.exec("aaaa"));
+  assertEquals(["a"], /a{1,3}?/.exec("aaaa"));
+})();
+
+(function Captures() {
+  assertEquals(["ab", "a", "b"], /(a)(b)?/.exec("ab"));
+  assertEquals(["a", "a", undefined], /(a)(b)?/.exec("ac"));
+  // Captures in a quantified body are reset on every iteration.
+  assertEquals(["ab", undefined, "b"], /(?:(a)|(b))+/.exec("ab"));
+  assertEquals(["aba", "a", undefined], /(?:(a)|(b))+/.exec("aba"));
+  assertEquals(["abcd", "cd"], /(?:(\w\w))+/.exec("abcd"));
+})();
+
+(function Assertions() {
+  assertEquals(["b"], /^b/m.exec("a\nb"));
+  assertNull(/^b/.exec("a\nb"));
+  assertEquals(["a"], /a$/m.exec("a\nb"));
+  assertEquals(["cat"], /\bcat\b/.exec("concat cat"));
+  assertEquals(12, "concatenate cat".search(/\bcat\b/));
+  assertEquals(["cat"], /\Bcat/.exec("concat"));
+})();
+
+(function GlobalAndSticky() {
+  assertEquals(["1", "22", "333"], "a1b22c333".match(/\d+/g));
+  assertEquals("a-b-c", "a1b2c".replace(/\d/g, "-"));
+  assertEquals("x<>y<>", "xy".replace(/(?:)/g, "<>").substring(2));
+  var re = /b/y;
+  assertNull(re.exec("ab"));
+  re.lastIndex = 1;
+  assertEquals(["b"], re.exec("ab"));
+  assertEquals(2, re.lastIndex);
+})();
+
+(function TwoByteSubjects() {
+  assertEquals(["\u1234b", "\u1234"], /(.)b/.exec("a\u1234b"));
+  assertEquals(["\u2028"], /[\u2000-\u20ff]/.exec("x\u2028"));
+})();
+
+(function NotLinear() {
+  // These are still matched by the backtracking engine.
+  assertEquals(["abab", "ab"], /(ab)\1/.exec("xabab"));
+  assertEquals(["a"], /a(?=b)/.exec("acab"));
+})();
+
+(function NoCatastrophicBacktracking() {
+  var subject = new Array(40).join("a") + "!";
+  assertNull(/^(a+)+$/.exec(subject));
+  assertNull(/(x+x+)+y/.exec(new Array(40).join("x")));
+})();
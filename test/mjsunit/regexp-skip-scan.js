@@ -0,0 +1,64 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --no-regexp-tier-up
+
+// Unanchored regexps scan for the characters a match must contain before
+// trying to match. Check candidates around vector boundaries and at the end
+// of the subject.
+
+function pad(n) {
+  return new Array(n + 1).join("-");
+}
+
+(function Positions() {
+  var re = /ab+c/;
+  for (var i = 0; i < 70; i++) {
+    var subject = pad(i) + "abbc" + pad(i % 17);
+    assertEquals(i, subject.search(re));
+    assertEquals(-1, (pad(i) + "abb").search(re));
+    assertEquals(-1, (pad(i) + "xbbc").search(re));
+  }
+})();
+
+(function LookaheadOffset() {
+  // The rarest character is not the first one.
+  var re = /[a-z]q/;
+  for (var i = 0; i < 40; i++) {
+    assertEquals(["xq"], re.exec(pad(i) + "xq"));
+    assertNull(re.exec(pad(i) + "q"));
+  }
+})();
+
+(function CharacterSets() {
+  var re = /foo/i;
+  for (var i = 0; i < 40; i++) {
+    assertEquals(["FoO"], re.exec(pad(i) + "FoO" + pad(i)));
+    assertNull(re.exec(pad(i) + "fo"));
+  }
+  assertEquals(["\u00e6b", "b"], /\u00e6(b|c)/.exec(pad(33) + "f\u00e6b"));
+  // Characters that are equal modulo the table size of the lookahead.
+  assertEquals(["\u00e1b"], /\u00e1b/.exec(pad(20) + "ab\u00e1b"));
+  assertNull(/\u00e1b/.exec(pad(20) + "ab"));
+})();
+
+(function TwoByteSubjects() {
+  var re = /ab+c/;
+  for (var i = 0; i < 40; i++) {
+    var subject = "\u1234" + pad(i) + "abbc";
+    assertEquals(i + 1, subject.search(re));
+    assertEquals(-1, (subject + "\u0161").search(/\u0161b/));
+  }
+  assertEquals(["\u0162b"], /\u0162b/.exec(pad(20) + "bb\u0162b"));
+})();
+
+(function GlobalReplaceAndSplit() {
+  var line = "";
+  for (var i = 0; i < 200; i++) line += "key" + i + "=value" + i + ";";
+  assertEquals(200, line.match(/=/g).length);
+  assertEquals(201, line.split(/;/).length);
+  var replaced = line.replace(/key(\d+)=/g, "$1:");
+  assertEquals("0:value0;1:value1;", replaced.substring(0, 18));
+  assertEquals(-1, replaced.indexOf("key"));
+})();
@@ -0,0 +1,52 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --regexp-tier-up --regexp-tier-up-ticks=3
+
+// Regexps are interpreted as bytecode for the first executions and compiled
+// to native code afterwards. Results must not depend on the tier in use.
+
+(function ExecAcrossTierUp() {
+  var re = /(a+)(b*)c/;
+  for (var i = 0; i < 10; i++) {
+    var m = re.exec("xxaabbbc" + i);
+    assertEquals(["aabbbc", "aa", "bbb"], m);
+    assertEquals(2, m.index);
+    assertEquals("aa", RegExp.$1);
+    assertNull(re.exec("xxbbbc"));
+  }
+})();
+
+(function GlobalAcrossTierUp() {
+  var re = /(\d)(\d)?/g;
+  for (var i = 0; i < 10; i++) {
+    assertEquals("<12><34><5>", "12345".replace(re, "<$1$2>"));
+    assertEquals(["12", "34", "5"], "12345".match(re));
+  }
+})();
+
+(function SwitchRepresentation() {
+  var re = /b(.)d/;
+  for (var i = 0; i < 10; i++) {
+    assertEquals(["bcd", "c"], re.exec("abcde"));
+    assertEquals(["bሴd", "ሴ"], re.exec("abሴde"));
+  }
+})();
+
+(function LongSubject() {
+  var re = /x(y+)z/;
+  var subject = new Array(2000).join("-") + "xyyyz";
+  assertEquals(["xyyyz", "yyy"], re.exec(subject));
+  assertEquals(["xyz", "y"], re.exec("xyz"));
+})();
+
+(function StickyAndLastIndex() {
+  var re = /o/y;
+  for (var i = 0; i < 10; i++) {
+    re.lastIndex = 1;
+    assertTrue(re.test("foo"));
+    assertEquals(2, re.lastIndex);
+    assertFalse(re.test("fox"));
+  }
+})();
@@ -0,0 +1,55 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Candidate positions are found by comparing the first and the last
+// character of the pattern for a block of positions at a time. Check
+// matches around block boundaries and at the end of the subject.
+
+function pad(n, c) {
+  return new Array(n + 1).join(c || "-");
+}
+
+(function BlockBoundaries() {
+  for (var length = 3; length < 12; length++) {
+    var pattern = "a" + pad(length - 2, "b") + "c";
+    for (var i = 0; i < 40; i++) {
+      var subject = pad(i) + pattern;
+      assertEquals(i, subject.indexOf(pattern));
+      assertEquals(i, (subject + pad(i % 5)).indexOf(pattern));
+      // Only the first and the last character match.
+      var decoy = "a" + pad(length - 2, "x") + "c";
+      assertEquals(-1, (pad(i) + decoy).indexOf(pattern));
+      assertEquals(i + length, (pad(i) + decoy + pattern).indexOf(pattern));
+    }
+  }
+})();
+
+(function TwoByte() {
+  var pattern = "\u1234-\u5678";
+  for (var i = 0; i < 30; i++) {
+    var subject = pad(i) + "\u1234+\u5678" + pad(i % 9) + pattern;
+    assertEquals(i + 3 + i % 9, subject.indexOf(pattern));
+    assertEquals(i + 3 + i % 9, subject.indexOf(pattern, 1));
+    // One-byte pattern in a two-byte subject.
+    assertEquals(i, (pad(i) + "ab\u1234").indexOf("ab"));
+    // Byte-swapped characters.
+    assertEquals(-1, (pad(i) + "\u3412-\u7856").indexOf(pattern));
+  }
+})();
+
+(function RepeatedSearches() {
+  // Long patterns use the Boyer-Moore tables, which are kept for repeated
+  // searches. Alternate between different patterns of the same length.
+  var prefix = pad(300, "ab");
+  var patterns = [prefix + "xyz", prefix + "xzz", "x" + prefix + "yz"];
+  for (var round = 0; round < 3; round++) {
+    for (var p = 0; p < patterns.length; p++) {
+      var pattern = patterns[p];
+      var subject = pad(700, "ab") + pattern + pad(10, "ab");
+      assertEquals(1400, subject.indexOf(pattern));
+      assertEquals(-1, subject.indexOf(pattern + "!"));
+      assertEquals(2, subject.split(pattern).length);
+    }
+  }
+})();
@@ -0,0 +1,103 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --expose-wasm --expose-gc --wasm-guard-pages
+
+load("test/mjsunit/wasm/wasm-constants.js");
+load("test/mjsunit/wasm/wasm-module-builder.js");
+
+var kMemSize = 65536;
+
+function genModule() {
+  var builder = new WasmModuleBuilder();
+
+  builder.addMemory(1, 1, true);
+  builder.addFunction("load", kSig_i_i)
+    .addBody([
+      kExprGetLocal, 0,
+      kExprI32LoadMem, 0, 0])
+    .exportFunc();
+  builder.addFunction("load8_offset", kSig_i_i)
+    .addBody([
+      kExprGetLocal, 0,
+      kExprI32LoadMem8U, 0, 8])
+    .exportFunc();
+  builder.addFunction("store", kSig_i_ii)
+    .addBody([
+      kExprGetLocal, 0,
+      kExprGetLocal, 1,
+      kExprI32StoreMem, 0, 0])
+    .exportFunc();
+
+  return builder.instantiate();
+}
+
+function testInBounds() {
+  var module = genModule();
+  var array = new Int32Array(module.exports.memory);
+  assertEquals(kMemSize, module.exports.memory.byteLength);
+
+  for (var i = 0; i < kMemSize; i += 4096) {
+    assertEquals(0, module.exports.load(i));
+    assertEquals(i + 1, module.exports.store(i, i + 1));
+    assertEquals(i + 1, module.exports.load(i));
+    assertEquals(i + 1, array[i >> 2]);
+  }
+  assertEquals(7, module.exports.store(kMemSize - 4, 7));
+  assertEquals(7, module.exports.load(kMemSize - 4));
+  assertEquals(7, module.exports.load8_offset(kMemSize - 12));
+}
+
+testInBounds();
+
+function testOutOfBounds() {
+  var module = genModule();
+  var load = module.exports.load;
+  var load8_offset = module.exports.load8_offset;
+  var store = module.exports.store;
+
+  assertTraps(kTrapMemOutOfBounds, function() { load(kMemSize - 3); });
+  assertTraps(kTrapMemOutOfBounds, function() { load(kMemSize); });
+  assertTraps(kTrapMemOutOfBounds, function() { load(-1); });
+  assertTraps(kTrapMemOutOfBounds, function() { load(0x80000000); });
+  assertTraps(kTrapMemOutOfBounds, function() { load8_offset(kMemSize - 8); });
+  assertTraps(kTrapMemOutOfBounds, function() { load8_offset(-1); });
+  assertTraps(kTrapMemOutOfBounds, function() { store(kMemSize, 1); });
+  assertTraps(kTrapMemOutOfBounds, function() { store(-4, 1); });
+
+  // The memory is still usable after a trap.
+  assertEquals(3, store(0, 3));
+  assertEquals(3, load(0));
+}
+
+testOutOfBounds();
+
+function testSurvivalAcrossGc() {
+  for (var i = 0; i < 50; i++) {
+    var module = genModule();
+    assertEquals(i, module.exports.store(kMemSize - 4, i));
+    assertTraps(kTrapMemOutOfBounds, function() {
+      module.exports.load(kMemSize);
+    });
+    if (i % 10 == 0) gc();
+  }
+}
+
+testSurvivalAcrossGc();
+
+function testCodeMovedByGc() {
+  // Keep one module alive while the code of others dies around it, so that
+  // compaction may move its code.
+  var module = genModule();
+  for (var i = 0; i < 20; i++) {
+    genModule();
+    gc();
+    assertTraps(kTrapMemOutOfBounds, function() {
+      module.exports.load(kMemSize);
+    });
+    assertEquals(i, module.exports.store(0, i));
+  }
+}
+
+testCodeMovedByGc();
@@ -0,0 +1,100 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --expose-wasm --expose-gc
+
+load("test/mjsunit/wasm/wasm-constants.js");
+load("test/mjsunit/wasm/wasm-module-builder.js");
+
+function genExporter() {
+  var builder = new WasmModuleBuilder();
+
+  builder.addMemory(1, 1, false);
+  builder.addFunction("sub", kSig_i_ii)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprI32Sub,                  // --
+    ])
+    .exportFunc();
+  builder.addFunction("store", kSig_i_ii)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprI32StoreMem, 0, 0,       // --
+    ])
+    .exportFunc();
+  builder.addFunction("load", kSig_i_i)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprI32LoadMem, 0, 0,        // --
+    ])
+    .exportFunc();
+
+  return builder.instantiate();
+}
+
+function genImporter(sig, ffi) {
+  var builder = new WasmModuleBuilder();
+
+  var sig_index = builder.addType(sig);
+  builder.addImport("func", sig_index);
+  builder.addFunction("main", sig_index)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprCallImport, kArity2, 0,  // --
+    ])
+    .exportFunc();
+
+  return builder.instantiate({func: ffi});
+}
+
+(function SameSignatureTest() {
+  var exporter = genExporter();
+  var importer = genImporter(kSig_i_ii, exporter.exports.sub);
+
+  for (var i = -100; i < 100; i += 7) {
+    assertEquals(i - 13, importer.exports.main(i, 13));
+  }
+})();
+
+(function ExporterMemoryTest() {
+  var exporter = genExporter();
+  var importer = genImporter(kSig_i_ii, exporter.exports.store);
+
+  // The imported function accesses the memory of the exporting instance.
+  assertEquals(77, importer.exports.main(16, 77));
+  assertEquals(77, exporter.exports.load(16));
+})();
+
+(function DifferentSignatureTest() {
+  var exporter = genExporter();
+  var importer = genImporter(kSig_d_dd, exporter.exports.sub);
+
+  // The values are converted through JavaScript.
+  assertEquals(-2, importer.exports.main(5.5, 7.5));
+})();
+
+(function ExporterSurvivesGcTest() {
+  var importer = genImporter(kSig_i_ii, genExporter().exports.store);
+  gc();
+  gc();
+  for (var i = 0; i < 10; i++) {
+    assertEquals(i, importer.exports.main(i * 4, i));
+  }
+})();
+
+(function ArgumentConversionTest() {
+  var sub = genExporter().exports.sub;
+
+  assertEquals(-1, sub(1, 2));
+  assertEquals(-1, sub(1.5, 2.25));
+  assertEquals(-1, sub(-1, 0));
+  assertEquals(3, sub("5", 2));
+  assertEquals(3, sub({valueOf: function() { return 5; }}, 2));
+  assertEquals(0, sub(undefined, NaN));
+  assertEquals(-2, sub(0x7fffffff, 0x80000001));
+  assertThrows(function() { sub(Symbol(), 1); });
+})();
@@ -47,3 +47,45 @@ assertEquals(19, module.exports.main(0, 12, 7));
 
 assertTraps(kTrapFuncSigMismatch, "module.exports.main(2, 12, 33)");
 assertTraps(kTrapFuncInvalid, "module.exports.main(3, 12, 33)");
+
+module = (function () {
+  var builder = new WasmModuleBuilder();
+
+  // Each function declares its own, structurally equal, signature.
+  builder.addFunction("mul", kSig_i_ii)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprI32Mul,                  // --
+    ]);
+  builder.addFunction("sub", kSig_i_ii)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprI32Sub,                  // --
+    ]);
+  builder.addFunction("neg", kSig_i_i)
+    .addBody([
+      kExprI8Const, 0,              // --
+      kExprGetLocal, 0,             // --
+      kExprI32Sub,                  // --
+    ]);
+  var sig_index = builder.addType(kSig_i_ii);
+  builder.addFunction("main", kSig_i_iii)
+    .addBody([
+      kExprGetLocal, 0,
+      kExprGetLocal, 1,
+      kExprGetLocal, 2,
+      kExprCallIndirect, kArity2, sig_index
+    ])
+    .exportFunc()
+  builder.appendToTable([0, 1, 2]);
+
+  return builder.instantiate();
+})();
+
+// Signatures are compared by structure, not by their index.
+assertEquals(84, module.exports.main(0, 12, 7));
+assertEquals(5, module.exports.main(1, 12, 7));
+assertTraps(kTrapFuncSigMismatch, "module.exports.main(2, 12, 7)");
+assertTraps(kTrapFuncInvalid, "module.exports.main(3, 12, 7)");
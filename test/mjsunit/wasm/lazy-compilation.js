@@ -0,0 +1,79 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --expose-wasm --expose-gc --wasm-lazy-compilation
+
+load("test/mjsunit/wasm/wasm-constants.js");
+load("test/mjsunit/wasm/wasm-module-builder.js");
+
+function genModule() {
+  var builder = new WasmModuleBuilder();
+
+  var sig_index = builder.addType(kSig_i_ii);
+  builder.addImport("add", sig_index);
+  builder.addFunction("add", sig_index)
+    .addBody([
+      kExprGetLocal, 0, kExprGetLocal, 1, kExprCallImport, kArity2, 0
+    ]);
+  builder.addFunction("sub", sig_index)
+    .addBody([
+      kExprGetLocal, 0,             // --
+      kExprGetLocal, 1,             // --
+      kExprI32Sub,                  // --
+    ])
+    .exportFunc();
+  builder.addFunction("main", kSig_i_iii)
+    .addBody([
+      kExprGetLocal, 0,
+      kExprGetLocal, 1,
+      kExprGetLocal, 2,
+      kExprCallIndirect, kArity2, sig_index
+    ])
+    .exportFunc();
+  builder.appendToTable([0, 1, 2]);
+
+  return builder.instantiate({add: function(a, b) { return a + b | 0; }});
+}
+
+(function IndirectCallTest() {
+  var module = genModule();
+
+  // Each call goes through the function table, both before and after the
+  // callee is compiled.
+  for (var i = 0; i < 3; i++) {
+    assertEquals(5, module.exports.main(1, 12, 7));
+    assertEquals(19, module.exports.main(0, 12, 7));
+  }
+  assertTraps(kTrapFuncSigMismatch, "module.exports.main(2, 12, 33)");
+  assertTraps(kTrapFuncInvalid, "module.exports.main(3, 12, 33)");
+})();
+
+(function ExportAndIndirectCallTest() {
+  var module = genModule();
+
+  // Compiled through the export first, then called through the table.
+  assertEquals(-2, module.exports.sub(5, 7));
+  assertEquals(5, module.exports.main(1, 12, 7));
+  assertEquals(-2, module.exports.sub(5, 7));
+})();
+
+(function InvalidBodyTest() {
+  var builder = new WasmModuleBuilder();
+  builder.addFunction("unused", kSig_i_v)
+    .addBody([kExprI64Const, 0]);
+  builder.addFunction("main", kSig_i_v)
+    .addBody([kExprI8Const, 1])
+    .exportFunc();
+
+  // Bodies are still validated at instantiation.
+  assertThrows(function() { builder.instantiate(); });
+})();
+
+(function SurvivalAcrossGcTest() {
+  for (var i = 0; i < 20; i++) {
+    var module = genModule();
+    assertEquals(i - 7, module.exports.main(1, i, 7));
+    if (i % 5 == 0) gc();
+  }
+})();
@@ -0,0 +1,51 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --expose-wasm
+
+load("test/mjsunit/wasm/wasm-constants.js");
+load("test/mjsunit/wasm/wasm-module-builder.js");
+
+var kNumFunctions = 300;
+
+function genModule(invalid) {
+  var builder = new WasmModuleBuilder();
+  for (var i = 0; i < kNumFunctions; i++) {
+    if (invalid.indexOf(i) >= 0) {
+      builder.addFunction("f" + i, kSig_i_i)
+        .addBody([kExprI64Const, 0]);
+    } else {
+      builder.addFunction("f" + i, kSig_i_i)
+        .addBody([kExprGetLocal, 0, kExprI8Const, i & 0x3f, kExprI32Add]);
+    }
+  }
+  return builder.toBuffer();
+}
+
+function assertVerifyFails(buffer, func_index) {
+  try {
+    Wasm.verifyModule(buffer);
+  } catch (e) {
+    assertTrue(e.message.indexOf("in function #" + func_index + ":") >= 0,
+               e.message);
+    return;
+  }
+  assertUnreachable("verification must fail");
+}
+
+(function ValidBodiesTest() {
+  Wasm.verifyModule(genModule([]));
+})();
+
+(function FirstFailureIsReportedTest() {
+  assertVerifyFails(genModule([0]), 0);
+  assertVerifyFails(genModule([kNumFunctions - 1]), kNumFunctions - 1);
+
+  // Whichever body fails first on the worker threads, the error is the one of
+  // the first failing function in the module.
+  var buffer = genModule([250, 37, 299, 38, 120]);
+  for (var i = 0; i < 20; i++) {
+    assertVerifyFails(buffer, 37);
+  }
+})();
@@ -34,6 +34,25 @@ TEST(OS, GetCurrentProcessId) {
 }
 
 
+TEST(OS, MemoryMappedFileReadOnly) {
+  const char kFileName[] = "v8-platform-unittest-mapped-file.bin";
+  char contents[] = "startup blob";
+  OS::MemoryMappedFile* file =
+      OS::MemoryMappedFile::create(kFileName, sizeof(contents), contents);
+  ASSERT_TRUE(file != nullptr);
+  delete file;
+
+  file = OS::MemoryMappedFile::open(
+      kFileName, OS::MemoryMappedFile::FileMode::kReadOnly);
+  ASSERT_TRUE(file != nullptr);
+  EXPECT_EQ(sizeof(contents), file->size());
+  // Prefetching is only a hint and does not change the contents.
+  OS::PrefetchPages(static_cast<char*>(file->memory()) + 1, file->size() - 1);
+  EXPECT_EQ(0, memcmp(contents, file->memory(), sizeof(contents)));
+  delete file;
+  EXPECT_TRUE(OS::Remove(kFileName));
+}
+
 namespace {
 
 class ThreadLocalStorageTest : public Thread, public ::testing::Test {